@@ -1,6 +1,7 @@
 // dllmain.cpp : Defines the entry point for the DLL application.
 #include "stdafx.h"
 #include "scanner/scanner_heap.h"
+#include "scanner/scanner_simd.h"
 
 BOOL APIENTRY DllMain( HMODULE hModule,
                        DWORD  ul_reason_for_call,
@@ -13,6 +14,8 @@ BOOL APIENTRY DllMain( HMODULE hModule,
         // Initialize scanner heap so we can separate out our
         // copied chunks and results from scans
         ScannerHeap::initialize();
+        // Detect the best SIMD tier once for all scanners
+        ScannerSimd::initialize();
         break;
 
     case DLL_THREAD_ATTACH:
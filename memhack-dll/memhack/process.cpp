@@ -8,11 +8,26 @@ int get_exe_base(lua_State* L) {
 	return 1;
 }
 
+// Returns the region map generation, which changes whenever the refresh
+// found a change
+int refresh_heap_regions(lua_State* L) {
+	lua_pushinteger(L, (lua_Integer)SafeMemory::refresh_regions());
+	return 1;
+}
+
+int get_region_generation(lua_State* L) {
+	lua_pushinteger(L, (lua_Integer)SafeMemory::get_region_generation());
+	return 1;
+}
+
+// Args are (write, refresh). refresh defaults to true, pass false to read the
+// cached map as of the last refresh
 int get_heap_regions(lua_State* L) {
 	bool write = lua_toboolean(L, 1);
+	bool refresh = lua_isnoneornil(L, 2) || lua_toboolean(L, 2);
 
 	// Get the cached process heap regions from the validator
-	const std::vector<SafeMemory::Region>& regions = SafeMemory::get_heap_regions(write);
+	const std::vector<SafeMemory::Region>& regions = SafeMemory::get_heap_regions(write, refresh);
 
 	// Create a table to hold heap information
 	lua_newtable(L);
@@ -58,4 +73,12 @@ void add_process_functions(lua_State* L) {
 	lua_pushstring(L, "getHeapRegions");
 	lua_pushcfunction(L, get_heap_regions);
 	lua_rawset(L, -3);
+
+	lua_pushstring(L, "refreshHeapRegions");
+	lua_pushcfunction(L, refresh_heap_regions);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "getRegionGeneration");
+	lua_pushcfunction(L, get_region_generation);
+	lua_rawset(L, -3);
 }
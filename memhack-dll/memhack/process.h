@@ -9,6 +9,9 @@ int get_exe_base(lua_State* L);
 // Refresh cached heap regions
 int refresh_heap_regions(lua_State* L);
 
+// Get the generation of the cached region map
+int get_region_generation(lua_State* L);
+
 // Get list of heap regions
 int get_heap_regions(lua_State* L);
 
@@ -3,21 +3,54 @@
 #include <cstring>
 #include <iostream>
 
-namespace SafeMemory {
-    bool is_mbi_safe(MEMORY_BASIC_INFORMATION& mbi, bool write) {
+namespace {
+    bool is_safe(DWORD state, DWORD protect, DWORD type, bool write) {
         // Early exit on most common failure cases
-        if (mbi.State != MEM_COMMIT) return false;
-        if (write && mbi.Type != MEM_PRIVATE) return false;
-        if (mbi.Protect & (PAGE_GUARD | PAGE_NOACCESS)) return false;
+        if (state != MEM_COMMIT) return false;
+        if (write && type != MEM_PRIVATE) return false;
+        if (protect & (PAGE_GUARD | PAGE_NOACCESS)) return false;
 
         // Check access permissions (write or read-only)
         if (write) {
-            return (mbi.Protect & PAGE_READWRITE) != 0;
+            return (protect & PAGE_READWRITE) != 0;
         } else {
-            return (mbi.Protect & (PAGE_READWRITE | PAGE_READONLY | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE)) != 0;
+            return (protect & (PAGE_READWRITE | PAGE_READONLY | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE)) != 0;
         }
     }
 
+    SafeMemory::RegionInfo to_region_info(const MEMORY_BASIC_INFORMATION& mbi) {
+        SafeMemory::RegionInfo region;
+        region.base = (uintptr_t)mbi.BaseAddress;
+        region.size = (size_t)mbi.RegionSize;
+        region.allocationBase = (uintptr_t)mbi.AllocationBase;
+        region.state = mbi.State;
+        region.protect = mbi.Protect;
+        region.type = mbi.Type;
+        return region;
+    }
+
+    bool same_region(const SafeMemory::RegionInfo& a, const SafeMemory::RegionInfo& b) {
+        return a.base == b.base && a.size == b.size && a.allocationBase == b.allocationBase &&
+               a.state == b.state && a.protect == b.protect && a.type == b.type;
+    }
+
+    // Whole address space in order, including free and reserved ranges so a
+    // refresh can tell which parts changed
+    SafeMemory::RegionList g_regions;
+    uint32_t g_generation = 0;
+    bool g_regionsBuilt = false;
+    SRWLOCK g_regionsLock = SRWLOCK_INIT;
+}
+
+namespace SafeMemory {
+    bool is_mbi_safe(MEMORY_BASIC_INFORMATION& mbi, bool write) {
+        return is_safe(mbi.State, mbi.Protect, mbi.Type, write);
+    }
+
+    bool is_region_safe(const RegionInfo& region, bool write) {
+        return is_safe(region.state, region.protect, region.type, write);
+    }
+
     bool is_access_allowed(void* addr, size_t size, bool write) {
         MEMORY_BASIC_INFORMATION mbi;
         if (VirtualQuery(addr, &mbi, sizeof(mbi)) != sizeof(mbi)) {
@@ -59,8 +92,9 @@ namespace SafeMemory {
         return (requested_size < available) ? requested_size : available;
     }
 
-    std::vector<Region> get_heap_regions(bool write) {
-        std::vector<Region> out;
+    uint32_t refresh_regions() {
+        AcquireSRWLockExclusive(&g_regionsLock);
+
         SYSTEM_INFO si;
         GetSystemInfo(&si);
 
@@ -68,19 +102,80 @@ namespace SafeMemory {
         uintptr_t addr = (uintptr_t)si.lpMinimumApplicationAddress;
         uintptr_t end = (uintptr_t)si.lpMaximumApplicationAddress;
 
+        // Every region is queried again since protections change inside
+        // images too (copy on write pages, VirtualProtect). The cached map
+        // only decides whether the generation moves
+        const RegionList& cached = g_regions;
+        RegionList fresh;
+        fresh.reserve(cached.size() + 64);
+        bool changed = !g_regionsBuilt;
+
         while (addr < end) {
             MEMORY_BASIC_INFORMATION mbi{};
             SIZE_T r = VirtualQuery((LPCVOID)addr, &mbi, sizeof(mbi));
             if (r != sizeof(mbi)) break;
+            RegionInfo region = to_region_info(mbi);
+
+            size_t index = fresh.size();
+            if (index >= cached.size() || !same_region(cached[index], region)) {
+                changed = true;
+            }
 
-            if (is_mbi_safe(mbi, write)) {
+            fresh.push_back(region);
+            addr = region.base + region.size;
+        }
+
+        if (fresh.size() != cached.size()) {
+            changed = true;
+        }
+        if (changed) {
+            g_regions.swap(fresh);
+            g_generation++;
+        }
+        g_regionsBuilt = true;
+
+        uint32_t generation = g_generation;
+        ReleaseSRWLockExclusive(&g_regionsLock);
+        return generation;
+    }
+
+    uint32_t get_region_generation() {
+        AcquireSRWLockShared(&g_regionsLock);
+        uint32_t generation = g_generation;
+        ReleaseSRWLockShared(&g_regionsLock);
+        return generation;
+    }
+
+    uint32_t get_regions(RegionList& out, bool refresh) {
+        if (refresh || !g_regionsBuilt) {
+            refresh_regions();
+        }
+
+        AcquireSRWLockShared(&g_regionsLock);
+        out.clear();
+        for (const RegionInfo& region : g_regions) {
+            if (region.state == MEM_COMMIT) {
+                out.push_back(region);
+            }
+        }
+        uint32_t generation = g_generation;
+        ReleaseSRWLockShared(&g_regionsLock);
+        return generation;
+    }
+
+    std::vector<Region> get_heap_regions(bool write, bool refresh) {
+        RegionList regions;
+        get_regions(regions, refresh);
+
+        std::vector<Region> out;
+        for (const RegionInfo& region : regions) {
+            if (is_region_safe(region, write)) {
                 out.push_back({
-                    (uintptr_t)mbi.BaseAddress,
-                    (size_t)mbi.RegionSize,
+                    region.base,
+                    region.size,
                     });
             }
-            addr = (uintptr_t)mbi.BaseAddress + (uintptr_t)mbi.RegionSize;
         }
         return out;
     }
-}
\ No newline at end of file
+}
@@ -3,10 +3,26 @@
 
 #include <windows.h>
 #include <cstddef>
+#include <cstdint>
+#include "scanner/scanner_heap.h"
 namespace SafeMemory {
     struct Region { uintptr_t base; size_t size; };
 
+    // Entry of the cached region map. Same fields as MEMORY_BASIC_INFORMATION
+    struct RegionInfo {
+        uintptr_t base;
+        size_t size;
+        uintptr_t allocationBase;
+        DWORD state;
+        DWORD protect;
+        DWORD type;
+    };
+
+    // Allocated on the scanner heap so scans don't find the map itself
+    typedef std::vector<RegionInfo, ScannerAllocator<RegionInfo>> RegionList;
+
     bool is_mbi_safe(MEMORY_BASIC_INFORMATION& mbi, bool write = true);
+    bool is_region_safe(const RegionInfo& region, bool write = true);
 
     bool is_access_allowed(void* addr, size_t size, bool write = true);
 
@@ -14,7 +30,17 @@ namespace SafeMemory {
     // Returns 0 if addr is not accessible
     size_t get_accessible_size(void* addr, size_t requested_size, bool write = true);
 
-    std::vector<Region> get_heap_regions(bool write = true);
+    // Shared map of the process regions used by the scanners and Lua
+    // A refresh queries every region again. The generation changes whenever
+    // a refresh changed the map, so readers can skip work when it didn't
+    uint32_t refresh_regions();
+    uint32_t get_region_generation();
+
+    // Copy the committed regions of the map, refreshing it first unless
+    // refresh is false. Returns the generation of the copy
+    uint32_t get_regions(RegionList& out, bool refresh = true);
+
+    std::vector<Region> get_heap_regions(bool write = true, bool refresh = true);
 }
 
 #endif
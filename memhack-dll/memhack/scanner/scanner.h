@@ -7,12 +7,19 @@
 #include "scanner_base.h"
 #include "scanner_basic.h"
 #include "scanner_sequence.h"
+#include "scanner_multi_sequence.h"
 #include "scanner_struct.h"
+#include "scanner_pointer.h"
+#include "scanner_vtable.h"
 
 // Scanners are type-specific. You must create the appropriate scanner directly
 //   BasicScanner* scanner = BasicScanner::create(BasicScanner::DataType::INT, 10000, 4);
 //   SequenceScanner* scanner = SequenceScanner::create(SequenceScanner::DataType::STRING, 10000, 1);
+//   SequenceScanner* scanner = SequenceScanner::create(SequenceScanner::DataType::PATTERN, 10000, 1);
+//   MultiSequenceScanner* scanner = MultiSequenceScanner::create(SequenceScanner::DataType::STRING, 10000, 1);
 //   StructScanner* scanner = StructScanner::create(10000, 1);
+//   PointerScanner* scanner = PointerScanner::create(10000000, 4);
+//   VtableScanner* scanner = VtableScanner::create(10000000, 4);
 //
 // Lua bindings handle creation of any type with a single interface. Currently this is not
 // supported on the C side
@@ -0,0 +1,96 @@
+#include "stdafx.h"
+#include "scanner_async.h"
+#include "scanner_base.h"
+
+#include <exception>
+#include <omp.h>
+
+
+void* AsyncScanJob::operator new(size_t size) {
+	return ScannerHeap::allocate(size);
+}
+
+void AsyncScanJob::operator delete(void* ptr) noexcept {
+	if (ptr) {
+		ScannerHeap::deallocate(ptr, 0);
+	}
+}
+
+bool Scanner::startAsync(AsyncScanJob* job) {
+	if (asyncJob != nullptr) {
+		delete job;
+		addError("A background scan is already running");
+		return false;
+	}
+
+	asyncJob = job;
+	asyncDone = false;
+	cancelRequested = false;
+	resetProgress(0, true);
+
+	// The thread count set by setNumThreads belongs to the calling thread
+	// and new threads start from the default, so it is passed on
+	int threadCount = omp_get_max_threads();
+	try {
+		asyncThread = std::thread([this, threadCount]() {
+			omp_set_num_threads(threadCount);
+			try {
+				asyncJob->run(this);
+			} catch (const std::exception& e) {
+				addError("Background scan failed: %s", e.what());
+			}
+			asyncDone = true;
+		});
+	} catch (const std::exception& e) {
+		delete asyncJob;
+		asyncJob = nullptr;
+		addError("Failed to start background scan: %s", e.what());
+		return false;
+	}
+	return true;
+}
+
+void Scanner::finishAsync() {
+	if (asyncJob == nullptr) {
+		return;
+	}
+
+	asyncThread.join();
+	delete asyncJob;
+	asyncJob = nullptr;
+	asyncDone = false;
+	cancelRequested = false;
+}
+
+void Scanner::cancel() {
+	// Stepped scans run on the caller's thread so they can stop right here
+	if (stepActive) {
+		reset();
+		scanCancelled = true;
+		addError("First scan cancelled");
+		return;
+	}
+
+	// Only a background scan can be interrupted. Requests while idle are
+	// dropped so they don't cancel the next scan
+	if (asyncJob != nullptr) {
+		cancelRequested = true;
+	}
+}
+
+ScanProgress Scanner::getProgress() const {
+	ScanProgress progress;
+	progress.done = progressDone.load(std::memory_order_relaxed);
+	progress.total = progressTotal.load(std::memory_order_relaxed);
+	progress.countsBytes = progressBytes.load(std::memory_order_relaxed);
+	progress.results = progressResults.load(std::memory_order_relaxed);
+	progress.cancelled = isCancelled();
+	return progress;
+}
+
+void Scanner::resetProgress(uint64_t total, bool countsBytes) {
+	progressDone.store(0, std::memory_order_relaxed);
+	progressTotal.store(total, std::memory_order_relaxed);
+	progressBytes.store(countsBytes, std::memory_order_relaxed);
+	progressResults.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,23 @@
+#ifndef SCANNER_ASYNC_H
+#define SCANNER_ASYNC_H
+
+#include "scanner_heap.h"
+
+class Scanner;
+
+// Work for a background scan started with Scanner::startAsync. The caller
+// returns before the scan runs so jobs own copies of everything the scan
+// reads (targets, patterns). They are allocated from the scanner heap like
+// the scanner so those copies aren't found by the scan itself
+class AsyncScanJob {
+public:
+	virtual ~AsyncScanJob() {}
+
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr) noexcept;
+
+	// Runs on the worker thread. Errors are logged to the scanner as usual
+	virtual void run(Scanner* scanner) = 0;
+};
+
+#endif
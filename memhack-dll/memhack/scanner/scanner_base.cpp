@@ -1,6 +1,8 @@
 #include "stdafx.h"
 #include "scanner_base.h"
-#include "scanner_basic_avx2.h"
+#include "scanner_async.h"
+#include "scanner_work_queue.h"
+#include "scanner_result_sink.h"
 #include "../safememory.h"
 
 #include <algorithm>
@@ -42,16 +44,26 @@ int Scanner::getMaxThreads() {
 // Base constructor - common initialization for all scanners
 Scanner::Scanner(size_t maxResults, size_t alignment) :
 	maxResults(maxResults), alignment(alignment), firstScanDone(false),
-	maxResultsReached(false), checkTiming(false), lastScanType(ScanType::EXACT), invalidAddressCount(0)
+	maxResultsReached(false), resultsSorted(true), checkTiming(false), inPlaceScan(true), lastScanType(ScanType::EXACT), regionGeneration(0),
+	asyncJob(nullptr), asyncDone(false), cancelRequested(false), scanCancelled(false),
+	progressDone(0), progressTotal(0), progressBytes(true), progressResults(0),
+	stepActive(false), stepScanType(ScanType::EXACT), stepTarget(nullptr), stepTargetOwner(nullptr),
+	stepRegion(0), stepOffset(0), stepStartTime(0), invalidAddressCount(0)
 {
+	InitializeSRWLock(&errorsLock);
+
 	// Always allow at least one result
 	if (maxResults == 0) {
 		addError("maxResults cannot be 0, defaulting to 1");
 		this->maxResults = 1;
 	}
+}
 
-	// Pre-allocate a reasonable amount
-	results.reserve(std::min<size_t>(this->maxResults, 10000));
+Scanner::~Scanner() {
+	// Derived state is already gone here, this only avoids leaving the
+	// thread running
+	finishAsync();
+	endStepScan();
 }
 
 // Template method for first scan - handles common setup and timing
@@ -61,47 +73,71 @@ void Scanner::firstScan(ScanType scanType, const void* targetValue, size_t value
 	if (checkTiming) {
 		startTime = GetTickCount64();
 	}
+	scanCancelled = false;
 
-	// Common validation
-	if (firstScanDone) {
-		addError("First scan already performed - use reset() first or create new scanner");
-		return;
-	}
+	// A normal first scan replaces an unfinished stepped one
+	endStepScan();
 
-	// These types require a previous scan
-	if (scanType == ScanType::INCREASED || scanType == ScanType::DECREASED ||
-	    scanType == ScanType::CHANGED || scanType == ScanType::UNCHANGED) {
-		addError("First scan cannot use INCREASED/DECREASED/CHANGED/UNCHANGED - these require a previous scan. Use EXACT or NOT for first scan.");
+	if (!prepareFirstScan(scanType, targetValue, valueSize)) {
 		return;
 	}
 
-	// Clear results and prepare for scan
-	results.clear();
-	maxResultsReached = false;
-	clearErrors();
-	invalidAddressCount = 0;
-	lastScanType = scanType;
-
-	// Call scanner-specific setup (e.g., store search sequence for strings)
-	if (!setupScanCommon(scanType, targetValue, valueSize)) {
-		return;  // Setup failed, error already logged by derived class
-	}
-
 	// Call scanner-specific implementation
 	firstScanImpl(scanType, targetValue, valueSize);
 
+	// Partial results of a cancelled scan are dropped
+	if (scanCancelled) {
+		reset();
+		addError("First scan cancelled");
+		return;
+	}
+
 	// Mark as done
 	firstScanDone = true;
+	progressResults = getResultCount();
 	reportInvalidAddressStats();
 
 	// Report timing if enabled
 	if (checkTiming) {
 		ULONGLONG endTime = GetTickCount64();
 		ULONGLONG elapsed = endTime - startTime;
-		addError("firstScan timing: %llu ms (%zu results found)", elapsed, results.size());
+		addError("firstScan timing: %llu ms (%zu results found)", elapsed, getResultCount());
 	}
 }
 
+bool Scanner::prepareFirstScan(ScanType scanType, const void* targetValue, size_t valueSize) {
+	// Common validation
+	if (firstScanDone) {
+		addError("First scan already performed - use reset() first or create new scanner");
+		return false;
+	}
+
+	// These types require a previous scan
+	if (scanType == ScanType::INCREASED || scanType == ScanType::DECREASED ||
+	    scanType == ScanType::CHANGED || scanType == ScanType::UNCHANGED) {
+		addError("First scan cannot use INCREASED/DECREASED/CHANGED/UNCHANGED - these require a previous scan. Use EXACT, NOT or UNKNOWN for first scan.");
+		return false;
+	}
+
+	if (scanType == ScanType::UNKNOWN && !supportsUnknownScan()) {
+		addError("UNKNOWN first scans are only supported by basic scanners");
+		return false;
+	}
+
+	// Clear results and prepare for scan. Values are sized to the type
+	results = ResultStore(getStoredValueSize(), false);
+	maxResultsReached = false;
+	resultsSorted = false;
+	clearErrors();
+	invalidAddressCount = 0;
+	lastScanType = scanType;
+	resetProgress(0, true);
+
+	// Call scanner-specific setup (e.g., store search sequence for strings)
+	// Setup errors are logged by the derived class
+	return setupScanCommon(scanType, targetValue, valueSize);
+}
+
 // Base method for rescan - handles common setup and timing
 void Scanner::rescan(ScanType scanType, const void* targetValue, size_t valueSize) {
 	// Start timing if enabled
@@ -109,6 +145,7 @@ void Scanner::rescan(ScanType scanType, const void* targetValue, size_t valueSiz
 	if (checkTiming) {
 		startTime = GetTickCount64();
 	}
+	scanCancelled = false;
 
 	// Common validation
 	if (!firstScanDone) {
@@ -116,29 +153,45 @@ void Scanner::rescan(ScanType scanType, const void* targetValue, size_t valueSiz
 		return;
 	}
 
-	if (results.empty()) {
+	if (getResultCount() == 0) {
 		addError("No previous results to rescan");
 		return;
 	}
 
+	if (scanType == ScanType::UNKNOWN) {
+		addError("UNKNOWN is only valid for first scans");
+		return;
+	}
+
 	// Prepare for rescan
+	ScanType previousScanType = lastScanType;
 	clearErrors();
 	invalidAddressCount = 0;
 	lastScanType = scanType;
+	resetProgress(getResultCount(), false);
 
 	// Call scanner-specific setup (e.g., update search sequence for strings)
 	if (!setupScanCommon(scanType, targetValue, valueSize)) {
 		return;  // Setup failed, error already logged by derived class
 	}
 
-	// Sort results by address for efficient processing
-	std::stable_sort(results.begin(), results.end(), [](const ScanResult& a, const ScanResult& b) {
-		return a.address < b.address;
-	});
+	// Rescans walk results by address. They are normally already in order
+	// so this only runs if a derived scanner produced them out of order
+	if (!resultsSorted) {
+		results.sortByAddress();
+		resultsSorted = true;
+	}
 
 	// Call scanner-specific implementation
 	rescanImpl(scanType, targetValue, valueSize);
 
+	if (scanCancelled) {
+		lastScanType = previousScanType;
+		addError("Rescan cancelled, previous results kept");
+		return;
+	}
+	progressResults = getResultCount();
+
 	// Report stats
 	reportInvalidAddressStats();
 
@@ -146,34 +199,145 @@ void Scanner::rescan(ScanType scanType, const void* targetValue, size_t valueSiz
 	if (checkTiming) {
 		ULONGLONG endTime = GetTickCount64();
 		ULONGLONG elapsed = endTime - startTime;
-		addError("rescan timing: %llu ms (%zu results remaining)", elapsed, results.size());
+		addError("rescan timing: %llu ms (%zu results remaining)", elapsed, getResultCount());
+	}
+}
+
+// Ranges are sorted and merged so overlapping ranges don't scan memory twice
+void Scanner::setScanRanges(const std::vector<MemoryRegion, ScannerAllocator<MemoryRegion>>& ranges) {
+	scanRanges.clear();
+	for (const MemoryRegion& range : ranges) {
+		if (range.size > 0) {
+			scanRanges.push_back(range);
+		}
+	}
+
+	std::sort(scanRanges.begin(), scanRanges.end(),
+	          [](const MemoryRegion& a, const MemoryRegion& b) { return a.base < b.base; });
+
+	size_t merged = 0;
+	for (size_t i = 1; i < scanRanges.size(); i++) {
+		MemoryRegion& last = scanRanges[merged];
+		const MemoryRegion& next = scanRanges[i];
+		if (next.base <= last.base + last.size) {
+			last.size = std::max<uintptr_t>(last.base + last.size, next.base + next.size) - last.base;
+		} else {
+			scanRanges[++merged] = next;
+		}
+	}
+	if (!scanRanges.empty()) {
+		scanRanges.resize(merged + 1);
+	}
+}
+
+// Add the parts of a safe region that fall inside scanRanges
+// Whole region when no ranges are set. Returns the bytes added
+size_t Scanner::addClippedRegion(std::vector<MemoryRegion>& regions, uintptr_t base, size_t size) const {
+	if (scanRanges.empty()) {
+		regions.emplace_back(base, size);
+		return size;
+	}
+
+	size_t added = 0;
+	uintptr_t end = base + size;
+	for (const MemoryRegion& range : scanRanges) {
+		uintptr_t clipStart = std::max<uintptr_t>(base, range.base);
+		uintptr_t clipEnd = std::min<uintptr_t>(end, range.base + range.size);
+		if (clipStart < clipEnd) {
+			regions.emplace_back(clipStart, clipEnd - clipStart);
+			added += clipEnd - clipStart;
+		}
 	}
+	return added;
+}
+
+bool Scanner::filterRegion(const SafeMemory::RegionInfo& info, const std::vector<HMODULE>& includedModules,
+                           const std::vector<HMODULE>& excludedModules, MemoryRegion& region) {
+	uint32_t type = info.type == MEM_IMAGE ? RegionFilter::TYPE_IMAGE :
+	                info.type == MEM_MAPPED ? RegionFilter::TYPE_MAPPED : RegionFilter::TYPE_PRIVATE;
+	if ((regionFilter.memoryTypes & type) == 0) {
+		regionFilterStats.typeBytes += region.size;
+		return false;
+	}
+
+	uint32_t protect = 0;
+	if (info.protect & (PAGE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY)) {
+		protect |= RegionFilter::PROTECT_WRITABLE;
+	}
+	if (info.protect & (PAGE_EXECUTE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY)) {
+		protect |= RegionFilter::PROTECT_EXECUTABLE;
+	}
+	if ((protect & regionFilter.requireProtect) != regionFilter.requireProtect || (protect & regionFilter.excludeProtect) != 0) {
+		regionFilterStats.protectionBytes += region.size;
+		return false;
+	}
+
+	// Every region of a loaded module shares the module handle as its allocation base
+	HMODULE owner = info.type == MEM_IMAGE ? (HMODULE)info.allocationBase : nullptr;
+	bool included = regionFilter.modules.empty() ||
+	                std::find(includedModules.begin(), includedModules.end(), owner) != includedModules.end();
+	bool excluded = owner != nullptr &&
+	                std::find(excludedModules.begin(), excludedModules.end(), owner) != excludedModules.end();
+	if (!included || excluded) {
+		regionFilterStats.moduleBytes += region.size;
+		return false;
+	}
+
+	uintptr_t start = std::max<uintptr_t>(region.base, regionFilter.minAddress);
+	uintptr_t end = std::min<uintptr_t>(region.base + region.size, regionFilter.maxAddress);
+	if (start >= end) {
+		regionFilterStats.addressBytes += region.size;
+		return false;
+	}
+	regionFilterStats.addressBytes += region.size - (end - start);
+	region = MemoryRegion(start, end - start);
+	return true;
 }
 
 // Enumerate all safe memory regions for parallel scanning
-std::vector<MemoryRegion> Scanner::enumerateSafeRegions() {
+std::vector<MemoryRegion> Scanner::enumerateSafeRegions(bool applyFilters) {
 	std::vector<MemoryRegion> regions;
 
-	SYSTEM_INFO si;
-	GetSystemInfo(&si);
-
-	uintptr_t addr = (uintptr_t)si.lpMinimumApplicationAddress;
-	uintptr_t end = (uintptr_t)si.lpMaximumApplicationAddress;
+	// Resolve module names once. Modules that aren't loaded match nothing
+	std::vector<HMODULE> includedModules;
+	std::vector<HMODULE> excludedModules;
+	if (applyFilters) {
+		regionFilterStats = RegionFilterStats();
+		for (const std::string& name : regionFilter.modules) {
+			HMODULE module = GetModuleHandleA(name.c_str());
+			if (module != nullptr) {
+				includedModules.push_back(module);
+			} else {
+				addError("Module not loaded, no regions will match it: %s", name.c_str());
+			}
+		}
+		for (const std::string& name : regionFilter.excludeModules) {
+			HMODULE module = GetModuleHandleA(name.c_str());
+			if (module != nullptr) {
+				excludedModules.push_back(module);
+			}
+		}
+	}
 
-	while (addr < end) {
-		MEMORY_BASIC_INFORMATION mbi{};
-		SIZE_T r = VirtualQuery((LPCVOID)addr, &mbi, sizeof(mbi));
-		if (r != sizeof(mbi)) break;
+	// Refresh the shared region map and scan from a copy of it
+	SafeMemory::RegionList regionMap;
+	regionGeneration = SafeMemory::get_regions(regionMap);
 
+	for (const SafeMemory::RegionInfo& info : regionMap) {
 		// Skip scanner heap to avoid detecting scanner's own memory
-		if (!ScannerHeap::isInScannerHeap(mbi.AllocationBase)) {
+		if (!ScannerHeap::isInScannerHeap((void*)info.allocationBase)) {
 			// Check if region is safe for reading
-			if (SafeMemory::is_mbi_safe(mbi, false)) {
-				regions.emplace_back((uintptr_t)mbi.BaseAddress, (size_t)mbi.RegionSize);
+			if (SafeMemory::is_region_safe(info, false)) {
+				MemoryRegion region(info.base, info.size);
+				if (!applyFilters) {
+					regions.push_back(region);
+				} else if (filterRegion(info, includedModules, excludedModules, region)) {
+					size_t added = addClippedRegion(regions, region.base, region.size);
+					regionFilterStats.scannedBytes += added;
+					regionFilterStats.rangeBytes += region.size - added;
+				}
 			}
 		}
-
-		addr = (uintptr_t)mbi.BaseAddress + (uintptr_t)mbi.RegionSize;
 	}
 
 	return regions;
@@ -194,56 +358,71 @@ void Scanner::firstScanImpl(ScanType scanType, const void* targetValue, size_t v
 		return;
 	}
 
+	// Split regions so a single huge region is shared between threads
+	const size_t dataSize = getDataTypeSize();
+	std::vector<WorkUnit, ScannerAllocator<WorkUnit>> units;
+	splitWorkUnits(regions, dataSize > 1 ? dataSize - 1 : 0, units);
+	if (units.size() > UINT32_MAX) {
+		addError("Too many work units (%zu) for the scan", units.size());
+		return;
+	}
+
+	uint64_t totalBytes = 0;
+	for (const WorkUnit& unit : units) {
+		totalBytes += unit.size;
+	}
+	resetProgress(totalBytes, true);
+
+	// Threads reserve result slots from a shared sink so maxResults is exact
+	// and every thread stops as soon as it fills. Results are tagged with
+	// their unit and drained in unit (address) order whichever thread
+	// scanned them. If the limit is hit, which units were scanned still
+	// depends on timing
+	int threadCount = omp_get_max_threads();
+	WorkStealingQueue queue(units.size(), threadCount);
+	ResultSink sink(maxResults, threadCount);
+
 	// Parallel scan using OpenMP
-	#pragma omp parallel
+	#pragma omp parallel num_threads(threadCount)
 	{
+		int thread = omp_get_thread_num();
+
 		// Thread-local allocations (NOT on scanner heap - avoids contention)
+		// Results only stay here for one chunk before moving to the sink
 		std::vector<uint8_t> localBuffer(SCAN_BUFFER_SIZE);
 		std::vector<ScanResult> localResults;
-		localResults.reserve(10000);
-
-		// Process regions in parallel
-		#pragma omp for schedule(dynamic, 1) nowait
-		for (int i = 0; i < (int)regions.size(); i++) {
-			// Check if max results already reached (reading bool is atomic on x86/x64)
-			if (maxResultsReached) {
-				continue;
-			}
 
-			const MemoryRegion& region = regions[i];
-			size_t maxLocal = maxResults; // Each thread can collect up to max
-
-			// Scan region into thread-local results
-			scanRegion(region.base, region.size, scanType, targetValue,
-			          localBuffer, localResults, maxLocal);
+		uint32_t unitIdx;
+		while (!sink.isFull() && !isCancelled() && queue.next(thread, unitIdx)) {
+			const WorkUnit& unit = units[unitIdx];
+			scanRegion(unit.base, unit.size, unit.leadingOverlap, scanType, targetValue,
+			           localBuffer, localResults, sink, thread, unitIdx);
 		}
+	}
 
-		// Merge local results into shared results (with strict limit enforcement)
-		if (!localResults.empty()) {
-			#pragma omp critical
-			{
-				// Double-check we haven't already reached limit (another thread might have filled it)
-				if (results.size() < maxResults) {
-					size_t remainingSpace = maxResults - results.size();
-					size_t toAdd = std::min<size_t>(remainingSpace, localResults.size());
-					results.insert(results.end(), localResults.begin(), localResults.begin() + toAdd);
-
-					if (results.size() >= maxResults) {
-						maxResultsReached = true;
-					}
-				}
-			}
-		}
+	if (isCancelled()) {
+		scanCancelled = true;
+		return;
 	}
 
+	sink.drain(results);
+	maxResultsReached = sink.isFull();
+
+	// Units are in address order and chunks within a unit are scanned in
+	// order, so the results are sorted as long as each chunk's are
+	resultsSorted = true;
+
 	if (maxResultsReached) {
 		addError("Maximum results (%zu) reached, stopping scan early", maxResults);
 	}
 }
 
-// Scan a single region in buffered chunks into local results
-void Scanner::scanRegion(uintptr_t base, size_t size, ScanType scanType, const void* targetValue,
-                          std::vector<uint8_t>& buffer, std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+// Scan a single region in buffered chunks into the sink
+// Each chunk's results are staged in localResults and kept only as far as
+// the sink grants slots, so the sink never holds more than maxResults
+void Scanner::scanRegion(uintptr_t base, size_t size, size_t leadingOverlap, ScanType scanType, const void* targetValue,
+                          std::vector<uint8_t>& buffer, std::vector<ScanResult>& localResults,
+                          ResultSink& sink, int thread, uint32_t unit) {
 	if (size == 0 || alignment == 0) {
 		return;
 	}
@@ -252,51 +431,221 @@ void Scanner::scanRegion(uintptr_t base, size_t size, ScanType scanType, const v
 	uintptr_t regionEnd = base + size;
 	uintptr_t currentBase = base;
 
-	// Scan region in buffered chunks with overlap
-	while (currentBase < regionEnd && localResults.size() < maxLocalResults) {
+	// Scan region in chunks with overlap
+	while (currentBase < regionEnd && !sink.isFull() && !isCancelled()) {
 		size_t chunkSize = std::min<size_t>(SCAN_BUFFER_SIZE, regionEnd - currentBase);
 
-		// Copy chunk with SEH protection
-		if (!safeCopyMemory(buffer.data(), (const void*)currentBase, chunkSize)) {
-			currentBase += chunkSize;
-			continue;
-		}
-
 		// Scan chunk into local results
-		size_t remainingSpace = maxLocalResults - localResults.size();
-		scanChunkInRegion(buffer.data(), chunkSize, currentBase, scanType, targetValue,
-		                  localResults, remainingSpace);
+		localResults.clear();
+		scanChunk(currentBase, chunkSize, leadingOverlap, scanType, targetValue, buffer.data(), localResults,
+		          sink.getRemaining());
+
+		size_t granted = sink.reserve(localResults.size());
+		sink.append(thread, unit, localResults.data(), granted);
 
 		// Move to next chunk with overlap
-		currentBase += chunkSize;
-		if (dataSize > 1 && currentBase < regionEnd) {
-			size_t overlap = std::min<size_t>(dataSize - 1, chunkSize);
-			currentBase -= overlap;
+		uintptr_t nextBase = currentBase + chunkSize;
+		leadingOverlap = 0;
+		if (dataSize > 1 && nextBase < regionEnd) {
+			leadingOverlap = std::min<size_t>(dataSize - 1, chunkSize);
+			nextBase -= leadingOverlap;
 		}
+		addProgress(nextBase - currentBase, granted);
+		currentBase = nextBase;
 	}
 }
 
-// Default rescan implementation - handles common JIT region processing loop
+void Scanner::scanChunk(uintptr_t chunkBase, size_t chunkSize, size_t leadingOverlap, ScanType scanType,
+                        const void* targetValue, uint8_t* buffer, std::vector<ScanResult>& localResults,
+                        size_t maxLocalResults) {
+	if (inPlaceScan) {
+		// Results found before a fault are found again from the copies
+		if (!scanChunkInPlace(chunkBase, chunkSize, leadingOverlap, scanType, targetValue, localResults, maxLocalResults)) {
+			localResults.clear();
+			scanChunkByPage(chunkBase, chunkSize, leadingOverlap, scanType, targetValue, buffer, localResults,
+			                maxLocalResults);
+		}
+		return;
+	}
+
+	// Copy chunk with SEH protection
+	if (safeCopyMemory(buffer, (const void*)chunkBase, chunkSize)) {
+		scanChunkAfterOverlap(buffer, chunkSize, chunkBase, leadingOverlap, scanType, targetValue,
+		                      localResults, maxLocalResults);
+	}
+}
+
+// Kernels only read inside the chunk and keep no state that needs unwinding,
+// so a fault can be caught around the whole chunk
+bool Scanner::scanChunkInPlace(uintptr_t chunkBase, size_t chunkSize, size_t leadingOverlap, ScanType scanType,
+                               const void* targetValue, std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+	__try {
+		scanChunkAfterOverlap((const uint8_t*)chunkBase, chunkSize, chunkBase, leadingOverlap, scanType, targetValue,
+		                      localResults, maxLocalResults);
+		return true;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER) {
+		return false;
+	}
+}
+
+// Pages are copied one at a time and each run of readable pages is scanned
+// on its own. Values that cross into an unreadable page are lost
+void Scanner::scanChunkByPage(uintptr_t chunkBase, size_t chunkSize, size_t leadingOverlap, ScanType scanType,
+                              const void* targetValue, uint8_t* buffer, std::vector<ScanResult>& localResults,
+                              size_t maxLocalResults) {
+	size_t runStart = 0;
+	size_t offset = 0;
+	while (offset < chunkSize) {
+		size_t pageEnd = (size_t)(((chunkBase + offset) / SCAN_PAGE_SIZE + 1) * SCAN_PAGE_SIZE - chunkBase);
+		size_t pieceSize = std::min<size_t>(pageEnd, chunkSize) - offset;
+
+		if (!safeCopyMemory(buffer + offset, (const void*)(chunkBase + offset), pieceSize)) {
+			if (offset > runStart) {
+				scanChunkAfterOverlap(buffer + runStart, offset - runStart, chunkBase + runStart,
+				                      leadingOverlap > runStart ? leadingOverlap - runStart : 0, scanType, targetValue,
+				                      localResults, maxLocalResults);
+			}
+			runStart = offset + pieceSize;
+		}
+		offset += pieceSize;
+	}
+
+	if (chunkSize > runStart) {
+		scanChunkAfterOverlap(buffer + runStart, chunkSize - runStart, chunkBase + runStart,
+		                      leadingOverlap > runStart ? leadingOverlap - runStart : 0, scanType, targetValue,
+		                      localResults, maxLocalResults);
+	}
+}
+
+void Scanner::scanChunkAfterOverlap(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
+                                    size_t leadingOverlap, ScanType scanType, const void* targetValue,
+                                    std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+	scanChunkInRegion(buffer, chunkSize, chunkBase, scanType, targetValue, localResults, maxLocalResults);
+}
+
+// Default rescan implementation - splits the results into shards and
+// rescans them in parallel
 void Scanner::rescanImpl(ScanType scanType, const void* targetValue, size_t valueSize) {
-	// Allocate buffer for chunk-based reading using scanner heap
-	// We use CHUNK_THRESHOLD for rescans since we only batch results within that distance
-	// ALlocated it once and reuse it
-	std::vector<uint8_t, ScannerAllocator<uint8_t>> buffer(CHUNK_THRESHOLD);
-
-	std::vector<ScanResult, ScannerAllocator<ScanResult>> newResults;
-	newResults.reserve(results.size());
-
-	// Walk through results dynamically, querying regions JIT (like initial scan)
-	size_t resultIdx = 0;
-	while (resultIdx < results.size()) {
-		ScanResult& result = results[resultIdx];
-
-		// Query the memory region for this result address (JIT approach)
-		MEMORY_BASIC_INFORMATION mbi{};
-		if (VirtualQuery((LPCVOID)result.address, &mbi, sizeof(mbi)) != sizeof(mbi)) {
-			// Failed to query - address invalid
-			invalidAddressCount++;
-			resultIdx++;
+	// One refresh of the shared region map replaces the VirtualQuery per
+	// result cluster
+	SafeMemory::RegionList regionMap;
+	regionGeneration = SafeMemory::get_regions(regionMap);
+
+	// Shard boundaries are moved to the next page so results batched
+	// together usually stay in one shard. Pages never span regions, and
+	// each shard finds its first region with a binary search of the map
+	std::vector<size_t, ScannerAllocator<size_t>> bounds;
+	bounds.push_back(0);
+	if (results.size() >= 2 * RESCAN_SHARD_MIN_RESULTS) {
+		size_t shardCount = std::min<size_t>((size_t)omp_get_max_threads() * 4,
+		                                     results.size() / RESCAN_SHARD_MIN_RESULTS);
+		for (size_t i = 1; i < shardCount; i++) {
+			size_t bound = std::max<size_t>(results.size() * i / shardCount, bounds.back());
+			while (bound < results.size() && bound > 0 &&
+			       results.getAddress(bound) / CHUNK_THRESHOLD == results.getAddress(bound - 1) / CHUNK_THRESHOLD) {
+				bound++;
+			}
+			if (bound > bounds.back() && bound < results.size()) {
+				bounds.push_back(bound);
+			}
+		}
+	}
+	bounds.push_back(results.size());
+
+	const int shardCount = (int)(bounds.size() - 1);
+	const size_t storedValueSize = results.getValueSize();
+	std::vector<ResultStore, ScannerAllocator<ResultStore>> shardResults(shardCount, ResultStore(storedValueSize, true));
+
+	if (shardCount == 1) {
+		std::vector<uint8_t, ScannerAllocator<uint8_t>> buffer(CHUNK_THRESHOLD);
+		std::vector<ScanResult, ScannerAllocator<ScanResult>> batchResults;
+		shardResults[0].reserve(results.size());
+		rescanShard(regionMap, 0, results.size(), scanType, targetValue, shardResults[0], buffer, batchResults);
+		if (isCancelled()) {
+			scanCancelled = true;
+			return;
+		}
+		results = std::move(shardResults[0]);
+		return;
+	}
+
+	// Dynamic schedule since shards with more valid memory take longer
+	#pragma omp parallel
+	{
+		// One CHUNK_THRESHOLD buffer per thread reused for all its shards
+		std::vector<uint8_t, ScannerAllocator<uint8_t>> buffer(CHUNK_THRESHOLD);
+		std::vector<ScanResult, ScannerAllocator<ScanResult>> batchResults;
+
+		#pragma omp for schedule(dynamic, 1)
+		for (int shard = 0; shard < shardCount; shard++) {
+			shardResults[shard].reserve(bounds[shard + 1] - bounds[shard]);
+			rescanShard(regionMap, bounds[shard], bounds[shard + 1], scanType, targetValue,
+			            shardResults[shard], buffer, batchResults);
+		}
+	}
+
+	// The old results stay untouched until every shard finished
+	if (isCancelled()) {
+		scanCancelled = true;
+		return;
+	}
+
+	// Concatenate in shard order. The old results are freed first so the
+	// peak stays at the old results plus the survivors
+	size_t survivorCount = 0;
+	for (const ResultStore& shard : shardResults) {
+		survivorCount += shard.size();
+	}
+	results = ResultStore(storedValueSize, true);
+	results.reserve(survivorCount);
+	for (ResultStore& shard : shardResults) {
+		results.append(shard);
+		shard = ResultStore();
+	}
+}
+
+// Rescan one contiguous shard of results with a merge join against the region map
+void Scanner::rescanShard(const SafeMemory::RegionList& regionMap,
+                          size_t first, size_t last, ScanType scanType, const void* targetValue,
+                          ResultStore& newResults,
+                          std::vector<uint8_t, ScannerAllocator<uint8_t>>& buffer,
+                          std::vector<ScanResult, ScannerAllocator<ScanResult>>& batchResults) {
+	if (first >= last) {
+		return;
+	}
+
+	// First region that ends after the shard's first result
+	auto region = std::upper_bound(regionMap.begin(), regionMap.end(), results.getAddress(first),
+	                               [](uintptr_t address, const SafeMemory::RegionInfo& info) {
+		return address < info.base + info.size;
+	});
+
+	// Progress is published every few batches so shards don't contend on it
+	size_t resultIdx = first;
+	size_t reportedIdx = first;
+	size_t reportedResults = newResults.size();
+	while (resultIdx < last && !isCancelled()) {
+		if (resultIdx - reportedIdx >= CHUNK_THRESHOLD) {
+			addProgress(resultIdx - reportedIdx, newResults.size() - reportedResults);
+			reportedIdx = resultIdx;
+			reportedResults = newResults.size();
+		}
+
+		uintptr_t address = results.getAddress(resultIdx);
+		while (region != regionMap.end() && region->base + region->size <= address) {
+			++region;
+		}
+
+		// Not in any committed region - memory was freed. Skip up to the next region
+		if (region == regionMap.end() || address < region->base) {
+			uintptr_t nextBase = region == regionMap.end() ? UINTPTR_MAX : region->base;
+			size_t skipped = 0;
+			while (resultIdx < last && results.getAddress(resultIdx) < nextBase) {
+				skipped++;
+				resultIdx++;
+			}
+			invalidAddressCount += skipped;
 			continue;
 		}
 
@@ -304,39 +653,38 @@ void Scanner::rescanImpl(ScanType scanType, const void* targetValue, size_t valu
 		// the scanner heap was excluded from the initial scan
 
 		// Check if region is safe for reading
-		if (!SafeMemory::is_mbi_safe(mbi, false)) {
+		uintptr_t regionEnd = region->base + region->size;
+		if (!SafeMemory::is_region_safe(*region, false)) {
 			// Region not safe - skip results in this entire region
-			uintptr_t regionEnd = (uintptr_t)mbi.BaseAddress + (uintptr_t)mbi.RegionSize;
-			while (resultIdx < results.size() && results[resultIdx].address < regionEnd) {
-				invalidAddressCount++;
+			size_t skipped = 0;
+			while (resultIdx < last && results.getAddress(resultIdx) < regionEnd) {
+				skipped++;
 				resultIdx++;
 			}
+			invalidAddressCount += skipped;
 			continue;
 		}
 
 		// Region is safe - call derived class to process results in this region
-		processResultsInRegion(mbi, resultIdx, scanType, targetValue, newResults, buffer);
+		processResultsInRegion(region->base, regionEnd, resultIdx, last, scanType, targetValue,
+		                       newResults, buffer, batchResults);
 	}
-
-	// Replace results with filtered results
-	results = std::move(newResults);
+	addProgress(resultIdx - reportedIdx, newResults.size() - reportedResults);
 }
 
 // Process results in a single memory region for rescan
-void Scanner::processResultsInRegion(MEMORY_BASIC_INFORMATION& mbi, size_t& resultIdx,
+void Scanner::processResultsInRegion(uintptr_t regionBase, uintptr_t regionEnd, size_t& resultIdx, size_t resultEnd,
                                       ScanType scanType, const void* targetValue,
-                                      std::vector<ScanResult, ScannerAllocator<ScanResult>>& newResults,
-                                      std::vector<uint8_t, ScannerAllocator<uint8_t>>& buffer) {
+                                      ResultStore& newResults,
+                                      std::vector<uint8_t, ScannerAllocator<uint8_t>>& buffer,
+                                      std::vector<ScanResult, ScannerAllocator<ScanResult>>& batchResults) {
 	// Cache data type size
 	const size_t dataSize = getDataTypeSize();
 
-	uintptr_t regionBase = (uintptr_t)mbi.BaseAddress;
-	uintptr_t regionEnd = regionBase + (uintptr_t)mbi.RegionSize;
-
-	ScanResult& result = results[resultIdx];
+	ScanResult result = results[resultIdx];
 
 	// Check if value fits entirely in region
-	if (result.address + dataSize > regionEnd) {
+	if (result.address + getResultSize(result) > regionEnd) {
 		// Value spans region boundary are not legal
 		invalidAddressCount++;
 		resultIdx++;
@@ -350,8 +698,8 @@ void Scanner::processResultsInRegion(MEMORY_BASIC_INFORMATION& mbi, size_t& resu
 	uintptr_t chunkStart = result.address;
 	uintptr_t chunkEnd = result.address + dataSize;
 
-	while (batchEnd < results.size() && results[batchEnd].address < regionEnd) {
-		uintptr_t nextResultEnd = results[batchEnd].address + dataSize;
+	while (batchEnd < resultEnd && results.getAddress(batchEnd) < regionEnd) {
+		uintptr_t nextResultEnd = results.getAddress(batchEnd) + dataSize;
 		uintptr_t newSpan = nextResultEnd - chunkStart;
 		if (newSpan > CHUNK_THRESHOLD) {
 			break;
@@ -372,14 +720,27 @@ void Scanner::processResultsInRegion(MEMORY_BASIC_INFORMATION& mbi, size_t& resu
 
 		// Copy chunk with try/catch protection
 		if (!safeCopyMemory(buffer.data(), (const void*)chunkStart, chunkSize)) {
-			// Memory became invalid - skip all results in batch
-			invalidAddressCount += (batchEnd - batchStart);
+			// The map can be stale if memory changed after the refresh. Query the
+			// real region and read the batch results one at a time
+			MEMORY_BASIC_INFORMATION mbi{};
+			if (VirtualQuery((LPCVOID)chunkStart, &mbi, sizeof(mbi)) == sizeof(mbi) &&
+			    SafeMemory::is_mbi_safe(mbi, false)) {
+				uintptr_t queriedBase = (uintptr_t)mbi.BaseAddress;
+				uintptr_t queriedEnd = queriedBase + (uintptr_t)mbi.RegionSize;
+				for (size_t j = batchStart; j < batchEnd; j++) {
+					rescanResultDirect(results[j], queriedBase, queriedEnd, scanType, targetValue, newResults);
+				}
+			} else {
+				// Memory became invalid - skip all results in batch
+				invalidAddressCount += (batchEnd - batchStart);
+			}
 			resultIdx = batchEnd;
 			return;
 		}
 
 		// Process batch from buffer
-		rescanResultBatch(results, batchStart, batchEnd, chunkStart, chunkSize,
+		results.copyTo(batchStart, batchEnd, batchResults);
+		rescanResultBatch(batchResults, 0, batchResults.size(), chunkStart, chunkSize,
 		                  buffer.data(), scanType, targetValue, newResults);
 
 		resultIdx = batchEnd;
@@ -395,10 +756,13 @@ void Scanner::rescanResultBatch(const std::vector<ScanResult, ScannerAllocator<S
                                  size_t batchStart, size_t batchEnd,
                                  uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
                                  ScanType scanType, const void* targetValue,
-                                 std::vector<ScanResult, ScannerAllocator<ScanResult>>& newResults) {
+                                 ResultStore& newResults) {
 	// Cache data type size
 	const size_t dataSize = getDataTypeSize();
 
+	// Counted locally since shards run in parallel
+	size_t invalidCount = 0;
+
 	// Process all results from buffer
 	for (size_t j = batchStart; j < batchEnd; j++) {
 		const ScanResult& batchResult = oldResults[j];
@@ -406,57 +770,58 @@ void Scanner::rescanResultBatch(const std::vector<ScanResult, ScannerAllocator<S
 
 		// Verify address is within chunk
 		if (offset + dataSize > chunkSize) {
-			invalidAddressCount++;
+			invalidCount++;
 			continue;
 		}
 
-		// Store old value for comparison (needed for CHANGED/UNCHANGED/etc scans)
-		ScanValue oldValue = batchResult.value;
+		// Set old value before validating so CHANGED/UNCHANGED/etc scans compare
+		// against it (sequences don't use it, but minimal cost)
+		ScanResult tempResult;
+		tempResult.oldValue = batchResult.value;
+		tempResult.hasOldValue = true;
 
 		// Validate value from buffer
-		ScanResult tempResult;
 		if (!validateValueInBuffer(buffer, chunkSize, offset, batchResult.address,
 		                           scanType, targetValue, tempResult)) {
-			invalidAddressCount++;
+			invalidCount++;
 			continue;
 		}
 
-		// Set old value for comparison (sequences don't use it, but minimal cost)
-		tempResult.oldValue = oldValue;
-		tempResult.hasOldValue = true;
-
 		// Add to new results
 		newResults.push_back(tempResult);
 	}
+
+	invalidAddressCount += invalidCount;
 }
 
 // Process a single isolated result with direct memory read
 void Scanner::rescanResultDirect(const ScanResult& oldResult, uintptr_t regionStart, uintptr_t regionEnd,
                                   ScanType scanType, const void* targetValue,
-                                  std::vector<ScanResult, ScannerAllocator<ScanResult>>& newResults) {
-	// Store old value for comparison (needed for CHANGED/UNCHANGED/etc scans)
-	ScanValue oldValue = oldResult.value;
+                                  ResultStore& newResults) {
+	// Set old value before validating so CHANGED/UNCHANGED/etc scans compare
+	// against it (sequences don't use it, but minimal cost)
+	ScanResult tempResult;
+	tempResult.oldValue = oldResult.value;
+	tempResult.hasOldValue = true;
 
 	// Call derived class to validate value directly from memory (with SEH protection)
-	ScanResult tempResult;
 	if (!validateValueDirect(oldResult.address, regionStart, regionEnd, scanType, targetValue, tempResult)) {
 		invalidAddressCount++;
 		return;
 	}
 
-	// Set old value for comparison (sequences don't use it, but minimal cost)
-	tempResult.oldValue = oldValue;
-	tempResult.hasOldValue = true;
-
 	// Add to new results
 	newResults.push_back(tempResult);
 }
 
 // Default reset implementation
 void Scanner::reset() {
+	endStepScan();
 	results.clear();
+	regionFilterStats = RegionFilterStats();
 	firstScanDone = false;
 	maxResultsReached = false;
+	resultsSorted = true;
 	invalidAddressCount = 0;
 	clearErrors();
 }
@@ -467,15 +832,19 @@ void Scanner::addError(const char* format, ...) const {
 	va_start(args, format);
 	vsnprintf_s(buffer, sizeof(buffer), _TRUNCATE, format, args);
 	va_end(args);
+
+	AcquireSRWLockExclusive(&errorsLock);
 	errors.emplace_back(buffer);
+	ReleaseSRWLockExclusive(&errorsLock);
 }
 
 void Scanner::reportInvalidAddressStats() {
-	if (invalidAddressCount > 0) {
-		if (results.size() == 0) {
-			addError("All %zu addresses became invalid (memory may have been freed)", invalidAddressCount);
+	size_t invalidCount = invalidAddressCount.load();
+	if (invalidCount > 0) {
+		if (getResultCount() == 0) {
+			addError("All %zu addresses became invalid (memory may have been freed)", invalidCount);
 		} else {
-			addError("%zu addresses became invalid", invalidAddressCount);
+			addError("%zu addresses became invalid", invalidCount);
 		}
 	}
 }
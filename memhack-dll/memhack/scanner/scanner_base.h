@@ -4,12 +4,19 @@
 #include <vector>
 #include <cstdint>
 #include <string>
+#include <atomic>
+#include <thread>
 #include <Windows.h>
 #include "scanner_heap.h"
+#include "scanner_result_store.h"
+
+class ResultSink;
+class AsyncScanJob;
 
 // Forward declare for SafeMemory::Region
 namespace SafeMemory {
 	struct Region;
+	struct RegionInfo;
 }
 
 // Buffer size for scanning - use 64KB chunks for good cache performance
@@ -18,6 +25,13 @@ const size_t SCAN_BUFFER_SIZE = 65536;
 // Rescan batching threshold - batch results within 4KB of each other
 const size_t CHUNK_THRESHOLD = 4096;
 
+// Chunks that fault while scanned in place are copied in pieces of this size
+const size_t SCAN_PAGE_SIZE = 4096;
+
+// Rescans with fewer results than this stay on one thread, and larger ones
+// are split into shards of at least this many results
+const size_t RESCAN_SHARD_MIN_RESULTS = 16384;
+
 // Memory region for parallel scanning
 struct MemoryRegion {
 	uintptr_t base;
@@ -27,6 +41,58 @@ struct MemoryRegion {
 	MemoryRegion(uintptr_t b, size_t s) : base(b), size(s) {}
 };
 
+// Which safe regions a first scan visits. Regions are checked in order by
+// memory type, protection, module and address range and the bytes each check
+// removes are counted in RegionFilterStats
+struct RegionFilter {
+	// Memory type bits
+	static const uint32_t TYPE_PRIVATE = 1 << 0;
+	static const uint32_t TYPE_IMAGE = 1 << 1;
+	static const uint32_t TYPE_MAPPED = 1 << 2;
+	static const uint32_t TYPE_ALL = TYPE_PRIVATE | TYPE_IMAGE | TYPE_MAPPED;
+
+	// Protection bits
+	static const uint32_t PROTECT_WRITABLE = 1 << 0;
+	static const uint32_t PROTECT_EXECUTABLE = 1 << 1;
+
+	uint32_t memoryTypes;       // Allowed memory types
+	uint32_t requireProtect;    // Protection bits a region must have
+	uint32_t excludeProtect;    // Protection bits a region must not have
+	uintptr_t minAddress;       // Regions are clipped to [minAddress, maxAddress)
+	uintptr_t maxAddress;
+
+	// Module file names (i.e. "lua5.1.dll"). Only regions of the included
+	// modules are kept if any are given. Excluded modules are always dropped
+	std::vector<std::string, ScannerAllocator<std::string>> modules;
+	std::vector<std::string, ScannerAllocator<std::string>> excludeModules;
+
+	RegionFilter() : memoryTypes(TYPE_ALL), requireProtect(0), excludeProtect(0), minAddress(0), maxAddress(UINTPTR_MAX) {}
+};
+
+// Bytes removed by each RegionFilter check during the last first scan
+struct RegionFilterStats {
+	uint64_t scannedBytes;
+	uint64_t typeBytes;
+	uint64_t protectionBytes;
+	uint64_t moduleBytes;
+	uint64_t addressBytes;
+	uint64_t rangeBytes;        // Outside the scan ranges
+
+	RegionFilterStats() : scannedBytes(0), typeBytes(0), protectionBytes(0), moduleBytes(0), addressBytes(0), rangeBytes(0) {}
+};
+
+// Progress of the running or last scan. First scans count bytes of memory
+// and list rescans count the old results checked
+struct ScanProgress {
+	uint64_t done;
+	uint64_t total;
+	bool countsBytes;
+	size_t results;     // Results found so far
+	bool cancelled;     // Cancel was requested for the running scan
+
+	ScanProgress() : done(0), total(0), countsBytes(true), results(0), cancelled(false) {}
+};
+
 // Float comparison epsilons
 const float FLOAT_EPSILON = 0.0001f;
 const double DOUBLE_EPSILON = 0.00000001;
@@ -38,29 +104,8 @@ enum class ScanType {
 	DECREASED,
 	CHANGED,
 	UNCHANGED,
-	NOT
-};
-
-union ScanValue {
-	uint8_t byteValue;
-	int32_t intValue;
-	float floatValue;
-	double doubleValue;
-	bool boolValue;
-};
-
-// Single scan result
-// Will only include basic type data. Sequences are not stored
-struct ScanResult {
-	uintptr_t address;
-	ScanValue value;
-	ScanValue oldValue;
-	bool hasOldValue;
-
-	ScanResult() : address(0), hasOldValue(false) {
-		value.doubleValue = 0.0;
-		oldValue.doubleValue = 0.0;
-	}
+	NOT,
+	UNKNOWN     // First scan only. Every slot matches and values are kept for relative rescans
 };
 
 // Base Scanner class - abstract interface
@@ -69,7 +114,8 @@ struct ScanResult {
 // for various types under the hood
 class Scanner {
 public:
-	virtual ~Scanner() {}
+	// Background scans must be finished with finishAsync before deleting
+	virtual ~Scanner();
 
 	// Override new/delete to allocate from scanner heap
 	// This ensures the Scanner and data can be excluded from scans
@@ -84,12 +130,20 @@ public:
 	// pure virtual getters
 	virtual size_t getDataTypeSize() const = 0;
 
+	// Size of the memory a result covers. Same as the data type size unless
+	// results can differ in size (i.e. multi-pattern scans)
+	virtual size_t getResultSize(const ScanResult& result) const { return getDataTypeSize(); }
+
+	// Bytes of each result value kept between scans. 0 for scanners that
+	// only keep addresses and read values from memory when needed
+	virtual size_t getStoredValueSize() const { return getDataTypeSize(); }
+
 	// Getters
 	virtual bool isFirstScan() const { return !firstScanDone; }
 	virtual ScanType getLastScanType() const { return lastScanType; }
 
 	// Results
-	virtual const std::vector<ScanResult, ScannerAllocator<ScanResult>>& getResults() const { return results; }
+	virtual const ResultStore& getResults() const { return results; }
 	virtual size_t getResultCount() const { return results.size(); }
 	virtual bool isMaxResultsReached() const { return maxResultsReached; }
 
@@ -99,6 +153,63 @@ public:
 	virtual size_t getInvalidAddressCount() const { return invalidAddressCount; }
 	virtual bool hasError() const { return !errors.empty(); }
 
+	// Restrict first scans to the given address ranges (i.e. a module's code
+	// section). Safe regions are clipped to them. Empty means all memory
+	// Rescans only visit existing results so they are not affected
+	void setScanRanges(const std::vector<MemoryRegion, ScannerAllocator<MemoryRegion>>& ranges);
+	void clearScanRanges() { scanRanges.clear(); }
+	const std::vector<MemoryRegion, ScannerAllocator<MemoryRegion>>& getScanRanges() const { return scanRanges; }
+
+	// Filter safe regions by memory type, protection, module and address for
+	// first scans. The default filter is restored by resetRegionFilter so it
+	// can be set once per scanner and overridden per scan
+	void setRegionFilter(const RegionFilter& filter) { regionFilter = filter; }
+	void setDefaultRegionFilter(const RegionFilter& filter) { defaultRegionFilter = filter; regionFilter = filter; }
+	void resetRegionFilter() { regionFilter = defaultRegionFilter; }
+	const RegionFilter& getRegionFilter() const { return regionFilter; }
+	const RegionFilter& getDefaultRegionFilter() const { return defaultRegionFilter; }
+	const RegionFilterStats& getRegionFilterStats() const { return regionFilterStats; }
+
+	// Scan first scan chunks directly in the target memory instead of
+	// copying them to a buffer first, which halves the memory traffic. Values
+	// can change while a chunk is scanned, the same as right after a copy
+	void setInPlaceScan(bool enabled) { inPlaceScan = enabled; }
+	bool getInPlaceScan() const { return inPlaceScan; }
+
+	// Region map generation the last scan or rescan used
+	uint32_t getRegionGeneration() const { return regionGeneration; }
+
+	// Background scans. The job runs on its own thread with OpenMP doing the
+	// parallel work as usual. Only progress and cancel may be used until the
+	// job is done and finishAsync collected it, so results are replaced in
+	// one step as far as the caller can tell. Takes ownership of job
+	bool startAsync(AsyncScanJob* job);
+	bool hasAsyncJob() const { return asyncJob != nullptr; }
+	const AsyncScanJob* getAsyncJob() const { return asyncJob; }
+	bool isAsyncDone() const { return asyncDone.load(); }
+	// Wait for the job and free it. Does nothing if there is none
+	void finishAsync();
+
+	// Ask the running scan to stop. A cancelled first scan leaves no results
+	// and a cancelled rescan keeps the previous ones. Bitmap rescans update
+	// results in place so they always run to the end. Stepped scans stop
+	// right away
+	void cancel();
+	bool isCancelled() const { return cancelRequested.load(std::memory_order_relaxed); }
+	// The last scan stopped early because of a cancel
+	bool wasCancelled() const { return scanCancelled; }
+	ScanProgress getProgress() const;
+
+	// Stepped first scans. Memory is scanned on the caller's thread in
+	// budgeted steps so no other thread reads it while the game runs
+	// Results accumulate in the scanner between steps. targetOwner keeps
+	// targetValue alive until the scan ends (may be null). Takes ownership
+	bool beginStepScan(ScanType scanType, const void* targetValue, size_t valueSize, AsyncScanJob* targetOwner);
+	// Scan chunks until budgetMicroseconds is used, at least one per call
+	// Returns true once the scan finished
+	bool stepScan(uint64_t budgetMicroseconds);
+	bool isStepScanActive() const { return stepActive; }
+
 	// Timing
 	virtual void setCheckTiming(bool enabled) { checkTiming = enabled; }
 	virtual bool getCheckTiming() const { return checkTiming; }
@@ -112,15 +223,50 @@ protected:
 	// Common state shared by all scanners
 	size_t maxResults;
 	size_t alignment;
-	std::vector<ScanResult, ScannerAllocator<ScanResult>> results;
+	ResultStore results;
 	bool firstScanDone;
 	bool maxResultsReached;
+	// Results are in address order. The base first scan produces them that
+	// way and rescans keep it, so rescan only sorts if an override broke it
+	bool resultsSorted;
 	bool checkTiming;
+	bool inPlaceScan;
 	ScanType lastScanType;
+	std::vector<MemoryRegion, ScannerAllocator<MemoryRegion>> scanRanges;
+	RegionFilter regionFilter;
+	RegionFilter defaultRegionFilter;
+	RegionFilterStats regionFilterStats;
+	uint32_t regionGeneration;
+
+	// Background scan state. Progress counters are updated by scan threads
+	// and read from the caller's thread while a background scan runs
+	AsyncScanJob* asyncJob;
+	std::thread asyncThread;
+	std::atomic<bool> asyncDone;
+	std::atomic<bool> cancelRequested;
+	// Set by scan implementations that stopped early because of a cancel
+	bool scanCancelled;
+	std::atomic<uint64_t> progressDone;
+	std::atomic<uint64_t> progressTotal;
+	std::atomic<bool> progressBytes;
+	std::atomic<size_t> progressResults;
+
+	// Stepped first scan state. The cursor is a region index and the offset
+	// of the next chunk in that region
+	bool stepActive;
+	ScanType stepScanType;
+	const void* stepTarget;
+	AsyncScanJob* stepTargetOwner;
+	std::vector<MemoryRegion, ScannerAllocator<MemoryRegion>> stepRegions;
+	size_t stepRegion;
+	size_t stepOffset;
+	ULONGLONG stepStartTime;
 
 	// Error tracking (mutable so const methods can log errors)
+	// Scan threads log errors and count invalid addresses concurrently
 	mutable std::vector<std::string, ScannerAllocator<std::string>> errors;
-	mutable size_t invalidAddressCount;
+	mutable SRWLOCK errorsLock;
+	mutable std::atomic<size_t> invalidAddressCount;
 
 	// Protected constructor for derived classes
 	Scanner(size_t maxResults, size_t alignment);
@@ -137,19 +283,70 @@ protected:
 		return true;
 	}
 
+	// Scanners that can keep a snapshot for UNKNOWN first scans
+	virtual bool supportsUnknownScan() const {
+		return false;
+	}
+
+	// Scanners whose first scan is the base region loop with no extra
+	// processing afterwards can be stepped
+	virtual bool supportsStepScan() const {
+		return true;
+	}
+
+	// Validation and result setup shared by firstScan and beginStepScan
+	bool prepareFirstScan(ScanType scanType, const void* targetValue, size_t valueSize);
+	// Drop the state of an unfinished stepped scan
+	void endStepScan();
+
 	// -------- Default first scan related functions ---------
 
-	// Enumerate all safe memory regions for scanning
-	std::vector<MemoryRegion> enumerateSafeRegions();
+	// Enumerate all safe memory regions for scanning. When filtering, regions
+	// go through regionFilter and are clipped to scanRanges if set
+	std::vector<MemoryRegion> enumerateSafeRegions(bool applyFilters = true);
+	size_t addClippedRegion(std::vector<MemoryRegion>& regions, uintptr_t base, size_t size) const;
+
+	// Apply regionFilter to a safe region. Returns false if it is dropped and
+	// clips it to the address range in place. Removed bytes are counted
+	// against the first check that removed them
+	bool filterRegion(const SafeMemory::RegionInfo& info, const std::vector<HMODULE>& includedModules,
+	                  const std::vector<HMODULE>& excludedModules, MemoryRegion& region);
 
 	// Base class provides default region loop implementation
 	virtual void firstScanImpl(ScanType scanType, const void* targetValue, size_t valueSize);
 
-	// Scan a single region into local results (used by parallel first scan)
-	void scanRegion(uintptr_t base, size_t size, ScanType scanType, const void* targetValue,
-	                std::vector<uint8_t>& buffer, std::vector<ScanResult>& localResults, size_t maxLocalResults);
+	// Scan a single region into the result sink (used by parallel first scan)
+	// localResults is per thread staging for one chunk. leadingOverlap is how
+	// far the region starts inside the previous work unit
+	void scanRegion(uintptr_t base, size_t size, size_t leadingOverlap, ScanType scanType, const void* targetValue,
+	                std::vector<uint8_t>& buffer, std::vector<ScanResult>& localResults,
+	                ResultSink& sink, int thread, uint32_t unit);
+
+	// Scan one chunk into localResults, in place or from a copy in buffer
+	// (SCAN_BUFFER_SIZE bytes). In place chunks that fault are copied page by
+	// page and their readable runs scanned, where a failed full copy skips
+	// the chunk. buffer is only used for copies
+	// The first leadingOverlap bytes were also scanned by the previous chunk
+	void scanChunk(uintptr_t chunkBase, size_t chunkSize, size_t leadingOverlap, ScanType scanType,
+	               const void* targetValue, uint8_t* buffer, std::vector<ScanResult>& localResults,
+	               size_t maxLocalResults);
+	// Run scanChunkAfterOverlap on the source memory. False if reading it faulted
+	bool scanChunkInPlace(uintptr_t chunkBase, size_t chunkSize, size_t leadingOverlap, ScanType scanType,
+	                      const void* targetValue, std::vector<ScanResult>& localResults, size_t maxLocalResults);
+	void scanChunkByPage(uintptr_t chunkBase, size_t chunkSize, size_t leadingOverlap, ScanType scanType,
+	                     const void* targetValue, uint8_t* buffer, std::vector<ScanResult>& localResults,
+	                     size_t maxLocalResults);
+
+	// Chunk scan that may drop results lying entirely in the first
+	// leadingOverlap bytes, since the previous chunk already found them. The
+	// default scans everything as a fixed size value never fits in an overlap
+	virtual void scanChunkAfterOverlap(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
+	                                   size_t leadingOverlap, ScanType scanType, const void* targetValue,
+	                                   std::vector<ScanResult>& localResults, size_t maxLocalResults);
 
 	// Derived classes must implement chunk scanning into local results
+	// Results must be in address order within the chunk, otherwise the
+	// derived firstScanImpl has to sort them or clear resultsSorted
 	virtual void scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
 	                               ScanType scanType, const void* targetValue,
 	                               std::vector<ScanResult>& localResults, size_t maxLocalResults) = 0;
@@ -160,18 +357,35 @@ protected:
 	// Has a default implemnetation that can be overridden by derived classes
 	virtual void rescanImpl(ScanType scanType, const void* targetValue, size_t valueSize);
 
-	void processResultsInRegion(MEMORY_BASIC_INFORMATION& mbi, size_t& resultIdx,
+	// Rescan results [first, last) into newResults. Shards of the result
+	// array are run in parallel so everything called from here must only
+	// touch its own shard's state
+	// Results and the committed regions of the map are walked together so
+	// regions are looked up once rather than queried per result cluster
+	// buffer and batchResults are the caller's per thread staging
+	void rescanShard(const std::vector<SafeMemory::RegionInfo, ScannerAllocator<SafeMemory::RegionInfo>>& regionMap,
+	                 size_t first, size_t last, ScanType scanType, const void* targetValue,
+	                 ResultStore& newResults,
+	                 std::vector<uint8_t, ScannerAllocator<uint8_t>>& buffer,
+	                 std::vector<ScanResult, ScannerAllocator<ScanResult>>& batchResults);
+
+	// Rescan the next batch of results in the region [regionBase, regionEnd)
+	// The batch is rebuilt from the result columns into batchResults
+	void processResultsInRegion(uintptr_t regionBase, uintptr_t regionEnd, size_t& resultIdx, size_t resultEnd,
 	                             ScanType scanType, const void* targetValue,
-	                             std::vector<ScanResult, ScannerAllocator<ScanResult>>& newResults,
-	                             std::vector<uint8_t, ScannerAllocator<uint8_t>>& buffer);
-	void rescanResultBatch(const std::vector<ScanResult, ScannerAllocator<ScanResult>>& oldResults, size_t batchStart, size_t batchEnd,
-	                       uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
-	                       ScanType scanType, const void* targetValue, std::vector<ScanResult, ScannerAllocator<ScanResult>>& newResults);
+	                             ResultStore& newResults,
+	                             std::vector<uint8_t, ScannerAllocator<uint8_t>>& buffer,
+	                             std::vector<ScanResult, ScannerAllocator<ScanResult>>& batchResults);
+	// Process a batch of results from a chunk buffer. Virtual so scanners with
+	// vectorized kernels can replace the per result validation loop
+	virtual void rescanResultBatch(const std::vector<ScanResult, ScannerAllocator<ScanResult>>& oldResults, size_t batchStart, size_t batchEnd,
+	                               uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
+	                               ScanType scanType, const void* targetValue, ResultStore& newResults);
 
 	// Direct result processing - base class handles common logic
 	void rescanResultDirect(const ScanResult& oldResult, uintptr_t regionStart, uintptr_t regionEnd,
 	                        ScanType scanType, const void* targetValue,
-	                        std::vector<ScanResult, ScannerAllocator<ScanResult>>& newResults);
+	                        ResultStore& newResults);
 
 	// Derived classes implement these validation methods
 	// Validate value directly from memory with try/catch protection
@@ -186,6 +400,15 @@ protected:
 
 	// -------- End of default rescan related functions ---------
 
+	// Progress reporting for scan implementations
+	void resetProgress(uint64_t total, bool countsBytes);
+	void addProgress(uint64_t done, size_t results = 0) {
+		progressDone.fetch_add(done, std::memory_order_relaxed);
+		if (results != 0) {
+			progressResults.fetch_add(results, std::memory_order_relaxed);
+		}
+	}
+
 	// Common helper methods implemented in base
 	void addError(const char* format, ...) const;
 	void reportInvalidAddressStats();
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "scanner_basic.h"
+#include "scanner_basic_kernels.h"
 #include "../safememory.h"
 
 #include <cmath>
@@ -17,12 +18,18 @@ void BasicScanner::operator delete(void* ptr) noexcept {
 }
 
 BasicScanner::BasicScanner(DataType dataType, size_t maxResults, size_t alignment) :
-	Scanner(maxResults, alignment), dataType(dataType)
+	Scanner(maxResults, alignment), dataType(dataType), epsilon(getDefaultEpsilon(dataType)),
+	chunkKernel(nullptr), rescanKernel(nullptr), maskKernel(nullptr), relativeMaskKernel(nullptr),
+	bitmapRequested(false), bitmapMode(false), bitmapCount(0), writeWatchRequested(false)
 {
 	// Default alignment to data type size if not specified
 	if (this->alignment == 0) {
 		this->alignment = getDataTypeSize();
 	}
+
+	kernelParams.target.doubleValue = 0.0;
+	kernelParams.alignment = this->alignment;
+	kernelParams.epsilon = epsilon;
 }
 
 BasicScanner::~BasicScanner() {}
@@ -46,18 +53,146 @@ size_t BasicScanner::getDataTypeSize() const {
 	return getDataTypeSize(dataType);
 }
 
+double BasicScanner::getDefaultEpsilon(DataType type) {
+	switch (type) {
+		case DataType::FLOAT: return FLOAT_EPSILON;
+		case DataType::DOUBLE: return DOUBLE_EPSILON;
+		default: return 0.0;
+	}
+}
+
+bool BasicScanner::setEpsilon(double newEpsilon) {
+	// Compares are strict so a zero epsilon would never match
+	if (!(newEpsilon > 0.0)) {
+		return false;
+	}
+	epsilon = newEpsilon;
+	return true;
+}
+
+BasicScanner::ChunkKernel BasicScanner::selectChunkKernel(ScannerSimd::Level level, DataType dataType, ScanType scanType) {
+	// Kernels only cover first scan style comparisons against a target
+	if (scanType != ScanType::EXACT && scanType != ScanType::NOT) {
+		return nullptr;
+	}
+
+	ChunkKernel kernel = nullptr;
+	switch (level) {
+		case ScannerSimd::Level::AVX512BW:
+			kernel = BasicKernels::getChunkKernelAVX512(dataType, scanType);
+			break;
+		case ScannerSimd::Level::AVX2:
+			kernel = BasicKernels::getChunkKernelAVX2(dataType, scanType);
+			break;
+		case ScannerSimd::Level::SSE2:
+			kernel = BasicKernels::getChunkKernelSSE2(dataType, scanType);
+			break;
+		case ScannerSimd::Level::SCALAR:
+		default:
+			break;
+	}
+
+	// Fall back to the specialized scalar kernel
+	if (kernel == nullptr) {
+		kernel = BasicKernels::getChunkKernelScalar(dataType, scanType);
+	}
+	return kernel;
+}
+
+BasicScanner::MaskKernel BasicScanner::selectMaskKernel(ScannerSimd::Level level, DataType dataType, ScanType scanType) {
+	// Masks are only built against a target
+	if (scanType != ScanType::EXACT && scanType != ScanType::NOT) {
+		return nullptr;
+	}
+
+	MaskKernel kernel = nullptr;
+	switch (level) {
+		case ScannerSimd::Level::AVX512BW:
+			kernel = BasicKernels::getMaskKernelAVX512(dataType, scanType);
+			break;
+		case ScannerSimd::Level::AVX2:
+			kernel = BasicKernels::getMaskKernelAVX2(dataType, scanType);
+			break;
+		case ScannerSimd::Level::SSE2:
+			kernel = BasicKernels::getMaskKernelSSE2(dataType, scanType);
+			break;
+		case ScannerSimd::Level::SCALAR:
+		default:
+			break;
+	}
+
+	// Fall back to the specialized scalar kernel
+	if (kernel == nullptr) {
+		kernel = BasicKernels::getMaskKernelScalar(dataType, scanType);
+	}
+	return kernel;
+}
+
+BasicScanner::RelativeMaskKernel BasicScanner::selectRelativeMaskKernel(DataType dataType, ScanType scanType) {
+	return BasicKernels::getRelativeMaskKernelScalar(dataType, scanType);
+}
+
+BasicScanner::RescanKernel BasicScanner::selectRescanKernel(ScannerSimd::Level level, DataType dataType, ScanType scanType) {
+	RescanKernel kernel = nullptr;
+	switch (level) {
+		case ScannerSimd::Level::AVX512BW:
+			kernel = BasicKernels::getRescanKernelAVX512(dataType, scanType);
+			break;
+		case ScannerSimd::Level::AVX2:
+			kernel = BasicKernels::getRescanKernelAVX2(dataType, scanType);
+			break;
+		case ScannerSimd::Level::SSE2:
+			kernel = BasicKernels::getRescanKernelSSE2(dataType, scanType);
+			break;
+		case ScannerSimd::Level::SCALAR:
+		default:
+			break;
+	}
+
+	// Fall back to the specialized scalar kernel
+	if (kernel == nullptr) {
+		kernel = BasicKernels::getRescanKernelScalar(dataType, scanType);
+	}
+	return kernel;
+}
+
+bool BasicScanner::setupScanCommon(ScanType scanType, const void* targetValue, size_t valueSize) {
+	// Keep our own copy of the target for the kernels
+	kernelParams.target.doubleValue = 0.0;
+	if (targetValue != nullptr) {
+		memcpy(&kernelParams.target, targetValue, getDataTypeSize());
+	}
+	kernelParams.alignment = alignment;
+	kernelParams.epsilon = epsilon;
+
+	// Select kernel once per scan based on the active SIMD tier
+	chunkKernel = selectChunkKernel(ScannerSimd::getLevel(), dataType, scanType);
+	rescanKernel = selectRescanKernel(ScannerSimd::getLevel(), dataType, scanType);
+	maskKernel = selectMaskKernel(ScannerSimd::getLevel(), dataType, scanType);
+	relativeMaskKernel = selectRelativeMaskKernel(dataType, scanType);
+	return true;
+}
+
 bool BasicScanner::compare(const void* a, const void* b, DataType type) {
+	return compare(a, b, type, getDefaultEpsilon(type));
+}
+
+// Float compares are done at the value's own precision so the vector kernels
+// can reproduce them exactly
+bool BasicScanner::compare(const void* a, const void* b, DataType type, double epsilon) {
 	switch (type) {
 		case DataType::BYTE:
 			return *(uint8_t*)a == *(uint8_t*)b;
 		case DataType::INT:
 			return *(int32_t*)a == *(int32_t*)b;
 		case DataType::FLOAT:
-			return std::abs(*(float*)a - *(float*)b) < FLOAT_EPSILON;
+			return std::abs(*(float*)a - *(float*)b) < (float)epsilon;
 		case DataType::DOUBLE:
-			return std::abs(*(double*)a - *(double*)b) < DOUBLE_EPSILON;
+			return std::abs(*(double*)a - *(double*)b) < epsilon;
 		case DataType::BOOL:
-			return *(bool*)a == *(bool*)b;
+			// Read as bytes since bytes other than 0/1 are undefined as bool
+			// Any non zero byte counts as true
+			return (*(uint8_t*)a != 0) == (*(uint8_t*)b != 0);
 		default:
 			return false;
 	}
@@ -70,11 +205,11 @@ bool BasicScanner::compareGreater(const void* a, const void* b) const {
 		case DataType::INT:
 			return *(int32_t*)a > *(int32_t*)b;
 		case DataType::FLOAT:
-			return *(float*)a > *(float*)b + FLOAT_EPSILON;
+			return *(float*)a > *(float*)b + (float)epsilon;
 		case DataType::DOUBLE:
-			return *(double*)a > *(double*)b + DOUBLE_EPSILON;
+			return *(double*)a > *(double*)b + epsilon;
 		case DataType::BOOL:
-			return *(bool*)a && !*(bool*)b;
+			return *(uint8_t*)a != 0 && *(uint8_t*)b == 0;
 		default:
 			return false;
 	}
@@ -87,11 +222,11 @@ bool BasicScanner::compareLess(const void* a, const void* b) const {
 		case DataType::INT:
 			return *(int32_t*)a < *(int32_t*)b;
 		case DataType::FLOAT:
-			return *(float*)a < *(float*)b - FLOAT_EPSILON;
+			return *(float*)a < *(float*)b - (float)epsilon;
 		case DataType::DOUBLE:
-			return *(double*)a < *(double*)b - DOUBLE_EPSILON;
+			return *(double*)a < *(double*)b - epsilon;
 		case DataType::BOOL:
-			return !*(bool*)a && *(bool*)b;
+			return *(uint8_t*)a == 0 && *(uint8_t*)b != 0;
 		default:
 			return false;
 	}
@@ -103,17 +238,17 @@ bool BasicScanner::checkMatch(const ScanResult& result, ScanType scanType, const
 
 	switch (scanType) {
 		case ScanType::EXACT:
-			return compare(currentValue, targetValue, dataType);
+			return compare(currentValue, targetValue, dataType, epsilon);
 		case ScanType::NOT:
-			return !compare(currentValue, targetValue, dataType);
+			return !compare(currentValue, targetValue, dataType, epsilon);
 		case ScanType::INCREASED:
 			return compareGreater(currentValue, oldValue);
 		case ScanType::DECREASED:
 			return compareLess(currentValue, oldValue);
 		case ScanType::CHANGED:
-			return !compare(currentValue, oldValue, dataType);
+			return !compare(currentValue, oldValue, dataType, epsilon);
 		case ScanType::UNCHANGED:
-			return compare(currentValue, oldValue, dataType);
+			return compare(currentValue, oldValue, dataType, epsilon);
 		default:
 			addError("Invalid scan type in checkMatch: %d", (int)scanType);
 			return false;
@@ -145,7 +280,7 @@ bool BasicScanner::readValueFromBuffer(const uint8_t* buffer, size_t bufferSize,
 			result.value.doubleValue = *(double*)addr;
 			break;
 		case DataType::BOOL:
-			result.value.boolValue = *(bool*)addr;
+			result.value.byteValue = *addr;
 			break;
 		default:
 			return false;
@@ -182,7 +317,7 @@ bool BasicScanner::readValueDirect(uintptr_t address, uintptr_t regionEnd, ScanR
 				result.value.doubleValue = *(double*)addr;
 				break;
 			case DataType::BOOL:
-				result.value.boolValue = *(bool*)addr;
+				result.value.byteValue = *(uint8_t*)addr;
 				break;
 			default:
 				return false;
@@ -208,6 +343,23 @@ bool BasicScanner::validateValueInBuffer(const uint8_t* buffer, size_t bufferSiz
 	return checkMatch(outResult, scanType, targetValue);
 }
 
+void BasicScanner::rescanResultBatch(const std::vector<ScanResult, ScannerAllocator<ScanResult>>& oldResults,
+                                      size_t batchStart, size_t batchEnd,
+                                      uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
+                                      ScanType scanType, const void* targetValue,
+                                      ResultStore& newResults) {
+	if (rescanKernel == nullptr) {
+		Scanner::rescanResultBatch(oldResults, batchStart, batchEnd, chunkStart, chunkSize, buffer,
+		                           scanType, targetValue, newResults);
+		return;
+	}
+
+	size_t invalidCount = 0;
+	rescanKernel(kernelParams, oldResults.data() + batchStart, batchEnd - batchStart,
+	             chunkStart, chunkSize, buffer, newResults, invalidCount);
+	invalidAddressCount += invalidCount;
+}
+
 bool BasicScanner::validateValueDirect(uintptr_t address, uintptr_t regionStart, uintptr_t regionEnd,
                                         ScanType scanType, const void* targetValue,
                                         ScanResult& outResult) const {
@@ -224,6 +376,12 @@ bool BasicScanner::validateValueDirect(uintptr_t address, uintptr_t regionStart,
 void BasicScanner::scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
                                       ScanType scanType, const void* targetValue,
                                       std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+	// Use the specialized kernel for this scan if one was selected
+	if (chunkKernel != nullptr) {
+		chunkKernel(kernelParams, buffer, chunkSize, chunkBase, localResults, maxLocalResults);
+		return;
+	}
+
 	const size_t dataSize = getDataTypeSize();
 	
 	// Find aligned starting offset
@@ -2,10 +2,16 @@
 #define SCANNER_BASIC_H
 
 #include "scanner_base.h"
+#include "scanner_simd.h"
+#include "scanner_bitmap.h"
+#include "scanner_snapshot.h"
+#include "scanner_write_watch.h"
 #include <windows.h>
 
 // Scanner implementation for basic types (INT, FLOAT, DOUBLE, BYTE, BOOL)
-// Uses basic alignment-based scanning for universal support
+// Uses alignment-based scanning. Chunk and rescan loops are dispatched to
+// kernels specialized per data type and scan type, vectorized for the active
+// SIMD tier where one is available
 class BasicScanner : public Scanner {
 public:
     // Data types
@@ -17,6 +23,33 @@ public:
     	BOOL
     };
 
+	// Per-scan parameters handed to the chunk kernels
+	struct KernelParams {
+		ScanValue target;
+		size_t alignment;
+		double epsilon;
+	};
+
+	// Chunk kernel - scans every aligned position in the buffer into local results
+	typedef void (*ChunkKernel)(const KernelParams& params, const uint8_t* buffer, size_t chunkSize,
+	                            uintptr_t chunkBase, std::vector<ScanResult>& localResults, size_t maxLocalResults);
+
+	// Mask kernel - sets the bit of every matching slot in words. chunkBase must
+	// be aligned so bit i is the slot i * alignment bytes into the buffer
+	typedef void (*MaskKernel)(const KernelParams& params, const uint8_t* buffer, size_t chunkSize,
+	                           uintptr_t chunkBase, uint64_t* words);
+
+	// Relative mask kernel - sets the bit of every slot whose value compares to
+	// the same slot of oldBuffer. Identical bytes always count as unchanged
+	typedef void (*RelativeMaskKernel)(const KernelParams& params, const uint8_t* buffer, const uint8_t* oldBuffer,
+	                                   size_t chunkSize, uint64_t* words);
+
+	// Rescan kernel - re-checks a batch of old results against a chunk buffer
+	// Non-matching and out of chunk results are added to invalidCount like the scalar path
+	typedef void (*RescanKernel)(const KernelParams& params, const ScanResult* oldResults, size_t count,
+	                             uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
+	                             ResultStore& newResults, size_t& invalidCount);
+
 	// Override new/delete to allocate from scanner heap
 	static void* operator new(size_t size);
 	static void operator delete(void* ptr) noexcept;
@@ -29,9 +62,72 @@ public:
 	DataType getDataType() const { return dataType; }
 
     static bool compare(const void* a, const void* b, DataType type);
+    static bool compare(const void* a, const void* b, DataType type, double epsilon);
     static size_t getDataTypeSize(DataType type);
 
+	// Tolerance used when comparing FLOAT/DOUBLE values. Ignored for other types
+	static double getDefaultEpsilon(DataType type);
+	double getEpsilon() const { return epsilon; }
+	bool setEpsilon(double newEpsilon);
+	void resetEpsilon() { epsilon = getDefaultEpsilon(dataType); }
+
+	// Pick the kernels for the given tier. Falls back to the specialized scalar
+	// kernels. Returns nullptr only if the combination has to use the generic path
+	static ChunkKernel selectChunkKernel(ScannerSimd::Level level, DataType dataType, ScanType scanType);
+	static RescanKernel selectRescanKernel(ScannerSimd::Level level, DataType dataType, ScanType scanType);
+	static MaskKernel selectMaskKernel(ScannerSimd::Level level, DataType dataType, ScanType scanType);
+	// Scalar only. Snapshot compares skip unchanged pages before reaching the kernel
+	static RelativeMaskKernel selectRelativeMaskKernel(DataType dataType, ScanType scanType);
+
+	// Bitmap results - first scans keep one bit per aligned slot instead of a
+	// result per match, so dense scans (NOT, BYTE/BOOL, value 0) are not capped
+	// by maxResults. Only EXACT and NOT run on a bitmap. Results switch to a
+	// list once a scan leaves few enough matches for the list to be smaller
+	void setBitmapResults(bool enabled) { bitmapRequested = enabled; }
+	bool getBitmapResults() const { return bitmapRequested; }
+	bool isBitmapMode() const { return bitmapMode; }
+	size_t getBitmapMemoryUsage() const { return bitmap.getMemoryUsage(); }
+
+	// UNKNOWN first scans always start as a bitmap of every slot plus a
+	// compressed snapshot of the scanned memory. Relative rescans compare
+	// against the snapshot and refresh it, and both are dropped once the
+	// results switch to a list
+	bool hasSnapshot() const { return !snapshot.empty(); }
+	size_t getSnapshotMemoryUsage() const { return snapshot.getMemoryUsage(); }
+
+	// Let UNKNOWN first scans track writes to MEM_WRITE_WATCH memory so
+	// relative rescans skip chunks nothing wrote to without reading them.
+	// Off by default since it resets the watch its owner may depend on
+	void setWriteWatch(bool enabled) { writeWatchRequested = enabled; }
+	bool getWriteWatch() const { return writeWatchRequested; }
+	size_t getWriteWatchRangeCount() const { return writeWatch.getTrackedRangeCount(); }
+
+	// Results [first, first + count) of a bitmap with values read from memory
+	void getBitmapPage(size_t first, size_t count, ResultStore& out) const;
+
+	virtual size_t getResultCount() const override { return bitmapMode ? bitmapCount : results.size(); }
+	virtual void reset() override;
+
 protected:
+	// Setup hook - captures the target and selects kernels for this scan
+	virtual bool setupScanCommon(ScanType scanType, const void* targetValue, size_t valueSize) override;
+	virtual bool supportsUnknownScan() const override { return true; }
+	virtual bool supportsStepScan() const override { return !bitmapRequested; }
+
+	// Bitmap aware scans. Fall back to the base list implementations
+	virtual void firstScanImpl(ScanType scanType, const void* targetValue, size_t valueSize) override;
+	virtual void rescanImpl(ScanType scanType, const void* targetValue, size_t valueSize) override;
+
+	// Enumerate regions and lay out an empty bitmap over them
+	bool prepareBitmap();
+	void firstScanBitmap();
+	// Run the mask kernel on the source memory. False if reading it faulted
+	bool maskChunkInPlace(uintptr_t chunkBase, size_t chunkSize, uint64_t* words);
+	void firstScanUnknown();
+	void rescanBitmap(ScanType scanType);
+	// Replace the bitmap with a result list if that takes less memory
+	void convertSparseBitmap();
+
 	// Chunk scanning - scans into local results vector
 	virtual void scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
 	                               ScanType scanType, const void* targetValue,
@@ -45,6 +141,11 @@ protected:
 	                                    uintptr_t actualAddress, ScanType scanType, const void* targetValue,
 	                                    ScanResult& outResult) const override;
 
+	// Batched rescan - dispatches to the rescan kernel if one was selected
+	virtual void rescanResultBatch(const std::vector<ScanResult, ScannerAllocator<ScanResult>>& oldResults, size_t batchStart, size_t batchEnd,
+	                               uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
+	                               ScanType scanType, const void* targetValue, ResultStore& newResults) override;
+
 	// pure virtual getters implementations
 	virtual size_t getDataTypeSize() const override;
 
@@ -63,6 +164,24 @@ protected:
 	bool readValueDirect(uintptr_t address, uintptr_t regionEnd, ScanResult& result) const;
 
 	DataType dataType;
+	double epsilon;
+
+	// Kernels selected for the current scan (nullptr = generic virtual path)
+	ChunkKernel chunkKernel;
+	RescanKernel rescanKernel;
+	MaskKernel maskKernel;
+	RelativeMaskKernel relativeMaskKernel;
+	KernelParams kernelParams;
+
+	// Bitmap results. bitmapCount is the number of set bits while in bitmap mode
+	bool bitmapRequested;
+	bool bitmapMode;
+	size_t bitmapCount;
+	ResultBitmap bitmap;
+	// Values at the last scan for relative bitmap rescans. Chunks match the bitmap's
+	MemorySnapshot snapshot;
+	bool writeWatchRequested;
+	WriteWatchTracker writeWatch;
 };
 
 #endif
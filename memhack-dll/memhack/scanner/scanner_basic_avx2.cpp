@@ -1,190 +1,224 @@
 #include "stdafx.h"
-#include "scanner_basic_avx2.h"
+#include "scanner_basic_kernels.h"
 #include <immintrin.h>  // AVX2 intrinsics
-#include <intrin.h>     // __cpuid
 
-BasicScannerAVX2::BasicScannerAVX2(DataType dataType, size_t maxResults, size_t alignment)
-	: BasicScanner(dataType, maxResults, alignment) {
-	// Nothing else needed
-}
+// AVX2 tier - 32 byte windows
+// Only called when ScannerSimd reports AVX2 support
+namespace {
+	const size_t AVX2_WIDTH = 32;
 
-BasicScannerAVX2::~BasicScannerAVX2() {}
+	struct Eq8 {
+		typedef uint8_t Value;
+		static const size_t WIDTH = AVX2_WIDTH;
+		static const size_t LANE = 1;
+		__m256i target;
 
-// Check if AVX2 is supported on this CPU
-bool BasicScannerAVX2::isAVX2Supported() {
-	int cpuInfo[4];
+		explicit Eq8(const BasicScanner::KernelParams& params) : target(_mm256_set1_epi8((char)params.target.byteValue)) {}
 
-	// CPUID function 0: Get maximum supported function number
-	__cpuid(cpuInfo, 0);
-	int maxFunctionId = cpuInfo[0];
+		uint64_t operator()(const uint8_t* p) const {
+			__m256i dataVec = _mm256_loadu_si256((const __m256i*)p);
+			return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(dataVec, target));
+		}
+	};
 
-	// AVX2 requires CPUID function 7
-	if (maxFunctionId < 7) {
-		return false;
-	}
+	// BOOL matches on truth, so any non zero byte equals a true target
+	struct EqBool {
+		typedef bool Value;
+		static const size_t WIDTH = AVX2_WIDTH;
+		static const size_t LANE = 1;
+		uint32_t flip;
 
-	// CPUID function 7, sub-leaf 0: Get extended features
-	__cpuidex(cpuInfo, 7, 0);
+		explicit EqBool(const BasicScanner::KernelParams& params) : flip(params.target.byteValue != 0 ? 0xFFFFFFFFu : 0) {}
 
-	// EBX register, bit 5 = AVX2 support
-	const int AVX2_BIT = 5;
-	return (cpuInfo[1] & (1 << AVX2_BIT)) != 0;
-}
+		uint64_t operator()(const uint8_t* p) const {
+			__m256i dataVec = _mm256_loadu_si256((const __m256i*)p);
+			uint32_t zero = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(dataVec, _mm256_setzero_si256()));
+			return zero ^ flip;
+		}
+	};
 
-// Find aligned starting offset
-size_t BasicScannerAVX2::findAlignedOffset(uintptr_t chunkBase) const {
-	uintptr_t firstAlignedAddr = chunkBase;
-	if (firstAlignedAddr % alignment != 0) {
-		firstAlignedAddr += alignment - (firstAlignedAddr % alignment);
-	}
-	return (firstAlignedAddr >= chunkBase) ? (firstAlignedAddr - chunkBase) : 0;
-}
+	struct Eq32 {
+		typedef int32_t Value;
+		static const size_t WIDTH = AVX2_WIDTH;
+		static const size_t LANE = 4;
+		__m256i target;
 
-// Get comparison mask for current chunk
-// Performs SIMD comparison and returns mask based on scan type
-// NOT scans invert the mask at SIMD level
-int BasicScannerAVX2::getComparisonMask(const uint8_t* buffer, ScanType scanType, const void* targetValue) {
-	int mask = 0;
-	bool invertMask = (scanType == ScanType::NOT);
+		explicit Eq32(const BasicScanner::KernelParams& params) : target(_mm256_set1_epi32(params.target.intValue)) {}
 
-	switch (dataType) {
-		case DataType::INT: {
-			int32_t target = *(const int32_t*)targetValue;
-			__m256i targetVec = _mm256_set1_epi32(target);
-			__m256i dataVec = _mm256_loadu_si256((const __m256i*)buffer);
-			__m256i cmpVec = _mm256_cmpeq_epi32(dataVec, targetVec);
-			if (invertMask) {
-				cmpVec = _mm256_xor_si256(cmpVec, _mm256_set1_epi32(-1));
-			}
-			mask = _mm256_movemask_epi8(cmpVec);
-			break;
+		uint64_t operator()(const uint8_t* p) const {
+			__m256i dataVec = _mm256_loadu_si256((const __m256i*)p);
+			// movemask gives 4 bits per lane, keep the one at the lane start
+			return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi32(dataVec, target)) & 0x11111111u;
+		}
+	};
+
+	// |data - target| < epsilon. Abs is done by clearing the sign bit
+	// Ordered compares so NaN never matches, same as the scalar <
+	struct EqF32 {
+		typedef float Value;
+		static const size_t WIDTH = AVX2_WIDTH;
+		static const size_t LANE = 4;
+		__m256 target;
+		__m256 epsilon;
+		__m256 absMask;
+
+		explicit EqF32(const BasicScanner::KernelParams& params) :
+			target(_mm256_set1_ps(params.target.floatValue)),
+			epsilon(_mm256_set1_ps((float)params.epsilon)),
+			absMask(_mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF))) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m256 diff = _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps((const float*)p), target), absMask);
+			__m256 cmpVec = _mm256_cmp_ps(diff, epsilon, _CMP_LT_OQ);
+			return (uint32_t)_mm256_movemask_epi8(_mm256_castps_si256(cmpVec)) & 0x11111111u;
+		}
+	};
+
+	struct EqF64 {
+		typedef double Value;
+		static const size_t WIDTH = AVX2_WIDTH;
+		static const size_t LANE = 8;
+		__m256d target;
+		__m256d epsilon;
+		__m256d absMask;
+
+		explicit EqF64(const BasicScanner::KernelParams& params) :
+			target(_mm256_set1_pd(params.target.doubleValue)),
+			epsilon(_mm256_set1_pd(params.epsilon)),
+			absMask(_mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL))) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m256d diff = _mm256_and_pd(_mm256_sub_pd(_mm256_loadu_pd((const double*)p), target), absMask);
+			__m256d cmpVec = _mm256_cmp_pd(diff, epsilon, _CMP_LT_OQ);
+			return (uint32_t)_mm256_movemask_epi8(_mm256_castpd_si256(cmpVec)) & 0x01010101u;
+		}
+	};
+
+	// Staged 32 bit lanes for rescans
+	struct Lanes32 {
+		typedef int32_t Lane;
+		static const size_t LANES = 8;
+
+		explicit Lanes32(const BasicScanner::KernelParams&) {}
+
+		uint32_t eq(const int32_t* a, const int32_t* b) const {
+			__m256i cmpVec = _mm256_cmpeq_epi32(_mm256_load_si256((const __m256i*)a), _mm256_load_si256((const __m256i*)b));
+			return (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(cmpVec));
 		}
-		case DataType::FLOAT: {
-			float target = *(const float*)targetValue;
-			__m256 targetVec = _mm256_set1_ps(target);
-			__m256 dataVec = _mm256_loadu_ps((const float*)buffer);
-			__m256 cmpVec = _mm256_cmp_ps(dataVec, targetVec, _CMP_EQ_OQ);
-			if (invertMask) {
-				__m256i cmpInt = _mm256_castps_si256(cmpVec);
-				__m256i notInt = _mm256_xor_si256(cmpInt, _mm256_set1_epi32(-1));
-				cmpVec = _mm256_castsi256_ps(notInt);
-			}
-			mask = _mm256_movemask_ps(cmpVec);
-			break;
+
+		uint32_t gt(const int32_t* a, const int32_t* b) const {
+			__m256i cmpVec = _mm256_cmpgt_epi32(_mm256_load_si256((const __m256i*)a), _mm256_load_si256((const __m256i*)b));
+			return (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(cmpVec));
 		}
-		case DataType::DOUBLE: {
-			double target = *(const double*)targetValue;
-			__m256d targetVec = _mm256_set1_pd(target);
-			__m256d dataVec = _mm256_loadu_pd((const double*)buffer);
-			__m256d cmpVec = _mm256_cmp_pd(dataVec, targetVec, _CMP_EQ_OQ);
-			if (invertMask) {
-				__m256i cmpInt = _mm256_castpd_si256(cmpVec);
-				__m256i notInt = _mm256_xor_si256(cmpInt, _mm256_set1_epi32(-1));
-				cmpVec = _mm256_castsi256_pd(notInt);
-			}
-			mask = _mm256_movemask_pd(cmpVec);
-			break;
+
+		uint32_t lt(const int32_t* a, const int32_t* b) const {
+			return gt(b, a);
 		}
-		case DataType::BYTE:
-		case DataType::BOOL: {
-			uint8_t target = *(const uint8_t*)targetValue;
-			__m256i targetVec = _mm256_set1_epi8((char)target);
-			__m256i dataVec = _mm256_loadu_si256((const __m256i*)buffer);
-			__m256i cmpVec = _mm256_cmpeq_epi8(dataVec, targetVec);
-			if (invertMask) {
-				cmpVec = _mm256_xor_si256(cmpVec, _mm256_set1_epi32(-1));
-			}
-			mask = _mm256_movemask_epi8(cmpVec);
-			break;
+	};
+
+	struct LanesF32 {
+		typedef float Lane;
+		static const size_t LANES = 8;
+		__m256 epsilon;
+		__m256 absMask;
+
+		explicit LanesF32(const BasicScanner::KernelParams& params) :
+			epsilon(_mm256_set1_ps((float)params.epsilon)),
+			absMask(_mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF))) {}
+
+		uint32_t eq(const float* a, const float* b) const {
+			__m256 diff = _mm256_and_ps(_mm256_sub_ps(_mm256_load_ps(a), _mm256_load_ps(b)), absMask);
+			return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(diff, epsilon, _CMP_LT_OQ));
 		}
-		default:
-			break;
-	}
 
-	return mask;
+		uint32_t gt(const float* a, const float* b) const {
+			__m256 bound = _mm256_add_ps(_mm256_load_ps(b), epsilon);
+			return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(_mm256_load_ps(a), bound, _CMP_GT_OQ));
+		}
+
+		uint32_t lt(const float* a, const float* b) const {
+			__m256 bound = _mm256_sub_ps(_mm256_load_ps(b), epsilon);
+			return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(_mm256_load_ps(a), bound, _CMP_LT_OQ));
+		}
+	};
+
+	struct LanesF64 {
+		typedef double Lane;
+		static const size_t LANES = 4;
+		__m256d epsilon;
+		__m256d absMask;
+
+		explicit LanesF64(const BasicScanner::KernelParams& params) :
+			epsilon(_mm256_set1_pd(params.epsilon)),
+			absMask(_mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL))) {}
+
+		uint32_t eq(const double* a, const double* b) const {
+			__m256d diff = _mm256_and_pd(_mm256_sub_pd(_mm256_load_pd(a), _mm256_load_pd(b)), absMask);
+			return (uint32_t)_mm256_movemask_pd(_mm256_cmp_pd(diff, epsilon, _CMP_LT_OQ));
+		}
+
+		uint32_t gt(const double* a, const double* b) const {
+			__m256d bound = _mm256_add_pd(_mm256_load_pd(b), epsilon);
+			return (uint32_t)_mm256_movemask_pd(_mm256_cmp_pd(_mm256_load_pd(a), bound, _CMP_GT_OQ));
+		}
+
+		uint32_t lt(const double* a, const double* b) const {
+			__m256d bound = _mm256_sub_pd(_mm256_load_pd(b), epsilon);
+			return (uint32_t)_mm256_movemask_pd(_mm256_cmp_pd(_mm256_load_pd(a), bound, _CMP_LT_OQ));
+		}
+	};
 }
 
-// Helper to check if a specific value in the mask matched
-// Mask interpretation varies by data type:
-// - INT/FLOAT: 4 bits per value (32 bits total for 8 values)
-// - DOUBLE: 1 bit per value (4 bits total for 4 values)
-// - BYTE/BOOL: 1 bit per value (32 bits total for 32 values)
-bool BasicScannerAVX2::isMatchInMask(int mask, size_t valueIndex, DataType type) const {
-	switch (type) {
-		case DataType::INT:
-		case DataType::FLOAT:
-			// 4 bits per value (each int/float is 4 bytes)
-			// All 4 bits must be set for a match
-			return ((mask >> (valueIndex * 4)) & 0xF) == 0xF;
-
-		case DataType::DOUBLE:
-			// 1 bit per value
-			return (mask & (1 << valueIndex)) != 0;
-
-		case DataType::BYTE:
-		case DataType::BOOL:
-			// 1 bit per value
-			return (mask & (1 << valueIndex)) != 0;
+BasicScanner::ChunkKernel BasicKernels::getChunkKernelAVX2(BasicScanner::DataType dataType, ScanType scanType) {
+	bool invert = (scanType == ScanType::NOT);
 
+	switch (dataType) {
+		case BasicScanner::DataType::BYTE:
+			return invert ? scanChunkVector<Eq8, true> : scanChunkVector<Eq8, false>;
+		case BasicScanner::DataType::BOOL:
+			return invert ? scanChunkVector<EqBool, true> : scanChunkVector<EqBool, false>;
+		case BasicScanner::DataType::INT:
+			return invert ? scanChunkVector<Eq32, true> : scanChunkVector<Eq32, false>;
+		case BasicScanner::DataType::FLOAT:
+			return invert ? scanChunkVector<EqF32, true> : scanChunkVector<EqF32, false>;
+		case BasicScanner::DataType::DOUBLE:
+			return invert ? scanChunkVector<EqF64, true> : scanChunkVector<EqF64, false>;
 		default:
-			return false;
+			return nullptr;
 	}
 }
 
-// Override chunk scanning with AVX2 dispatcher - scans into local results
-void BasicScannerAVX2::scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
-                                          ScanType scanType, const void* targetValue,
-                                          std::vector<ScanResult>& localResults, size_t maxLocalResults) {
-	// Use scalar path for non-EXACT/NOT scans
-	if (scanType != ScanType::EXACT && scanType != ScanType::NOT) {
-		BasicScanner::scanChunkInRegion(buffer, chunkSize, chunkBase, scanType, targetValue,
-		                                localResults, maxLocalResults);
-		return;
-	}
-	
-	const size_t avx2_stride = 32;
-	const size_t dataSize = getDataTypeSize();
-	size_t offset = findAlignedOffset(chunkBase);
-	
-	// AVX2 processing
-	while (offset + avx2_stride <= chunkSize && localResults.size() < maxLocalResults) {
-		int mask = getComparisonMask(buffer + offset, scanType, targetValue);
-		
-		if (mask != 0) {
-			size_t valuesPerChunk = avx2_stride / dataSize;
-			
-			for (size_t i = 0; i < valuesPerChunk; i++) {
-				size_t pos = offset + i * dataSize;
-				if (pos + dataSize <= chunkSize) {
-					if (isMatchInMask(mask, i, dataType)) {
-						uintptr_t actualAddress = chunkBase + pos;
-						ScanResult result;
-						if (readValueFromBuffer(buffer, chunkSize, pos, result, actualAddress)) {
-							localResults.push_back(result);
-							
-							if (localResults.size() >= maxLocalResults) {
-								return;
-							}
-						}
-					}
-				}
-			}
-		}
-		
-		offset += avx2_stride;
+BasicScanner::MaskKernel BasicKernels::getMaskKernelAVX2(BasicScanner::DataType dataType, ScanType scanType) {
+	bool invert = (scanType == ScanType::NOT);
+
+	switch (dataType) {
+		case BasicScanner::DataType::BYTE:
+			return invert ? scanChunkMaskVector<Eq8, true> : scanChunkMaskVector<Eq8, false>;
+		case BasicScanner::DataType::BOOL:
+			return invert ? scanChunkMaskVector<EqBool, true> : scanChunkMaskVector<EqBool, false>;
+		case BasicScanner::DataType::INT:
+			return invert ? scanChunkMaskVector<Eq32, true> : scanChunkMaskVector<Eq32, false>;
+		case BasicScanner::DataType::FLOAT:
+			return invert ? scanChunkMaskVector<EqF32, true> : scanChunkMaskVector<EqF32, false>;
+		case BasicScanner::DataType::DOUBLE:
+			return invert ? scanChunkMaskVector<EqF64, true> : scanChunkMaskVector<EqF64, false>;
+		default:
+			return nullptr;
 	}
-	
-	// Scalar remainder
-	while (offset + dataSize <= chunkSize && localResults.size() < maxLocalResults) {
-		uintptr_t actualAddress = chunkBase + offset;
-		
-		if (actualAddress % alignment == 0) {
-			ScanResult result;
-			if (validateValueInBuffer(buffer, chunkSize, offset, actualAddress, scanType, targetValue, result)) {
-				localResults.push_back(result);
-			}
-		}
-		
-		offset += alignment;
+}
+
+BasicScanner::RescanKernel BasicKernels::getRescanKernelAVX2(BasicScanner::DataType dataType, ScanType scanType) {
+	switch (dataType) {
+		case BasicScanner::DataType::BYTE:
+			return selectRescanVector<Lanes32, uint8_t>(scanType);
+		case BasicScanner::DataType::INT:
+			return selectRescanVector<Lanes32, int32_t>(scanType);
+		case BasicScanner::DataType::FLOAT:
+			return selectRescanVector<LanesF32, float>(scanType);
+		case BasicScanner::DataType::DOUBLE:
+			return selectRescanVector<LanesF64, double>(scanType);
+		default:
+			// BOOL relative compares stay scalar
+			return nullptr;
 	}
 }
@@ -0,0 +1,235 @@
+#include "stdafx.h"
+#include "scanner_basic_kernels.h"
+#include <immintrin.h>  // AVX-512 intrinsics
+
+// AVX-512BW tier - 64 byte windows
+// Compares produce k-masks directly. Lane masks are expanded back to byte
+// positions so the shared loops can treat every tier the same
+namespace {
+	const size_t AVX512_WIDTH = 64;
+
+	// Expand a k-mask of 32 bit lanes to a bit at the first byte of each lane
+	inline uint64_t expandLanes32(__mmask16 laneMask) {
+		__m512i firstBytes = _mm512_maskz_mov_epi32(laneMask, _mm512_set1_epi32(1));
+		return _mm512_test_epi8_mask(firstBytes, firstBytes);
+	}
+
+	// Expand a k-mask of 64 bit lanes to a bit at the first byte of each lane
+	inline uint64_t expandLanes64(__mmask8 laneMask) {
+		__m512i firstBytes = _mm512_maskz_mov_epi64(laneMask, _mm512_set1_epi64(1));
+		return _mm512_test_epi8_mask(firstBytes, firstBytes);
+	}
+
+	struct Eq8 {
+		typedef uint8_t Value;
+		static const size_t WIDTH = AVX512_WIDTH;
+		static const size_t LANE = 1;
+		__m512i target;
+
+		explicit Eq8(const BasicScanner::KernelParams& params) : target(_mm512_set1_epi8((char)params.target.byteValue)) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m512i dataVec = _mm512_loadu_si512((const void*)p);
+			return _mm512_cmpeq_epi8_mask(dataVec, target);
+		}
+	};
+
+	// BOOL matches on truth, so any non zero byte equals a true target
+	struct EqBool {
+		typedef bool Value;
+		static const size_t WIDTH = AVX512_WIDTH;
+		static const size_t LANE = 1;
+		bool target;
+
+		explicit EqBool(const BasicScanner::KernelParams& params) : target(params.target.byteValue != 0) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m512i dataVec = _mm512_loadu_si512((const void*)p);
+			return target ? _mm512_test_epi8_mask(dataVec, dataVec) : _mm512_testn_epi8_mask(dataVec, dataVec);
+		}
+	};
+
+	struct Eq32 {
+		typedef int32_t Value;
+		static const size_t WIDTH = AVX512_WIDTH;
+		static const size_t LANE = 4;
+		__m512i target;
+
+		explicit Eq32(const BasicScanner::KernelParams& params) : target(_mm512_set1_epi32(params.target.intValue)) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m512i dataVec = _mm512_loadu_si512((const void*)p);
+			return expandLanes32(_mm512_cmpeq_epi32_mask(dataVec, target));
+		}
+	};
+
+	// |data - target| < epsilon. Abs clears the sign bit with an integer and
+	// since the float and/andnot forms need AVX-512DQ
+	struct EqF32 {
+		typedef float Value;
+		static const size_t WIDTH = AVX512_WIDTH;
+		static const size_t LANE = 4;
+		__m512 target;
+		__m512 epsilon;
+		__m512i absMask;
+
+		explicit EqF32(const BasicScanner::KernelParams& params) :
+			target(_mm512_set1_ps(params.target.floatValue)),
+			epsilon(_mm512_set1_ps((float)params.epsilon)),
+			absMask(_mm512_set1_epi32(0x7FFFFFFF)) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m512 diff = _mm512_sub_ps(_mm512_loadu_ps((const void*)p), target);
+			diff = _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(diff), absMask));
+			return expandLanes32(_mm512_cmp_ps_mask(diff, epsilon, _CMP_LT_OQ));
+		}
+	};
+
+	struct EqF64 {
+		typedef double Value;
+		static const size_t WIDTH = AVX512_WIDTH;
+		static const size_t LANE = 8;
+		__m512d target;
+		__m512d epsilon;
+		__m512i absMask;
+
+		explicit EqF64(const BasicScanner::KernelParams& params) :
+			target(_mm512_set1_pd(params.target.doubleValue)),
+			epsilon(_mm512_set1_pd(params.epsilon)),
+			absMask(_mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL)) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m512d diff = _mm512_sub_pd(_mm512_loadu_pd((const void*)p), target);
+			diff = _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(diff), absMask));
+			return expandLanes64(_mm512_cmp_pd_mask(diff, epsilon, _CMP_LT_OQ));
+		}
+	};
+
+	// Staged 32 bit lanes for rescans
+	struct Lanes32 {
+		typedef int32_t Lane;
+		static const size_t LANES = 16;
+
+		explicit Lanes32(const BasicScanner::KernelParams&) {}
+
+		uint32_t eq(const int32_t* a, const int32_t* b) const {
+			return _mm512_cmpeq_epi32_mask(_mm512_load_si512((const void*)a), _mm512_load_si512((const void*)b));
+		}
+
+		uint32_t gt(const int32_t* a, const int32_t* b) const {
+			return _mm512_cmpgt_epi32_mask(_mm512_load_si512((const void*)a), _mm512_load_si512((const void*)b));
+		}
+
+		uint32_t lt(const int32_t* a, const int32_t* b) const {
+			return gt(b, a);
+		}
+	};
+
+	struct LanesF32 {
+		typedef float Lane;
+		static const size_t LANES = 16;
+		__m512 epsilon;
+		__m512i absMask;
+
+		explicit LanesF32(const BasicScanner::KernelParams& params) :
+			epsilon(_mm512_set1_ps((float)params.epsilon)),
+			absMask(_mm512_set1_epi32(0x7FFFFFFF)) {}
+
+		uint32_t eq(const float* a, const float* b) const {
+			__m512 diff = _mm512_sub_ps(_mm512_load_ps(a), _mm512_load_ps(b));
+			diff = _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(diff), absMask));
+			return _mm512_cmp_ps_mask(diff, epsilon, _CMP_LT_OQ);
+		}
+
+		uint32_t gt(const float* a, const float* b) const {
+			__m512 bound = _mm512_add_ps(_mm512_load_ps(b), epsilon);
+			return _mm512_cmp_ps_mask(_mm512_load_ps(a), bound, _CMP_GT_OQ);
+		}
+
+		uint32_t lt(const float* a, const float* b) const {
+			__m512 bound = _mm512_sub_ps(_mm512_load_ps(b), epsilon);
+			return _mm512_cmp_ps_mask(_mm512_load_ps(a), bound, _CMP_LT_OQ);
+		}
+	};
+
+	struct LanesF64 {
+		typedef double Lane;
+		static const size_t LANES = 8;
+		__m512d epsilon;
+		__m512i absMask;
+
+		explicit LanesF64(const BasicScanner::KernelParams& params) :
+			epsilon(_mm512_set1_pd(params.epsilon)),
+			absMask(_mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL)) {}
+
+		uint32_t eq(const double* a, const double* b) const {
+			__m512d diff = _mm512_sub_pd(_mm512_load_pd(a), _mm512_load_pd(b));
+			diff = _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(diff), absMask));
+			return _mm512_cmp_pd_mask(diff, epsilon, _CMP_LT_OQ);
+		}
+
+		uint32_t gt(const double* a, const double* b) const {
+			__m512d bound = _mm512_add_pd(_mm512_load_pd(b), epsilon);
+			return _mm512_cmp_pd_mask(_mm512_load_pd(a), bound, _CMP_GT_OQ);
+		}
+
+		uint32_t lt(const double* a, const double* b) const {
+			__m512d bound = _mm512_sub_pd(_mm512_load_pd(b), epsilon);
+			return _mm512_cmp_pd_mask(_mm512_load_pd(a), bound, _CMP_LT_OQ);
+		}
+	};
+}
+
+BasicScanner::ChunkKernel BasicKernels::getChunkKernelAVX512(BasicScanner::DataType dataType, ScanType scanType) {
+	bool invert = (scanType == ScanType::NOT);
+
+	switch (dataType) {
+		case BasicScanner::DataType::BYTE:
+			return invert ? scanChunkVector<Eq8, true> : scanChunkVector<Eq8, false>;
+		case BasicScanner::DataType::BOOL:
+			return invert ? scanChunkVector<EqBool, true> : scanChunkVector<EqBool, false>;
+		case BasicScanner::DataType::INT:
+			return invert ? scanChunkVector<Eq32, true> : scanChunkVector<Eq32, false>;
+		case BasicScanner::DataType::FLOAT:
+			return invert ? scanChunkVector<EqF32, true> : scanChunkVector<EqF32, false>;
+		case BasicScanner::DataType::DOUBLE:
+			return invert ? scanChunkVector<EqF64, true> : scanChunkVector<EqF64, false>;
+		default:
+			return nullptr;
+	}
+}
+
+BasicScanner::MaskKernel BasicKernels::getMaskKernelAVX512(BasicScanner::DataType dataType, ScanType scanType) {
+	bool invert = (scanType == ScanType::NOT);
+
+	switch (dataType) {
+		case BasicScanner::DataType::BYTE:
+			return invert ? scanChunkMaskVector<Eq8, true> : scanChunkMaskVector<Eq8, false>;
+		case BasicScanner::DataType::BOOL:
+			return invert ? scanChunkMaskVector<EqBool, true> : scanChunkMaskVector<EqBool, false>;
+		case BasicScanner::DataType::INT:
+			return invert ? scanChunkMaskVector<Eq32, true> : scanChunkMaskVector<Eq32, false>;
+		case BasicScanner::DataType::FLOAT:
+			return invert ? scanChunkMaskVector<EqF32, true> : scanChunkMaskVector<EqF32, false>;
+		case BasicScanner::DataType::DOUBLE:
+			return invert ? scanChunkMaskVector<EqF64, true> : scanChunkMaskVector<EqF64, false>;
+		default:
+			return nullptr;
+	}
+}
+
+BasicScanner::RescanKernel BasicKernels::getRescanKernelAVX512(BasicScanner::DataType dataType, ScanType scanType) {
+	switch (dataType) {
+		case BasicScanner::DataType::BYTE:
+			return selectRescanVector<Lanes32, uint8_t>(scanType);
+		case BasicScanner::DataType::INT:
+			return selectRescanVector<Lanes32, int32_t>(scanType);
+		case BasicScanner::DataType::FLOAT:
+			return selectRescanVector<LanesF32, float>(scanType);
+		case BasicScanner::DataType::DOUBLE:
+			return selectRescanVector<LanesF64, double>(scanType);
+		default:
+			// BOOL relative compares stay scalar
+			return nullptr;
+	}
+}
@@ -0,0 +1,409 @@
+#include "stdafx.h"
+#include "scanner_basic.h"
+#include "scanner_basic_kernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <windows.h>
+#include <omp.h>
+
+// Bitmap results for BasicScanner
+// Chunks cover whole bitmap words, so threads write their chunk's words
+// and snapshot chunk directly without locking
+
+void BasicScanner::reset() {
+	Scanner::reset();
+	bitmap.clear();
+	snapshot.clear();
+	writeWatch.clear();
+	bitmapMode = false;
+	bitmapCount = 0;
+}
+
+void BasicScanner::firstScanImpl(ScanType scanType, const void* targetValue, size_t valueSize) {
+	bitmap.clear();
+	snapshot.clear();
+	writeWatch.clear();
+	bitmapMode = false;
+	bitmapCount = 0;
+
+	if (scanType == ScanType::UNKNOWN) {
+		firstScanUnknown();
+	} else if (bitmapRequested) {
+		firstScanBitmap();
+	} else {
+		Scanner::firstScanImpl(scanType, targetValue, valueSize);
+	}
+}
+
+void BasicScanner::rescanImpl(ScanType scanType, const void* targetValue, size_t valueSize) {
+	if (bitmapMode) {
+		rescanBitmap(scanType);
+	} else {
+		Scanner::rescanImpl(scanType, targetValue, valueSize);
+	}
+}
+
+bool BasicScanner::prepareBitmap() {
+	if (alignment > BITMAP_MAX_ALIGNMENT) {
+		addError("Bitmap results need an alignment of at most %zu (got %zu)", BITMAP_MAX_ALIGNMENT, alignment);
+		return false;
+	}
+
+	std::vector<MemoryRegion> regions = enumerateSafeRegions();
+	if (regions.empty()) {
+		addError("No scannable memory regions found");
+		return false;
+	}
+
+	uint64_t totalBytes = 0;
+	for (const MemoryRegion& region : regions) {
+		totalBytes += region.size;
+	}
+	resetProgress(totalBytes, true);
+
+	// Check the size before allocating anything
+	const size_t dataSize = getDataTypeSize();
+	size_t wordCount = 0;
+	for (const MemoryRegion& region : regions) {
+		wordCount += (ResultBitmap::countSlots(region.base, region.size, alignment, dataSize) + 63) / 64;
+	}
+	if (wordCount > BITMAP_MAX_BYTES / sizeof(uint64_t)) {
+		addError("Bitmap results would take %zu MB, more than the %zu MB limit. Use a larger alignment or narrower region filter",
+		         wordCount * sizeof(uint64_t) / (1024 * 1024), BITMAP_MAX_BYTES / (1024 * 1024));
+		return false;
+	}
+
+	bitmap.reset(alignment, dataSize);
+	bitmap.reserve(regions.size(), wordCount);
+	for (const MemoryRegion& region : regions) {
+		bitmap.addRegion(region.base, region.size);
+	}
+	return true;
+}
+
+void BasicScanner::firstScanBitmap() {
+	if (maskKernel == nullptr) {
+		addError("Bitmap results only support EXACT and NOT scans");
+		return;
+	}
+
+	if (!prepareBitmap()) {
+		return;
+	}
+
+	std::vector<BitmapChunk, ScannerAllocator<BitmapChunk>> chunks;
+	bitmap.splitChunks(chunks);
+
+	#pragma omp parallel
+	{
+		// Thread-local buffer (NOT on scanner heap - avoids contention)
+		std::vector<uint8_t> localBuffer(SCAN_BUFFER_SIZE + sizeof(ScanValue));
+
+		#pragma omp for schedule(dynamic, 16)
+		for (int i = 0; i < (int)chunks.size(); i++) {
+			if (isCancelled()) {
+				continue;
+			}
+
+			const BitmapChunk& chunk = chunks[i];
+			uintptr_t chunkBase = bitmap.getChunkBase(chunk);
+			size_t chunkSize = bitmap.getChunkSize(chunk);
+			uint64_t* words = bitmap.getChunkWords(chunk);
+			addProgress(chunkSize);
+
+			if (inPlaceScan && maskChunkInPlace(chunkBase, chunkSize, words)) {
+				continue;
+			}
+
+			// Bits set before a fault are cleared and the chunk is copied.
+			// Unreadable chunks keep their bits cleared
+			std::fill(words, words + ResultBitmap::getChunkWordCount(chunk), 0);
+			if (!safeCopyMemory(localBuffer.data(), (const void*)chunkBase, chunkSize)) {
+				continue;
+			}
+			maskKernel(kernelParams, localBuffer.data(), chunkSize, chunkBase, words);
+		}
+	}
+
+	if (isCancelled()) {
+		scanCancelled = true;
+		return;
+	}
+
+	bitmapMode = true;
+	bitmapCount = bitmap.countSet();
+	resultsSorted = true;
+	convertSparseBitmap();
+}
+
+// The mask kernels only read inside the chunk like the list kernels
+bool BasicScanner::maskChunkInPlace(uintptr_t chunkBase, size_t chunkSize, uint64_t* words) {
+	__try {
+		maskKernel(kernelParams, (const uint8_t*)chunkBase, chunkSize, chunkBase, words);
+		return true;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER) {
+		return false;
+	}
+}
+
+// Every slot starts as a candidate and the snapshot keeps the values for
+// the first relative rescan
+void BasicScanner::firstScanUnknown() {
+	if (!prepareBitmap()) {
+		return;
+	}
+	bitmap.setAll();
+
+	// Watches are reset before the memory is read so no write is missed
+	if (writeWatchRequested) {
+		for (const BitmapRegion& region : bitmap.getRegions()) {
+			writeWatch.track(region.base, bitmap.getRegionSize(region));
+		}
+	}
+
+	std::vector<BitmapChunk, ScannerAllocator<BitmapChunk>> chunks;
+	bitmap.splitChunks(chunks);
+	snapshot.reset(chunks.size());
+	std::atomic<bool> overLimit(false);
+
+	#pragma omp parallel
+	{
+		std::vector<uint8_t> localBuffer(SCAN_BUFFER_SIZE + sizeof(ScanValue));
+		std::vector<uint64_t> scratch;
+
+		#pragma omp for schedule(dynamic, 16)
+		for (int i = 0; i < (int)chunks.size(); i++) {
+			if (overLimit.load(std::memory_order_relaxed) || isCancelled()) {
+				continue;
+			}
+
+			const BitmapChunk& chunk = chunks[i];
+			uintptr_t chunkBase = bitmap.getChunkBase(chunk);
+			size_t chunkSize = bitmap.getChunkSize(chunk);
+			addProgress(chunkSize);
+
+			if (!safeCopyMemory(localBuffer.data(), (const void*)chunkBase, chunkSize)) {
+				uint64_t* words = bitmap.getChunkWords(chunk);
+				std::fill(words, words + ResultBitmap::getChunkWordCount(chunk), 0);
+				continue;
+			}
+			snapshot.store(i, localBuffer.data(), chunkSize, scratch);
+
+			if (snapshot.getMemoryUsage() > SNAPSHOT_MAX_BYTES) {
+				overLimit = true;
+			}
+		}
+	}
+
+	if (overLimit) {
+		addError("Snapshot exceeds the %zu MB limit. Use a region filter or scan ranges to scan less memory",
+		         SNAPSHOT_MAX_BYTES / (1024 * 1024));
+		bitmap.clear();
+		snapshot.clear();
+		writeWatch.clear();
+		return;
+	}
+
+	if (isCancelled()) {
+		scanCancelled = true;
+		return;
+	}
+
+	bitmapMode = true;
+	bitmapCount = bitmap.countSet();
+	resultsSorted = true;
+	convertSparseBitmap();
+}
+
+// AND each chunk's bits with a fresh match mask. EXACT and NOT compare
+// against the target and relative scans against the snapshot, which is
+// then moved forward to the current values. Chunks with no bits left are
+// not read again and their snapshot is freed
+// Bits are cleared in place so the rescan can't be cancelled part way
+void BasicScanner::rescanBitmap(ScanType scanType) {
+	const bool relative = (scanType != ScanType::EXACT && scanType != ScanType::NOT);
+	if (relative && snapshot.empty()) {
+		addError("Relative rescans of bitmap results need an UNKNOWN first scan. Narrow them with EXACT or NOT until they switch to a list");
+		return;
+	}
+	if (relative ? relativeMaskKernel == nullptr : maskKernel == nullptr) {
+		addError("Scan type %d is not supported on bitmap results", (int)scanType);
+		return;
+	}
+
+	std::vector<BitmapChunk, ScannerAllocator<BitmapChunk>> chunks;
+	bitmap.splitChunks(chunks);
+	const bool keepSnapshot = !snapshot.empty();
+
+	// New write watch generation before any chunk is read
+	if (!writeWatch.empty()) {
+		writeWatch.refresh();
+	}
+
+	#pragma omp parallel
+	{
+		std::vector<uint8_t> localBuffer(SCAN_BUFFER_SIZE + sizeof(ScanValue));
+		std::vector<uint8_t> oldBuffer(relative ? SCAN_BUFFER_SIZE + sizeof(ScanValue) : 0);
+		std::vector<uint64_t> freshWords(SCAN_BUFFER_SIZE / 64 + 1);
+		std::vector<uint64_t> scratch;
+		size_t localDropped = 0;
+
+		#pragma omp for schedule(dynamic, 16)
+		for (int i = 0; i < (int)chunks.size(); i++) {
+			const BitmapChunk& chunk = chunks[i];
+			uint64_t* words = bitmap.getChunkWords(chunk);
+			const size_t wordCount = ResultBitmap::getChunkWordCount(chunk);
+
+			size_t before = 0;
+			for (size_t w = 0; w < wordCount; w++) {
+				before += countBits(words[w]);
+			}
+			if (before == 0) {
+				continue;
+			}
+			addProgress(before);
+
+			uintptr_t chunkBase = bitmap.getChunkBase(chunk);
+			size_t chunkSize = bitmap.getChunkSize(chunk);
+
+			// Nothing wrote to the chunk so its snapshot is still current
+			// and it is settled like a chunk whose hashes all match
+			if (relative && writeWatch.isClean(chunkBase, chunkSize)) {
+				if (scanType != ScanType::UNCHANGED) {
+					std::fill(words, words + wordCount, 0);
+					localDropped += before;
+					snapshot.release(i);
+				}
+				continue;
+			}
+
+			if (!safeCopyMemory(localBuffer.data(), (const void*)chunkBase, chunkSize)) {
+				std::fill(words, words + wordCount, 0);
+				localDropped += before;
+				if (keepSnapshot) {
+					snapshot.release(i);
+				}
+				continue;
+			}
+
+			std::fill(freshWords.begin(), freshWords.begin() + wordCount, 0);
+			if (relative) {
+				// Nothing changed means nothing but UNCHANGED can match, and
+				// the snapshot already holds these values
+				if (snapshot.restore(i, localBuffer.data(), chunkSize, oldBuffer.data()) == 0) {
+					if (scanType != ScanType::UNCHANGED) {
+						std::fill(words, words + wordCount, 0);
+						localDropped += before;
+						snapshot.release(i);
+					}
+					continue;
+				}
+				relativeMaskKernel(kernelParams, localBuffer.data(), oldBuffer.data(), chunkSize, freshWords.data());
+			} else {
+				maskKernel(kernelParams, localBuffer.data(), chunkSize, chunkBase, freshWords.data());
+			}
+
+			size_t after = 0;
+			for (size_t w = 0; w < wordCount; w++) {
+				words[w] &= freshWords[w];
+				after += countBits(words[w]);
+			}
+			localDropped += before - after;
+
+			if (keepSnapshot) {
+				if (after == 0) {
+					snapshot.release(i);
+				} else {
+					snapshot.store(i, localBuffer.data(), chunkSize, scratch);
+				}
+			}
+		}
+
+		invalidAddressCount += localDropped;
+	}
+
+	bitmapCount = bitmap.countSet();
+	convertSparseBitmap();
+}
+
+void BasicScanner::convertSparseBitmap() {
+	// The snapshot goes with the bitmap so it counts towards the break even
+	const size_t storedValueSize = getStoredValueSize();
+	if (bitmapCount > maxResults ||
+	    bitmapCount * (sizeof(uintptr_t) + storedValueSize) >= bitmap.getMemoryUsage() + snapshot.getMemoryUsage()) {
+		return;
+	}
+
+	// Values are read per chunk like a list first scan would have stored them
+	ResultStore list(storedValueSize, false);
+	list.reserve(bitmapCount);
+
+	std::vector<BitmapChunk, ScannerAllocator<BitmapChunk>> chunks;
+	bitmap.splitChunks(chunks);
+	std::vector<uint8_t, ScannerAllocator<uint8_t>> buffer(SCAN_BUFFER_SIZE + sizeof(ScanValue));
+	size_t dropped = 0;
+
+	for (const BitmapChunk& chunk : chunks) {
+		const uint64_t* words = bitmap.getChunkWords(chunk);
+		const size_t wordCount = ResultBitmap::getChunkWordCount(chunk);
+
+		size_t setCount = 0;
+		for (size_t w = 0; w < wordCount; w++) {
+			setCount += countBits(words[w]);
+		}
+		if (setCount == 0) {
+			continue;
+		}
+
+		uintptr_t chunkBase = bitmap.getChunkBase(chunk);
+		if (!safeCopyMemory(buffer.data(), (const void*)chunkBase, bitmap.getChunkSize(chunk))) {
+			dropped += setCount;
+			continue;
+		}
+
+		for (size_t w = 0; w < wordCount; w++) {
+			uint64_t word = words[w];
+			while (word != 0) {
+				size_t slot = w * 64 + BasicKernels::lowestSetBit(word);
+				word &= word - 1;
+
+				ScanResult result;
+				result.address = chunkBase + slot * alignment;
+				memcpy(&result.value, buffer.data() + slot * alignment, getDataTypeSize());
+				list.push_back(result);
+			}
+		}
+	}
+
+	invalidAddressCount += dropped;
+	results = std::move(list);
+	resultsSorted = true;
+	bitmap.clear();
+	snapshot.clear();
+	writeWatch.clear();
+	bitmapMode = false;
+	bitmapCount = 0;
+}
+
+void BasicScanner::getBitmapPage(size_t first, size_t count, ResultStore& out) const {
+	out = ResultStore(getStoredValueSize(), false);
+	if (!bitmapMode) {
+		return;
+	}
+
+	std::vector<uintptr_t, ScannerAllocator<uintptr_t>> addresses;
+	bitmap.getAddresses(first, count, addresses);
+	out.reserve(addresses.size());
+
+	// Memory that can no longer be read is listed with a zero value
+	for (uintptr_t address : addresses) {
+		ScanResult result;
+		if (!readValueDirect(address, address + getDataTypeSize(), result)) {
+			result = ScanResult();
+			result.address = address;
+		}
+		out.push_back(result);
+	}
+}
@@ -0,0 +1,359 @@
+#ifndef SCANNER_BASIC_KERNELS_H
+#define SCANNER_BASIC_KERNELS_H
+
+#include "scanner_basic.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <intrin.h>
+
+// Vectorized kernels for BasicScanner
+// Each SIMD tier lives in its own translation unit and only provides compare
+// functors. The shared loops below turn their masks into results so every
+// tier reports identically
+//
+// Chunk (first scan) compares load WIDTH bytes and return a byte position mask
+// with a bit set at the start of each lane that matched
+//
+// Rescan compares work on LANES staged values and return one bit per lane
+//
+// FLOAT/DOUBLE compares use the same operations as BasicScanner::compare
+// (|a-b| < eps, a > b + eps, a < b - eps) at the value's own precision so the
+// vector and scalar paths report identical results
+namespace BasicKernels {
+	// Tier lookups. Return nullptr if the tier has no kernel for the type
+	BasicScanner::ChunkKernel getChunkKernelScalar(BasicScanner::DataType dataType, ScanType scanType);
+	BasicScanner::ChunkKernel getChunkKernelSSE2(BasicScanner::DataType dataType, ScanType scanType);
+	BasicScanner::ChunkKernel getChunkKernelAVX2(BasicScanner::DataType dataType, ScanType scanType);
+	BasicScanner::ChunkKernel getChunkKernelAVX512(BasicScanner::DataType dataType, ScanType scanType);
+
+	BasicScanner::MaskKernel getMaskKernelScalar(BasicScanner::DataType dataType, ScanType scanType);
+	BasicScanner::MaskKernel getMaskKernelSSE2(BasicScanner::DataType dataType, ScanType scanType);
+	BasicScanner::MaskKernel getMaskKernelAVX2(BasicScanner::DataType dataType, ScanType scanType);
+	BasicScanner::MaskKernel getMaskKernelAVX512(BasicScanner::DataType dataType, ScanType scanType);
+
+	BasicScanner::RelativeMaskKernel getRelativeMaskKernelScalar(BasicScanner::DataType dataType, ScanType scanType);
+
+	BasicScanner::RescanKernel getRescanKernelScalar(BasicScanner::DataType dataType, ScanType scanType);
+	BasicScanner::RescanKernel getRescanKernelSSE2(BasicScanner::DataType dataType, ScanType scanType);
+	BasicScanner::RescanKernel getRescanKernelAVX2(BasicScanner::DataType dataType, ScanType scanType);
+	BasicScanner::RescanKernel getRescanKernelAVX512(BasicScanner::DataType dataType, ScanType scanType);
+
+	// Index of the lowest set bit. Done in halves since _BitScanForward64 is x64 only
+	inline unsigned long lowestSetBit(uint64_t mask) {
+		unsigned long index;
+		if ((uint32_t)mask != 0) {
+			_BitScanForward(&index, (uint32_t)mask);
+		} else {
+			_BitScanForward(&index, (uint32_t)(mask >> 32));
+			index += 32;
+		}
+		return index;
+	}
+
+	// Mask with a bit at each candidate position in a window whose start is
+	// residue bytes past an aligned position
+	inline uint64_t candidateMask(size_t alignment, size_t residue, size_t width) {
+		uint64_t mask = 0;
+		for (size_t i = (alignment - residue) % alignment; i < width; i += alignment) {
+			mask |= 1ULL << i;
+		}
+		return mask;
+	}
+
+	inline size_t greatestCommonDivisor(size_t a, size_t b) {
+		while (b != 0) {
+			size_t rem = a % b;
+			a = b;
+			b = rem;
+		}
+		return a;
+	}
+
+	// Offset of the first aligned address in the chunk
+	inline size_t firstAlignedOffset(uintptr_t chunkBase, size_t alignment) {
+		size_t misalignment = chunkBase % alignment;
+		return misalignment == 0 ? 0 : alignment - misalignment;
+	}
+
+	// Scalar equality for chunk remainders. Matches BasicScanner::compare
+	template<typename T>
+	inline bool scalarEquals(const BasicScanner::KernelParams& params, const uint8_t* p) {
+		return memcmp(p, &params.target, sizeof(T)) == 0;
+	}
+
+	template<>
+	inline bool scalarEquals<float>(const BasicScanner::KernelParams& params, const uint8_t* p) {
+		float value;
+		memcpy(&value, p, sizeof(float));
+		return std::abs(value - params.target.floatValue) < (float)params.epsilon;
+	}
+
+	// BOOL compares truth, not the raw byte
+	template<>
+	inline bool scalarEquals<bool>(const BasicScanner::KernelParams& params, const uint8_t* p) {
+		return (*p != 0) == (params.target.byteValue != 0);
+	}
+
+	template<>
+	inline bool scalarEquals<double>(const BasicScanner::KernelParams& params, const uint8_t* p) {
+		double value;
+		memcpy(&value, p, sizeof(double));
+		return std::abs(value - params.target.doubleValue) < params.epsilon;
+	}
+
+	// Shared EXACT/NOT loop. Cmp provides WIDTH, LANE, the Value type and the compare
+	//
+	// Any alignment is handled. A compare only tests positions one lane apart, so
+	// for alignments that are not a multiple of the lane size the window is
+	// compared once per phase (load shifted by 1..LANE-1 bytes) and the phase
+	// masks are merged. The merged mask is then limited to the candidate
+	// positions, which also covers alignments larger than the lane
+	template<typename Cmp, bool INVERT>
+	void scanChunkVector(const BasicScanner::KernelParams& params, const uint8_t* buffer, size_t chunkSize,
+	                     uintptr_t chunkBase, std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+		const size_t width = Cmp::WIDTH;
+		const size_t laneSize = Cmp::LANE;
+		const size_t alignment = params.alignment;
+		const Cmp cmp(params);
+
+		size_t offset = firstAlignedOffset(chunkBase, alignment);
+
+		// Vector body - only worth it while a window holds more than one candidate
+		if (alignment <= width) {
+			// Candidates relative to the window start fall on multiples of the
+			// gcd within a lane so only those phases need a compare
+			const size_t phaseStep = greatestCommonDivisor(alignment, laneSize);
+			const size_t lastPhase = laneSize - phaseStep;
+
+			// Candidate masks by window residue. Windows advance by width so the
+			// residue cycles through width % alignment steps
+			uint64_t candidates[64];
+			for (size_t residue = 0; residue < alignment; residue++) {
+				candidates[residue] = candidateMask(alignment, residue, width);
+			}
+			const size_t residueStep = width % alignment;
+			size_t residue = 0;
+
+			// Whole windows only, including the furthest phase shift
+			while (offset + lastPhase + width <= chunkSize) {
+				uint64_t mask = 0;
+				for (size_t phase = 0; phase <= lastPhase; phase += phaseStep) {
+					// Bits shifted past the window are picked up by the next one
+					mask |= cmp(buffer + offset + phase) << phase;
+				}
+				mask = INVERT ? (~mask & candidates[residue]) : (mask & candidates[residue]);
+
+				// Walk matches in address order
+				while (mask != 0) {
+					size_t pos = offset + lowestSetBit(mask);
+					mask &= mask - 1;
+
+					ScanResult result;
+					result.address = chunkBase + pos;
+					memcpy(&result.value, buffer + pos, laneSize);
+					localResults.push_back(result);
+
+					if (localResults.size() >= maxLocalResults) {
+						return;
+					}
+				}
+
+				offset += width;
+				residue += residueStep;
+				if (residue >= alignment) {
+					residue -= alignment;
+				}
+			}
+
+			// Move to the next candidate for the remainder
+			offset += (alignment - residue) % alignment;
+		}
+
+		// Scalar remainder
+		while (offset + laneSize <= chunkSize && localResults.size() < maxLocalResults) {
+			bool equal = scalarEquals<typename Cmp::Value>(params, buffer + offset);
+			if (equal != INVERT) {
+				ScanResult result;
+				result.address = chunkBase + offset;
+				memcpy(&result.value, buffer + offset, laneSize);
+				localResults.push_back(result);
+			}
+			offset += alignment;
+		}
+	}
+
+	// Set the bit of the slot at a byte offset from an aligned chunk base
+	inline void setSlotBit(uint64_t* words, size_t offset, size_t alignment) {
+		size_t slot = offset / alignment;
+		words[slot >> 6] |= 1ULL << (slot & 63);
+	}
+
+	// Bitmap version of scanChunkVector. chunkBase is aligned so bit i of words
+	// is the slot i * alignment bytes in. Words must be zeroed by the caller
+	template<typename Cmp, bool INVERT>
+	void scanChunkMaskVector(const BasicScanner::KernelParams& params, const uint8_t* buffer, size_t chunkSize,
+	                         uintptr_t chunkBase, uint64_t* words) {
+		const size_t width = Cmp::WIDTH;
+		const size_t laneSize = Cmp::LANE;
+		const size_t alignment = params.alignment;
+		const Cmp cmp(params);
+
+		size_t offset = 0;
+
+		if (alignment <= width) {
+			const size_t phaseStep = greatestCommonDivisor(alignment, laneSize);
+			const size_t lastPhase = laneSize - phaseStep;
+
+			uint64_t candidates[64];
+			for (size_t residue = 0; residue < alignment; residue++) {
+				candidates[residue] = candidateMask(alignment, residue, width);
+			}
+			const size_t residueStep = width % alignment;
+			size_t residue = 0;
+
+			while (offset + lastPhase + width <= chunkSize) {
+				uint64_t mask = 0;
+				for (size_t phase = 0; phase <= lastPhase; phase += phaseStep) {
+					mask |= cmp(buffer + offset + phase) << phase;
+				}
+				mask = INVERT ? (~mask & candidates[residue]) : (mask & candidates[residue]);
+
+				if (alignment == 1) {
+					// Byte slots line up with the mask. Windows are a power of two
+					// that divides 64 so a window never spans two words
+					words[offset >> 6] |= mask << (offset & 63);
+				} else {
+					while (mask != 0) {
+						setSlotBit(words, offset + lowestSetBit(mask), alignment);
+						mask &= mask - 1;
+					}
+				}
+
+				offset += width;
+				residue += residueStep;
+				if (residue >= alignment) {
+					residue -= alignment;
+				}
+			}
+
+			offset += (alignment - residue) % alignment;
+		}
+
+		// Scalar remainder
+		while (offset + laneSize <= chunkSize) {
+			bool equal = scalarEquals<typename Cmp::Value>(params, buffer + offset);
+			if (equal != INVERT) {
+				setSlotBit(words, offset, alignment);
+			}
+			offset += alignment;
+		}
+	}
+
+	// Load a value into a staging lane. Integer types are widened to 32 bits and
+	// unsigned types zero extend so signed lane compares keep their ordering
+	template<typename T, typename Lane>
+	inline Lane loadLane(const void* p) {
+		T value;
+		memcpy(&value, p, sizeof(T));
+		return (Lane)value;
+	}
+
+	// Lane mask for one block of staged values. S is fixed at compile time
+	template<typename Ops, ScanType S>
+	inline uint32_t compareLanes(const Ops& ops, const typename Ops::Lane* current, const typename Ops::Lane* reference) {
+		const uint32_t allLanes = (uint32_t)((1ULL << Ops::LANES) - 1);
+		switch (S) {
+			case ScanType::EXACT:
+			case ScanType::UNCHANGED:
+				return ops.eq(current, reference);
+			case ScanType::NOT:
+			case ScanType::CHANGED:
+				return ~ops.eq(current, reference) & allLanes;
+			case ScanType::INCREASED:
+				return ops.gt(current, reference);
+			case ScanType::DECREASED:
+				return ops.lt(current, reference);
+			default:
+				return 0;
+		}
+	}
+
+	// Shared rescan loop. Stages LANES results at a time out of the chunk buffer,
+	// compares them against the target or their old values and emits survivors
+	template<typename Ops, typename T, ScanType S>
+	void rescanBatchVector(const BasicScanner::KernelParams& params, const ScanResult* oldResults, size_t count,
+	                       uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
+	                       ResultStore& newResults, size_t& invalidCount) {
+		typedef typename Ops::Lane Lane;
+		const size_t lanes = Ops::LANES;
+		const bool againstTarget = (S == ScanType::EXACT || S == ScanType::NOT);
+		const Ops ops(params);
+
+		alignas(64) Lane current[Ops::LANES];
+		alignas(64) Lane reference[Ops::LANES];
+
+		if (againstTarget) {
+			Lane target = loadLane<T, Lane>(&params.target);
+			for (size_t i = 0; i < lanes; i++) {
+				reference[i] = target;
+			}
+		}
+
+		for (size_t block = 0; block < count; block += lanes) {
+			size_t blockSize = std::min<size_t>(lanes, count - block);
+			const ScanResult* blockResults = oldResults + block;
+
+			// Gather the block. Lanes outside the chunk are left out of the valid mask
+			uint32_t valid = 0;
+			for (size_t i = 0; i < lanes; i++) {
+				current[i] = 0;
+				if (i < blockSize) {
+					size_t offset = blockResults[i].address - chunkStart;
+					if (offset + sizeof(T) <= chunkSize) {
+						current[i] = loadLane<T, Lane>(buffer + offset);
+						valid |= 1u << i;
+					}
+				}
+				if (!againstTarget) {
+					reference[i] = (i < blockSize) ? loadLane<T, Lane>(&blockResults[i].value) : 0;
+				}
+			}
+
+			uint32_t match = compareLanes<Ops, S>(ops, current, reference) & valid;
+
+			size_t matched = 0;
+			while (match != 0) {
+				unsigned long i = lowestSetBit(match);
+				match &= match - 1;
+
+				const ScanResult& oldResult = blockResults[i];
+				ScanResult result;
+				result.address = oldResult.address;
+				memcpy(&result.value, buffer + (oldResult.address - chunkStart), sizeof(T));
+				result.oldValue = oldResult.value;
+				result.hasOldValue = true;
+				newResults.push_back(result);
+				matched++;
+			}
+
+			invalidCount += blockSize - matched;
+		}
+	}
+
+	// Pick the rescan loop instantiation for a scan type
+	template<typename Ops, typename T>
+	BasicScanner::RescanKernel selectRescanVector(ScanType scanType) {
+		switch (scanType) {
+			case ScanType::EXACT: return rescanBatchVector<Ops, T, ScanType::EXACT>;
+			case ScanType::NOT: return rescanBatchVector<Ops, T, ScanType::NOT>;
+			case ScanType::INCREASED: return rescanBatchVector<Ops, T, ScanType::INCREASED>;
+			case ScanType::DECREASED: return rescanBatchVector<Ops, T, ScanType::DECREASED>;
+			case ScanType::CHANGED: return rescanBatchVector<Ops, T, ScanType::CHANGED>;
+			case ScanType::UNCHANGED: return rescanBatchVector<Ops, T, ScanType::UNCHANGED>;
+			default: return nullptr;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,253 @@
+#include "stdafx.h"
+#include "scanner_basic_kernels.h"
+
+// Scalar tier - one kernel per data type and scan type
+// Selected once per scan so the inner loops have no virtual calls or type
+// switches. Used when no SIMD tier is active and for the combinations the
+// vector tiers leave out. Compares match BasicScanner::compare,
+// compareGreater and compareLess
+namespace {
+	template<BasicScanner::DataType D>
+	struct ScalarOps;
+
+	template<>
+	struct ScalarOps<BasicScanner::DataType::BYTE> {
+		typedef uint8_t Value;
+		static bool eq(Value a, Value b, double) { return a == b; }
+		static bool gt(Value a, Value b, double) { return a > b; }
+		static bool lt(Value a, Value b, double) { return a < b; }
+	};
+
+	template<>
+	struct ScalarOps<BasicScanner::DataType::INT> {
+		typedef int32_t Value;
+		static bool eq(Value a, Value b, double) { return a == b; }
+		static bool gt(Value a, Value b, double) { return a > b; }
+		static bool lt(Value a, Value b, double) { return a < b; }
+	};
+
+	template<>
+	struct ScalarOps<BasicScanner::DataType::FLOAT> {
+		typedef float Value;
+		static bool eq(Value a, Value b, double epsilon) { return std::abs(a - b) < (float)epsilon; }
+		static bool gt(Value a, Value b, double epsilon) { return a > b + (float)epsilon; }
+		static bool lt(Value a, Value b, double epsilon) { return a < b - (float)epsilon; }
+	};
+
+	template<>
+	struct ScalarOps<BasicScanner::DataType::DOUBLE> {
+		typedef double Value;
+		static bool eq(Value a, Value b, double epsilon) { return std::abs(a - b) < epsilon; }
+		static bool gt(Value a, Value b, double epsilon) { return a > b + epsilon; }
+		static bool lt(Value a, Value b, double epsilon) { return a < b - epsilon; }
+	};
+
+	// BOOL is kept as the raw byte. Any non zero byte counts as true
+	template<>
+	struct ScalarOps<BasicScanner::DataType::BOOL> {
+		typedef uint8_t Value;
+		static bool eq(Value a, Value b, double) { return (a != 0) == (b != 0); }
+		static bool gt(Value a, Value b, double) { return a != 0 && b == 0; }
+		static bool lt(Value a, Value b, double) { return a == 0 && b != 0; }
+	};
+
+	template<typename T>
+	inline T loadValue(const void* p) {
+		T value;
+		memcpy(&value, p, sizeof(T));
+		return value;
+	}
+
+	// S is fixed at compile time so this folds down to a single compare
+	template<typename Ops, ScanType S>
+	inline bool matches(typename Ops::Value current, typename Ops::Value reference, double epsilon) {
+		switch (S) {
+			case ScanType::EXACT:
+			case ScanType::UNCHANGED:
+				return Ops::eq(current, reference, epsilon);
+			case ScanType::NOT:
+			case ScanType::CHANGED:
+				return !Ops::eq(current, reference, epsilon);
+			case ScanType::INCREASED:
+				return Ops::gt(current, reference, epsilon);
+			case ScanType::DECREASED:
+				return Ops::lt(current, reference, epsilon);
+			default:
+				return false;
+		}
+	}
+
+	template<typename Ops, ScanType S>
+	void scanChunkScalar(const BasicScanner::KernelParams& params, const uint8_t* buffer, size_t chunkSize,
+	                     uintptr_t chunkBase, std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+		typedef typename Ops::Value Value;
+		const Value target = loadValue<Value>(&params.target);
+
+		size_t offset = BasicKernels::firstAlignedOffset(chunkBase, params.alignment);
+		while (offset + sizeof(Value) <= chunkSize && localResults.size() < maxLocalResults) {
+			if (matches<Ops, S>(loadValue<Value>(buffer + offset), target, params.epsilon)) {
+				ScanResult result;
+				result.address = chunkBase + offset;
+				memcpy(&result.value, buffer + offset, sizeof(Value));
+				localResults.push_back(result);
+			}
+			offset += params.alignment;
+		}
+	}
+
+	// chunkBase is aligned so bit i of words is the slot i * alignment bytes in
+	template<typename Ops, ScanType S>
+	void scanChunkMaskScalar(const BasicScanner::KernelParams& params, const uint8_t* buffer, size_t chunkSize,
+	                         uintptr_t chunkBase, uint64_t* words) {
+		typedef typename Ops::Value Value;
+		const Value target = loadValue<Value>(&params.target);
+
+		size_t slot = 0;
+		for (size_t offset = 0; offset + sizeof(Value) <= chunkSize; offset += params.alignment, slot++) {
+			if (matches<Ops, S>(loadValue<Value>(buffer + offset), target, params.epsilon)) {
+				words[slot >> 6] |= 1ULL << (slot & 63);
+			}
+		}
+	}
+
+	// Identical bytes short circuit to unchanged so NaNs compare the same way
+	// as pages the snapshot skipped by hash
+	template<typename Ops, ScanType S>
+	void scanChunkRelativeMaskScalar(const BasicScanner::KernelParams& params, const uint8_t* buffer, const uint8_t* oldBuffer,
+	                                 size_t chunkSize, uint64_t* words) {
+		typedef typename Ops::Value Value;
+
+		size_t slot = 0;
+		for (size_t offset = 0; offset + sizeof(Value) <= chunkSize; offset += params.alignment, slot++) {
+			bool match;
+			if (memcmp(buffer + offset, oldBuffer + offset, sizeof(Value)) == 0) {
+				match = (S == ScanType::UNCHANGED);
+			} else {
+				match = matches<Ops, S>(loadValue<Value>(buffer + offset), loadValue<Value>(oldBuffer + offset), params.epsilon);
+			}
+			if (match) {
+				words[slot >> 6] |= 1ULL << (slot & 63);
+			}
+		}
+	}
+
+	template<typename Ops, ScanType S>
+	void rescanBatchScalar(const BasicScanner::KernelParams& params, const ScanResult* oldResults, size_t count,
+	                       uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
+	                       ResultStore& newResults, size_t& invalidCount) {
+		typedef typename Ops::Value Value;
+		const bool againstTarget = (S == ScanType::EXACT || S == ScanType::NOT);
+		const Value target = loadValue<Value>(&params.target);
+
+		for (size_t i = 0; i < count; i++) {
+			const ScanResult& oldResult = oldResults[i];
+			size_t offset = oldResult.address - chunkStart;
+
+			// Verify address is within chunk
+			if (offset + sizeof(Value) > chunkSize) {
+				invalidCount++;
+				continue;
+			}
+
+			Value current = loadValue<Value>(buffer + offset);
+			Value reference = againstTarget ? target : loadValue<Value>(&oldResult.value);
+			if (!matches<Ops, S>(current, reference, params.epsilon)) {
+				invalidCount++;
+				continue;
+			}
+
+			ScanResult result;
+			result.address = oldResult.address;
+			memcpy(&result.value, buffer + offset, sizeof(Value));
+			result.oldValue = oldResult.value;
+			result.hasOldValue = true;
+			newResults.push_back(result);
+		}
+	}
+
+	template<BasicScanner::DataType D>
+	BasicScanner::ChunkKernel selectChunkScalar(ScanType scanType) {
+		switch (scanType) {
+			case ScanType::EXACT: return scanChunkScalar<ScalarOps<D>, ScanType::EXACT>;
+			case ScanType::NOT: return scanChunkScalar<ScalarOps<D>, ScanType::NOT>;
+			default: return nullptr;
+		}
+	}
+
+	template<BasicScanner::DataType D>
+	BasicScanner::MaskKernel selectMaskScalar(ScanType scanType) {
+		switch (scanType) {
+			case ScanType::EXACT: return scanChunkMaskScalar<ScalarOps<D>, ScanType::EXACT>;
+			case ScanType::NOT: return scanChunkMaskScalar<ScalarOps<D>, ScanType::NOT>;
+			default: return nullptr;
+		}
+	}
+
+	template<BasicScanner::DataType D>
+	BasicScanner::RelativeMaskKernel selectRelativeMaskScalar(ScanType scanType) {
+		switch (scanType) {
+			case ScanType::INCREASED: return scanChunkRelativeMaskScalar<ScalarOps<D>, ScanType::INCREASED>;
+			case ScanType::DECREASED: return scanChunkRelativeMaskScalar<ScalarOps<D>, ScanType::DECREASED>;
+			case ScanType::CHANGED: return scanChunkRelativeMaskScalar<ScalarOps<D>, ScanType::CHANGED>;
+			case ScanType::UNCHANGED: return scanChunkRelativeMaskScalar<ScalarOps<D>, ScanType::UNCHANGED>;
+			default: return nullptr;
+		}
+	}
+
+	template<BasicScanner::DataType D>
+	BasicScanner::RescanKernel selectRescanScalar(ScanType scanType) {
+		switch (scanType) {
+			case ScanType::EXACT: return rescanBatchScalar<ScalarOps<D>, ScanType::EXACT>;
+			case ScanType::NOT: return rescanBatchScalar<ScalarOps<D>, ScanType::NOT>;
+			case ScanType::INCREASED: return rescanBatchScalar<ScalarOps<D>, ScanType::INCREASED>;
+			case ScanType::DECREASED: return rescanBatchScalar<ScalarOps<D>, ScanType::DECREASED>;
+			case ScanType::CHANGED: return rescanBatchScalar<ScalarOps<D>, ScanType::CHANGED>;
+			case ScanType::UNCHANGED: return rescanBatchScalar<ScalarOps<D>, ScanType::UNCHANGED>;
+			default: return nullptr;
+		}
+	}
+}
+
+BasicScanner::ChunkKernel BasicKernels::getChunkKernelScalar(BasicScanner::DataType dataType, ScanType scanType) {
+	switch (dataType) {
+		case BasicScanner::DataType::BYTE: return selectChunkScalar<BasicScanner::DataType::BYTE>(scanType);
+		case BasicScanner::DataType::INT: return selectChunkScalar<BasicScanner::DataType::INT>(scanType);
+		case BasicScanner::DataType::FLOAT: return selectChunkScalar<BasicScanner::DataType::FLOAT>(scanType);
+		case BasicScanner::DataType::DOUBLE: return selectChunkScalar<BasicScanner::DataType::DOUBLE>(scanType);
+		case BasicScanner::DataType::BOOL: return selectChunkScalar<BasicScanner::DataType::BOOL>(scanType);
+		default: return nullptr;
+	}
+}
+
+BasicScanner::MaskKernel BasicKernels::getMaskKernelScalar(BasicScanner::DataType dataType, ScanType scanType) {
+	switch (dataType) {
+		case BasicScanner::DataType::BYTE: return selectMaskScalar<BasicScanner::DataType::BYTE>(scanType);
+		case BasicScanner::DataType::INT: return selectMaskScalar<BasicScanner::DataType::INT>(scanType);
+		case BasicScanner::DataType::FLOAT: return selectMaskScalar<BasicScanner::DataType::FLOAT>(scanType);
+		case BasicScanner::DataType::DOUBLE: return selectMaskScalar<BasicScanner::DataType::DOUBLE>(scanType);
+		case BasicScanner::DataType::BOOL: return selectMaskScalar<BasicScanner::DataType::BOOL>(scanType);
+		default: return nullptr;
+	}
+}
+
+BasicScanner::RelativeMaskKernel BasicKernels::getRelativeMaskKernelScalar(BasicScanner::DataType dataType, ScanType scanType) {
+	switch (dataType) {
+		case BasicScanner::DataType::BYTE: return selectRelativeMaskScalar<BasicScanner::DataType::BYTE>(scanType);
+		case BasicScanner::DataType::INT: return selectRelativeMaskScalar<BasicScanner::DataType::INT>(scanType);
+		case BasicScanner::DataType::FLOAT: return selectRelativeMaskScalar<BasicScanner::DataType::FLOAT>(scanType);
+		case BasicScanner::DataType::DOUBLE: return selectRelativeMaskScalar<BasicScanner::DataType::DOUBLE>(scanType);
+		case BasicScanner::DataType::BOOL: return selectRelativeMaskScalar<BasicScanner::DataType::BOOL>(scanType);
+		default: return nullptr;
+	}
+}
+
+BasicScanner::RescanKernel BasicKernels::getRescanKernelScalar(BasicScanner::DataType dataType, ScanType scanType) {
+	switch (dataType) {
+		case BasicScanner::DataType::BYTE: return selectRescanScalar<BasicScanner::DataType::BYTE>(scanType);
+		case BasicScanner::DataType::INT: return selectRescanScalar<BasicScanner::DataType::INT>(scanType);
+		case BasicScanner::DataType::FLOAT: return selectRescanScalar<BasicScanner::DataType::FLOAT>(scanType);
+		case BasicScanner::DataType::DOUBLE: return selectRescanScalar<BasicScanner::DataType::DOUBLE>(scanType);
+		case BasicScanner::DataType::BOOL: return selectRescanScalar<BasicScanner::DataType::BOOL>(scanType);
+		default: return nullptr;
+	}
+}
@@ -0,0 +1,217 @@
+#include "stdafx.h"
+#include "scanner_basic_kernels.h"
+#include <emmintrin.h>  // SSE2 intrinsics
+
+// SSE2 tier - 16 byte windows
+// Baseline for any x86 CPU the game runs on
+namespace {
+	const size_t SSE2_WIDTH = 16;
+
+	struct Eq8 {
+		typedef uint8_t Value;
+		static const size_t WIDTH = SSE2_WIDTH;
+		static const size_t LANE = 1;
+		__m128i target;
+
+		explicit Eq8(const BasicScanner::KernelParams& params) : target(_mm_set1_epi8((char)params.target.byteValue)) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m128i dataVec = _mm_loadu_si128((const __m128i*)p);
+			return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(dataVec, target));
+		}
+	};
+
+	// BOOL matches on truth, so any non zero byte equals a true target
+	struct EqBool {
+		typedef bool Value;
+		static const size_t WIDTH = SSE2_WIDTH;
+		static const size_t LANE = 1;
+		uint32_t flip;
+
+		explicit EqBool(const BasicScanner::KernelParams& params) : flip(params.target.byteValue != 0 ? 0xFFFFu : 0) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m128i dataVec = _mm_loadu_si128((const __m128i*)p);
+			uint32_t zero = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(dataVec, _mm_setzero_si128()));
+			return zero ^ flip;
+		}
+	};
+
+	struct Eq32 {
+		typedef int32_t Value;
+		static const size_t WIDTH = SSE2_WIDTH;
+		static const size_t LANE = 4;
+		__m128i target;
+
+		explicit Eq32(const BasicScanner::KernelParams& params) : target(_mm_set1_epi32(params.target.intValue)) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m128i dataVec = _mm_loadu_si128((const __m128i*)p);
+			// movemask gives 4 bits per lane, keep the one at the lane start
+			return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi32(dataVec, target)) & 0x1111u;
+		}
+	};
+
+	// |data - target| < epsilon. Abs is done by clearing the sign bit
+	struct EqF32 {
+		typedef float Value;
+		static const size_t WIDTH = SSE2_WIDTH;
+		static const size_t LANE = 4;
+		__m128 target;
+		__m128 epsilon;
+		__m128 absMask;
+
+		explicit EqF32(const BasicScanner::KernelParams& params) :
+			target(_mm_set1_ps(params.target.floatValue)),
+			epsilon(_mm_set1_ps((float)params.epsilon)),
+			absMask(_mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF))) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m128 diff = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps((const float*)p), target), absMask);
+			return (uint32_t)_mm_movemask_epi8(_mm_castps_si128(_mm_cmplt_ps(diff, epsilon))) & 0x1111u;
+		}
+	};
+
+	struct EqF64 {
+		typedef double Value;
+		static const size_t WIDTH = SSE2_WIDTH;
+		static const size_t LANE = 8;
+		__m128d target;
+		__m128d epsilon;
+		__m128d absMask;
+
+		explicit EqF64(const BasicScanner::KernelParams& params) :
+			target(_mm_set1_pd(params.target.doubleValue)),
+			epsilon(_mm_set1_pd(params.epsilon)),
+			absMask(_mm_castsi128_pd(_mm_set_epi32(0x7FFFFFFF, -1, 0x7FFFFFFF, -1))) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m128d diff = _mm_and_pd(_mm_sub_pd(_mm_loadu_pd((const double*)p), target), absMask);
+			return (uint32_t)_mm_movemask_epi8(_mm_castpd_si128(_mm_cmplt_pd(diff, epsilon))) & 0x0101u;
+		}
+	};
+
+	// Staged 32 bit lanes for rescans
+	struct Lanes32 {
+		typedef int32_t Lane;
+		static const size_t LANES = 4;
+
+		explicit Lanes32(const BasicScanner::KernelParams&) {}
+
+		uint32_t eq(const int32_t* a, const int32_t* b) const {
+			__m128i cmpVec = _mm_cmpeq_epi32(_mm_load_si128((const __m128i*)a), _mm_load_si128((const __m128i*)b));
+			return (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(cmpVec));
+		}
+
+		uint32_t gt(const int32_t* a, const int32_t* b) const {
+			__m128i cmpVec = _mm_cmpgt_epi32(_mm_load_si128((const __m128i*)a), _mm_load_si128((const __m128i*)b));
+			return (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(cmpVec));
+		}
+
+		uint32_t lt(const int32_t* a, const int32_t* b) const {
+			return gt(b, a);
+		}
+	};
+
+	struct LanesF32 {
+		typedef float Lane;
+		static const size_t LANES = 4;
+		__m128 epsilon;
+		__m128 absMask;
+
+		explicit LanesF32(const BasicScanner::KernelParams& params) :
+			epsilon(_mm_set1_ps((float)params.epsilon)),
+			absMask(_mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF))) {}
+
+		uint32_t eq(const float* a, const float* b) const {
+			__m128 diff = _mm_and_ps(_mm_sub_ps(_mm_load_ps(a), _mm_load_ps(b)), absMask);
+			return (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(diff, epsilon));
+		}
+
+		uint32_t gt(const float* a, const float* b) const {
+			return (uint32_t)_mm_movemask_ps(_mm_cmpgt_ps(_mm_load_ps(a), _mm_add_ps(_mm_load_ps(b), epsilon)));
+		}
+
+		uint32_t lt(const float* a, const float* b) const {
+			return (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(_mm_load_ps(a), _mm_sub_ps(_mm_load_ps(b), epsilon)));
+		}
+	};
+
+	struct LanesF64 {
+		typedef double Lane;
+		static const size_t LANES = 2;
+		__m128d epsilon;
+		__m128d absMask;
+
+		explicit LanesF64(const BasicScanner::KernelParams& params) :
+			epsilon(_mm_set1_pd(params.epsilon)),
+			absMask(_mm_castsi128_pd(_mm_set_epi32(0x7FFFFFFF, -1, 0x7FFFFFFF, -1))) {}
+
+		uint32_t eq(const double* a, const double* b) const {
+			__m128d diff = _mm_and_pd(_mm_sub_pd(_mm_load_pd(a), _mm_load_pd(b)), absMask);
+			return (uint32_t)_mm_movemask_pd(_mm_cmplt_pd(diff, epsilon));
+		}
+
+		uint32_t gt(const double* a, const double* b) const {
+			return (uint32_t)_mm_movemask_pd(_mm_cmpgt_pd(_mm_load_pd(a), _mm_add_pd(_mm_load_pd(b), epsilon)));
+		}
+
+		uint32_t lt(const double* a, const double* b) const {
+			return (uint32_t)_mm_movemask_pd(_mm_cmplt_pd(_mm_load_pd(a), _mm_sub_pd(_mm_load_pd(b), epsilon)));
+		}
+	};
+}
+
+BasicScanner::ChunkKernel BasicKernels::getChunkKernelSSE2(BasicScanner::DataType dataType, ScanType scanType) {
+	bool invert = (scanType == ScanType::NOT);
+
+	switch (dataType) {
+		case BasicScanner::DataType::BYTE:
+			return invert ? scanChunkVector<Eq8, true> : scanChunkVector<Eq8, false>;
+		case BasicScanner::DataType::BOOL:
+			return invert ? scanChunkVector<EqBool, true> : scanChunkVector<EqBool, false>;
+		case BasicScanner::DataType::INT:
+			return invert ? scanChunkVector<Eq32, true> : scanChunkVector<Eq32, false>;
+		case BasicScanner::DataType::FLOAT:
+			return invert ? scanChunkVector<EqF32, true> : scanChunkVector<EqF32, false>;
+		case BasicScanner::DataType::DOUBLE:
+			return invert ? scanChunkVector<EqF64, true> : scanChunkVector<EqF64, false>;
+		default:
+			return nullptr;
+	}
+}
+
+BasicScanner::MaskKernel BasicKernels::getMaskKernelSSE2(BasicScanner::DataType dataType, ScanType scanType) {
+	bool invert = (scanType == ScanType::NOT);
+
+	switch (dataType) {
+		case BasicScanner::DataType::BYTE:
+			return invert ? scanChunkMaskVector<Eq8, true> : scanChunkMaskVector<Eq8, false>;
+		case BasicScanner::DataType::BOOL:
+			return invert ? scanChunkMaskVector<EqBool, true> : scanChunkMaskVector<EqBool, false>;
+		case BasicScanner::DataType::INT:
+			return invert ? scanChunkMaskVector<Eq32, true> : scanChunkMaskVector<Eq32, false>;
+		case BasicScanner::DataType::FLOAT:
+			return invert ? scanChunkMaskVector<EqF32, true> : scanChunkMaskVector<EqF32, false>;
+		case BasicScanner::DataType::DOUBLE:
+			return invert ? scanChunkMaskVector<EqF64, true> : scanChunkMaskVector<EqF64, false>;
+		default:
+			return nullptr;
+	}
+}
+
+BasicScanner::RescanKernel BasicKernels::getRescanKernelSSE2(BasicScanner::DataType dataType, ScanType scanType) {
+	switch (dataType) {
+		case BasicScanner::DataType::BYTE:
+			return selectRescanVector<Lanes32, uint8_t>(scanType);
+		case BasicScanner::DataType::INT:
+			return selectRescanVector<Lanes32, int32_t>(scanType);
+		case BasicScanner::DataType::FLOAT:
+			return selectRescanVector<LanesF32, float>(scanType);
+		case BasicScanner::DataType::DOUBLE:
+			return selectRescanVector<LanesF64, double>(scanType);
+		default:
+			// BOOL relative compares stay scalar
+			return nullptr;
+	}
+}
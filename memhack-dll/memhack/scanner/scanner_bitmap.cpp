@@ -0,0 +1,113 @@
+#include "stdafx.h"
+#include "scanner_bitmap.h"
+
+#include <algorithm>
+
+void ResultBitmap::reset(size_t alignment, size_t dataSize) {
+	// Swap to release the memory. Bitmaps can be hundreds of MB
+	std::vector<BitmapRegion, ScannerAllocator<BitmapRegion>>().swap(regions);
+	std::vector<uint64_t, ScannerAllocator<uint64_t>>().swap(words);
+	this->alignment = alignment == 0 ? 1 : alignment;
+	this->dataSize = dataSize == 0 ? 1 : dataSize;
+}
+
+size_t ResultBitmap::countSlots(uintptr_t base, size_t size, size_t alignment, size_t dataSize) {
+	uintptr_t end = base + size;
+	uintptr_t first = base + (alignment - base % alignment) % alignment;
+	if (first < base || first + dataSize > end) {
+		return 0;
+	}
+	return (end - dataSize - first) / alignment + 1;
+}
+
+void ResultBitmap::reserve(size_t regionCount, size_t wordCount) {
+	regions.reserve(regionCount);
+	words.reserve(wordCount);
+}
+
+void ResultBitmap::addRegion(uintptr_t base, size_t size) {
+	size_t slotCount = countSlots(base, size, alignment, dataSize);
+	if (slotCount == 0) {
+		return;
+	}
+
+	BitmapRegion region;
+	region.base = base + (alignment - base % alignment) % alignment;
+	region.slotCount = slotCount;
+	region.firstWord = words.size();
+	regions.push_back(region);
+	words.resize(words.size() + (slotCount + 63) / 64, 0);
+}
+
+void ResultBitmap::setAll() {
+	for (const BitmapRegion& region : regions) {
+		size_t fullWords = region.slotCount / 64;
+		std::fill(words.begin() + region.firstWord, words.begin() + region.firstWord + fullWords, ~0ULL);
+		if (region.slotCount % 64 != 0) {
+			words[region.firstWord + fullWords] = (1ULL << (region.slotCount % 64)) - 1;
+		}
+	}
+}
+
+void ResultBitmap::splitChunks(std::vector<BitmapChunk, ScannerAllocator<BitmapChunk>>& outChunks) const {
+	outChunks.clear();
+
+	// Whole words of slots that fit the scan buffer with the last value
+	const size_t chunkSlots = std::max<size_t>((SCAN_BUFFER_SIZE / alignment) & ~(size_t)63, 64);
+	for (size_t i = 0; i < regions.size(); i++) {
+		for (size_t slot = 0; slot < regions[i].slotCount; slot += chunkSlots) {
+			BitmapChunk chunk;
+			chunk.region = (uint32_t)i;
+			chunk.firstSlot = slot;
+			chunk.slotCount = std::min<size_t>(chunkSlots, regions[i].slotCount - slot);
+			outChunks.push_back(chunk);
+		}
+	}
+}
+
+size_t ResultBitmap::countSet() const {
+	size_t count = 0;
+	for (uint64_t word : words) {
+		count += countBits(word);
+	}
+	return count;
+}
+
+void ResultBitmap::getAddresses(size_t first, size_t count, std::vector<uintptr_t, ScannerAllocator<uintptr_t>>& outAddresses) const {
+	outAddresses.clear();
+	size_t skip = first;
+
+	for (const BitmapRegion& region : regions) {
+		size_t wordCount = (region.slotCount + 63) / 64;
+		for (size_t w = 0; w < wordCount && outAddresses.size() < count; w++) {
+			uint64_t word = words[region.firstWord + w];
+			size_t bits = countBits(word);
+
+			// Skip whole words until the first wanted slot
+			if (skip >= bits) {
+				skip -= bits;
+				continue;
+			}
+
+			while (word != 0 && outAddresses.size() < count) {
+				unsigned long bit;
+				if ((uint32_t)word != 0) {
+					_BitScanForward(&bit, (uint32_t)word);
+				} else {
+					_BitScanForward(&bit, (uint32_t)(word >> 32));
+					bit += 32;
+				}
+				word &= word - 1;
+
+				if (skip > 0) {
+					skip--;
+					continue;
+				}
+				outAddresses.push_back(region.base + (w * 64 + bit) * alignment);
+			}
+		}
+		if (outAddresses.size() >= count) {
+			return;
+		}
+	}
+}
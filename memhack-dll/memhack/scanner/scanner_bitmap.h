@@ -0,0 +1,88 @@
+#ifndef SCANNER_BITMAP_H
+#define SCANNER_BITMAP_H
+
+#include "scanner_base.h"
+
+// Largest alignment bitmap results support. A chunk has to cover at least
+// one 64 slot word and still fit in the scan buffer
+const size_t BITMAP_MAX_ALIGNMENT = SCAN_BUFFER_SIZE / 64;
+
+// Cap on bitmap memory. 256MB covers 2GB of byte slots
+const size_t BITMAP_MAX_BYTES = 256 * 1024 * 1024;
+
+// Scanned region of a result bitmap. Slot i is the value at base + i * alignment
+// Each region starts on its own word so chunks never share a word
+struct BitmapRegion {
+	uintptr_t base;
+	size_t slotCount;
+	size_t firstWord;
+};
+
+// Piece of a region processed at once. Covers whole words and fits the scan buffer
+struct BitmapChunk {
+	uint32_t region;
+	size_t firstSlot;
+	size_t slotCount;
+};
+
+// Dense result set with one bit per aligned slot of each scanned region
+// Used when a scan matches too much of memory to keep a result per match
+class ResultBitmap {
+public:
+	ResultBitmap() : alignment(1), dataSize(1) {}
+
+	// Drop every region and set the slot layout for the next scan
+	void reset(size_t alignment, size_t dataSize);
+	void clear() { reset(1, 1); }
+
+	// Slots of a region that hold a whole value. 0 if none fit
+	static size_t countSlots(uintptr_t base, size_t size, size_t alignment, size_t dataSize);
+
+	// Reserve for the regions up front so the words are allocated exactly once
+	void reserve(size_t regionCount, size_t wordCount);
+
+	// Regions must be added in address order. Their bits start cleared
+	void addRegion(uintptr_t base, size_t size);
+
+	// Set the bit of every slot
+	void setAll();
+
+	// Split every region into chunks of whole words
+	void splitChunks(std::vector<BitmapChunk, ScannerAllocator<BitmapChunk>>& outChunks) const;
+
+	uintptr_t getChunkBase(const BitmapChunk& chunk) const { return regions[chunk.region].base + chunk.firstSlot * alignment; }
+	// Bytes of memory a chunk covers
+	size_t getChunkSize(const BitmapChunk& chunk) const { return (chunk.slotCount - 1) * alignment + dataSize; }
+	uint64_t* getChunkWords(const BitmapChunk& chunk) { return words.data() + regions[chunk.region].firstWord + chunk.firstSlot / 64; }
+	const uint64_t* getChunkWords(const BitmapChunk& chunk) const { return words.data() + regions[chunk.region].firstWord + chunk.firstSlot / 64; }
+	static size_t getChunkWordCount(const BitmapChunk& chunk) { return (chunk.slotCount + 63) / 64; }
+
+	const std::vector<BitmapRegion, ScannerAllocator<BitmapRegion>>& getRegions() const { return regions; }
+	// Bytes from the region's first slot to the end of its last value
+	size_t getRegionSize(const BitmapRegion& region) const { return (region.slotCount - 1) * alignment + dataSize; }
+
+	bool empty() const { return regions.empty(); }
+	size_t getAlignment() const { return alignment; }
+	size_t getMemoryUsage() const { return words.capacity() * sizeof(uint64_t) + regions.capacity() * sizeof(BitmapRegion); }
+
+	size_t countSet() const;
+
+	// Addresses of up to count set slots starting at the first-th set slot
+	void getAddresses(size_t first, size_t count, std::vector<uintptr_t, ScannerAllocator<uintptr_t>>& outAddresses) const;
+
+private:
+	std::vector<BitmapRegion, ScannerAllocator<BitmapRegion>> regions;
+	std::vector<uint64_t, ScannerAllocator<uint64_t>> words;
+	size_t alignment;
+	size_t dataSize;
+};
+
+// Bits set in a word. Kept portable since the scalar tier runs on CPUs without POPCNT
+inline size_t countBits(uint64_t word) {
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (size_t)((word * 0x0101010101010101ULL) >> 56);
+}
+
+#endif
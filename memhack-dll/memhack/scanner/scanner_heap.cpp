@@ -14,9 +14,9 @@ namespace ScannerHeap {
 
 	bool initialize() {
 		// Create a private heap for scanner allocations
-		// No serialization needed - we expect it be single threaded
+		// Serialized since scan threads allocate result blocks from it
 		// Max size is unlimited (0)
-		g_scannerHeap = HeapCreate(HEAP_NO_SERIALIZE, INITIAL_HEAP_SIZE, 0);
+		g_scannerHeap = HeapCreate(0, INITIAL_HEAP_SIZE, 0);
 
 		if (!g_scannerHeap) {
 			// Heap creation failed - fall back to regular allocator
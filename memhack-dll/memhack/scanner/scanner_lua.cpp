@@ -3,6 +3,7 @@
 #include "scanner_base.h"
 #include "scanner_basic.h"
 #include "scanner_sequence.h"
+#include "scanner_multi_sequence.h"
 #include "scanner_struct.h"
 #include "../lua_helpers.h"
 
@@ -86,6 +87,9 @@ bool parseScanType(const char* str, ScanType& outType) {
 	} else if (lower == "not") {
 		outType = ScanType::NOT;
 		return true;
+	} else if (lower == "unknown") {
+		outType = ScanType::UNKNOWN;
+		return true;
 	}
 
 	return false;
@@ -123,6 +127,23 @@ bool parseSequenceDataType(const char* str, SequenceScanner::DataType& outType)
 	} else if (lower == "byte_array" || lower == "bytearray") {
 		outType = SequenceScanner::DataType::BYTE_ARRAY;
 		return true;
+	} else if (lower == "pattern" || lower == "aob") {
+		outType = SequenceScanner::DataType::PATTERN;
+		return true;
+	}
+
+	return false;
+}
+
+bool parseMultiSequenceDataType(const char* str, SequenceScanner::DataType& outType) {
+	std::string lower = toLower(str);
+
+	if (lower == "multi_string" || lower == "multistring") {
+		outType = SequenceScanner::DataType::STRING;
+		return true;
+	} else if (lower == "multi_byte_array" || lower == "multibytearray") {
+		outType = SequenceScanner::DataType::BYTE_ARRAY;
+		return true;
 	}
 
 	return false;
@@ -233,6 +254,298 @@ bool parseSequenceValue(lua_State* L, int valueIndex, SequenceScanner::DataType
 	}
 }
 
+// Parse a masked pattern string such as "8B 0D ?? ?? ?? ?? 85 C9" for PATTERN
+// Returns true on success, false on error (error already pushed to Lua)
+bool parsePatternValue(lua_State* L, int valueIndex, SequenceScanner::MaskedPattern& outPattern) {
+	if (lua_type(L, valueIndex) != LUA_TSTRING) {
+		luaL_error(L, "Expected pattern string for PATTERN data type (i.e. \"8B 0D ?? ?? ?? ?? 85 C9\")");
+		return false;
+	}
+
+	const char* text = lua_tostring(L, valueIndex);
+	if (!SequenceScanner::parsePattern(text, outPattern)) {
+		luaL_error(L, "Invalid pattern: \"%s\" (expected space separated hex bytes with ?? wildcards, at least one byte without wildcards, at most %d bytes)",
+		           text, (int)MAX_SEQUENCE_SIZE);
+		return false;
+	}
+	return true;
+}
+
+// Parse an array table of sequence values for multi sequence types
+// Returns true on success, false on error (error already pushed to Lua)
+bool parsePatternList(lua_State* L, int valueIndex, SequenceScanner::DataType dataType,
+                      MultiSequenceScanner::PatternList& outPatterns) {
+	if (!lua_istable(L, valueIndex)) {
+		luaL_error(L, "Expected table of patterns for multi sequence data type");
+		return false;
+	}
+
+	size_t count = lua_objlen(L, valueIndex);
+	if (count == 0) {
+		luaL_error(L, "Pattern table cannot be empty");
+		return false;
+	}
+	if (count > MAX_MULTI_PATTERNS) {
+		luaL_error(L, "Pattern count (%d) exceeds maximum allowed count (%d)", (int)count, (int)MAX_MULTI_PATTERNS);
+		return false;
+	}
+
+	outPatterns.clear();
+	outPatterns.reserve(count);
+	for (size_t i = 1; i <= count; i++) {
+		lua_rawgeti(L, valueIndex, (int)i);
+
+		const void* data;
+		size_t size;
+		std::vector<uint8_t, ScannerAllocator<uint8_t>> bytesBuffer;
+		if (!parseSequenceValue(L, lua_gettop(L), dataType, data, size, bytesBuffer)) {
+			return false; // Error already pushed
+		}
+		const uint8_t* bytes = (const uint8_t*)data;
+		outPatterns.emplace_back(bytes, bytes + size);
+
+		lua_pop(L, 1);
+	}
+	return true;
+}
+
+// Helper to parse a table of strings such as module names
+bool parseStringList(lua_State* L, int index, const char* name,
+                     std::vector<std::string, ScannerAllocator<std::string>>& outList) {
+	if (!lua_istable(L, index)) {
+		luaL_error(L, "%s must be a table of strings", name);
+		return false;
+	}
+
+	outList.clear();
+	size_t count = lua_objlen(L, index);
+	for (size_t i = 1; i <= count; i++) {
+		lua_rawgeti(L, index, (int)i);
+		if (!lua_isstring(L, -1)) {
+			luaL_error(L, "%s[%d] must be a string", name, (int)i);
+			return false;
+		}
+		outList.emplace_back(lua_tostring(L, -1));
+		lua_pop(L, 1);
+	}
+	return true;
+}
+
+// Helper to parse memory type names into RegionFilter::TYPE_* bits
+bool parseMemoryTypes(lua_State* L, int index, const char* name, uint32_t& outTypes) {
+	std::vector<std::string, ScannerAllocator<std::string>> names;
+	if (!parseStringList(L, index, name, names)) {
+		return false;
+	}
+
+	outTypes = 0;
+	for (const std::string& typeName : names) {
+		std::string lower = toLower(typeName.c_str());
+		if (lower == "private") {
+			outTypes |= RegionFilter::TYPE_PRIVATE;
+		} else if (lower == "image") {
+			outTypes |= RegionFilter::TYPE_IMAGE;
+		} else if (lower == "mapped") {
+			outTypes |= RegionFilter::TYPE_MAPPED;
+		} else {
+			luaL_error(L, "Invalid memory type in %s: %s (valid: PRIVATE, IMAGE, MAPPED)", name, typeName.c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
+// Helper to apply region filter keys from an options table onto a filter
+// Keys that are not given leave the filter unchanged
+bool parseRegionFilter(lua_State* L, int optionsIndex, RegionFilter& filter) {
+	lua_getfield(L, optionsIndex, "memoryTypes");
+	if (!lua_isnil(L, -1) && !parseMemoryTypes(L, lua_gettop(L), "memoryTypes", filter.memoryTypes)) {
+		return false;
+	}
+	lua_pop(L, 1);
+
+	lua_getfield(L, optionsIndex, "excludeMemoryTypes");
+	if (!lua_isnil(L, -1)) {
+		uint32_t excluded;
+		if (!parseMemoryTypes(L, lua_gettop(L), "excludeMemoryTypes", excluded)) {
+			return false;
+		}
+		filter.memoryTypes &= ~excluded;
+	}
+	lua_pop(L, 1);
+
+	// true requires the protection, false excludes it
+	const char* protectNames[] = { "writable", "executable" };
+	const uint32_t protectBits[] = { RegionFilter::PROTECT_WRITABLE, RegionFilter::PROTECT_EXECUTABLE };
+	for (int i = 0; i < 2; i++) {
+		lua_getfield(L, optionsIndex, protectNames[i]);
+		if (lua_isboolean(L, -1)) {
+			filter.requireProtect &= ~protectBits[i];
+			filter.excludeProtect &= ~protectBits[i];
+			if (lua_toboolean(L, -1)) {
+				filter.requireProtect |= protectBits[i];
+			} else {
+				filter.excludeProtect |= protectBits[i];
+			}
+		} else if (!lua_isnil(L, -1)) {
+			luaL_error(L, "%s must be a boolean", protectNames[i]);
+			return false;
+		}
+		lua_pop(L, 1);
+	}
+
+	lua_getfield(L, optionsIndex, "minAddress");
+	if (lua_isnumber(L, -1)) {
+		filter.minAddress = (uintptr_t)lua_tointeger(L, -1);
+	}
+	lua_pop(L, 1);
+
+	lua_getfield(L, optionsIndex, "maxAddress");
+	if (lua_isnumber(L, -1)) {
+		filter.maxAddress = (uintptr_t)lua_tointeger(L, -1);
+	}
+	lua_pop(L, 1);
+
+	if (filter.minAddress >= filter.maxAddress) {
+		luaL_error(L, "minAddress must be below maxAddress");
+		return false;
+	}
+
+	lua_getfield(L, optionsIndex, "modules");
+	if (!lua_isnil(L, -1) && !parseStringList(L, lua_gettop(L), "modules", filter.modules)) {
+		return false;
+	}
+	lua_pop(L, 1);
+
+	lua_getfield(L, optionsIndex, "excludeModules");
+	if (!lua_isnil(L, -1) && !parseStringList(L, lua_gettop(L), "excludeModules", filter.excludeModules)) {
+		return false;
+	}
+	lua_pop(L, 1);
+
+	return true;
+}
+
+// Apply the per-scan options (region filter, epsilon, bitmap, writeWatch, inPlace, regions). Options not given reset on every call
+bool parseScanOptions(lua_State* L, int optionsIndex, Scanner* scanner) {
+	BasicScanner* basicScanner = dynamic_cast<BasicScanner*>(scanner);
+	if (basicScanner) {
+		basicScanner->resetEpsilon();
+		basicScanner->setBitmapResults(false);
+		basicScanner->setWriteWatch(false);
+	}
+	scanner->setInPlaceScan(true);
+
+	if (!lua_istable(L, optionsIndex)) {
+		scanner->clearScanRanges();
+		scanner->resetRegionFilter();
+		return true;
+	}
+
+	// Region filter keys override the scanner defaults for this scan
+	RegionFilter filter = scanner->getDefaultRegionFilter();
+	if (!parseRegionFilter(L, optionsIndex, filter)) {
+		return false;
+	}
+	scanner->setRegionFilter(filter);
+
+	lua_pushstring(L, "epsilon");
+	lua_gettable(L, optionsIndex);
+	if (lua_isnumber(L, -1)) {
+		double value = lua_tonumber(L, -1);
+		bool isFloatType = basicScanner &&
+			(basicScanner->getDataType() == BasicScanner::DataType::FLOAT ||
+			 basicScanner->getDataType() == BasicScanner::DataType::DOUBLE);
+		if (!isFloatType) {
+			luaL_error(L, "epsilon is only supported for FLOAT and DOUBLE scanners");
+			return false;
+		}
+		if (!basicScanner->setEpsilon(value)) {
+			luaL_error(L, "epsilon must be positive, got: %f", value);
+			return false;
+		}
+	}
+	lua_pop(L, 1);
+
+	// Keep first scan results as a bitmap until they get sparse
+	lua_pushstring(L, "bitmap");
+	lua_gettable(L, optionsIndex);
+	if (lua_toboolean(L, -1)) {
+		if (!basicScanner) {
+			luaL_error(L, "bitmap is only supported for basic scanners");
+			return false;
+		}
+		basicScanner->setBitmapResults(true);
+	}
+	lua_pop(L, 1);
+
+	// Track writes to MEM_WRITE_WATCH memory after UNKNOWN first scans
+	lua_pushstring(L, "writeWatch");
+	lua_gettable(L, optionsIndex);
+	if (lua_toboolean(L, -1)) {
+		if (!basicScanner) {
+			luaL_error(L, "writeWatch is only supported for basic scanners");
+			return false;
+		}
+		basicScanner->setWriteWatch(true);
+	}
+	lua_pop(L, 1);
+
+	// Chunks are scanned in place unless inPlace = false copies them first
+	lua_pushstring(L, "inPlace");
+	lua_gettable(L, optionsIndex);
+	if (lua_isboolean(L, -1)) {
+		scanner->setInPlaceScan(lua_toboolean(L, -1) != 0);
+	}
+	lua_pop(L, 1);
+
+	// Regions reset to all memory unless given for this scan
+	// Array of {base = address, size = bytes}
+	std::vector<MemoryRegion, ScannerAllocator<MemoryRegion>> ranges;
+	lua_pushstring(L, "regions");
+	lua_gettable(L, optionsIndex);
+	if (!lua_isnil(L, -1)) {
+		if (!lua_istable(L, -1)) {
+			luaL_error(L, "regions must be a table of {base = address, size = bytes}");
+			return false;
+		}
+
+		int regionsIndex = lua_gettop(L);
+		size_t count = lua_objlen(L, regionsIndex);
+		for (size_t i = 1; i <= count; i++) {
+			lua_rawgeti(L, regionsIndex, (int)i);
+			if (!lua_istable(L, -1)) {
+				luaL_error(L, "regions[%d] must be a table of {base = address, size = bytes}", (int)i);
+				return false;
+			}
+
+			lua_getfield(L, -1, "base");
+			lua_getfield(L, -2, "size");
+			if (!lua_isnumber(L, -2) || !lua_isnumber(L, -1)) {
+				luaL_error(L, "regions[%d] requires numeric base and size", (int)i);
+				return false;
+			}
+			uintptr_t base = (uintptr_t)lua_tointeger(L, -2);
+			size_t size = (size_t)lua_tointeger(L, -1);
+			if (base + size < base) {
+				luaL_error(L, "regions[%d] wraps past the end of the address space", (int)i);
+				return false;
+			}
+			ranges.emplace_back(base, size);
+			lua_pop(L, 3);
+		}
+
+		if (ranges.empty()) {
+			luaL_error(L, "regions cannot be empty");
+			return false;
+		}
+	}
+	lua_pop(L, 1);
+	scanner->setScanRanges(ranges);
+
+	return true;
+}
+
 // Push a basic type value to Lua stack
 void pushBasicValueToLua(lua_State* L, const ScanResult& result, BasicScanner::DataType dataType) {
 	switch (dataType) {
@@ -249,7 +562,7 @@ void pushBasicValueToLua(lua_State* L, const ScanResult& result, BasicScanner::D
 			lua_pushnumber(L, result.value.doubleValue);
 			break;
 		case BasicScanner::DataType::BOOL:
-			lua_pushboolean(L, result.value.boolValue);
+			lua_pushboolean(L, result.value.byteValue != 0);
 			break;
 		default:
 			lua_pushnil(L);
@@ -257,6 +570,41 @@ void pushBasicValueToLua(lua_State* L, const ScanResult& result, BasicScanner::D
 	}
 }
 
+// Add the bytes each region filter removed in the last first scan as the
+// regionStats field of the table on top of the stack
+void pushRegionFilterStats(lua_State* L, Scanner* scanner) {
+	const RegionFilterStats& stats = scanner->getRegionFilterStats();
+
+	lua_pushstring(L, "regionStats");
+	lua_newtable(L);
+
+	lua_pushstring(L, "scannedBytes");
+	lua_pushnumber(L, (lua_Number)stats.scannedBytes);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "removedByType");
+	lua_pushnumber(L, (lua_Number)stats.typeBytes);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "removedByProtection");
+	lua_pushnumber(L, (lua_Number)stats.protectionBytes);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "removedByModule");
+	lua_pushnumber(L, (lua_Number)stats.moduleBytes);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "removedByAddress");
+	lua_pushnumber(L, (lua_Number)stats.addressBytes);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "removedByRegions");
+	lua_pushnumber(L, (lua_Number)stats.rangeBytes);
+	lua_rawset(L, -3);
+
+	lua_rawset(L, -3);
+}
+
 // Push byte sequence to Lua as string or table based on SequenceScanner::DataType
 void pushBytesToLua(lua_State* L, const std::vector<uint8_t, ScannerAllocator<uint8_t>>& bytes, SequenceScanner::DataType dataType) {
 	if (dataType == SequenceScanner::DataType::STRING) {
@@ -307,6 +655,18 @@ void pushSequenceValueToLua(lua_State* L, Scanner* scanner, const ScanResult& re
 	}
 }
 
+// Add the per pattern result counts to the table on top of the stack
+void pushPatternResultCounts(lua_State* L, MultiSequenceScanner* multiScanner) {
+	lua_pushstring(L, "patternResultCounts");
+	lua_newtable(L);
+	for (size_t i = 0; i < multiScanner->getPatternCount(); i++) {
+		lua_pushinteger(L, (lua_Integer)(i + 1));  // Lua 1-indexed
+		lua_pushinteger(L, (lua_Integer)multiScanner->getPatternResultCount(i));
+		lua_rawset(L, -3);
+	}
+	lua_rawset(L, -3);
+}
+
 int scanner_create(lua_State* L) {
 	// Get data type
 	const char* dataTypeStr = luaL_checkstring(L, 1);
@@ -316,6 +676,7 @@ int scanner_create(lua_State* L) {
 	size_t maxResults = 100000;
 	size_t alignment = 0;
 	bool checkTiming = false;
+	RegionFilter regionFilter;
 
 	if (lua_istable(L, 2)) {
 		lua_pushstring(L, "maxResults");
@@ -350,6 +711,11 @@ int scanner_create(lua_State* L) {
 			checkTiming = lua_toboolean(L, -1);
 		}
 		lua_pop(L, 1);
+
+		// Default region filter for every scan
+		if (!parseRegionFilter(L, 2, regionFilter)) {
+			return 0; // Error already pushed
+		}
 	}
 
 	// Create appropriate scanner based on data type
@@ -366,12 +732,24 @@ int scanner_create(lua_State* L) {
 		if (parseSequenceDataType(dataTypeStr, seqType)) {
 			scanner = SequenceScanner::create(seqType, maxResults, alignment);
 		}
+		// Try multi sequence types
+		else if (parseMultiSequenceDataType(dataTypeStr, seqType)) {
+			scanner = MultiSequenceScanner::create(seqType, maxResults, alignment);
+		}
 		// Try struct type
 		else if (lower == "struct") {
 			scanner = StructScanner::create(maxResults, alignment);
 		}
+		// Try pointer type
+		else if (lower == "pointer") {
+			scanner = PointerScanner::create(maxResults, alignment);
+		}
+		// Try vtable type
+		else if (lower == "vtable") {
+			scanner = VtableScanner::create(maxResults, alignment);
+		}
 		else {
-			luaL_error(L, "Invalid data type: %s (valid: BYTE, INT, FLOAT, DOUBLE, BOOL, STRING, BYTE_ARRAY, STRUCT)", dataTypeStr);
+			luaL_error(L, "Invalid data type: %s (valid: BYTE, INT, FLOAT, DOUBLE, BOOL, STRING, BYTE_ARRAY, PATTERN, MULTI_STRING, MULTI_BYTE_ARRAY, STRUCT, POINTER, VTABLE)", dataTypeStr);
 			return 0;
 		}
 	}
@@ -382,6 +760,7 @@ int scanner_create(lua_State* L) {
 
 	// Set timing option
 	scanner->setCheckTiming(checkTiming);
+	scanner->setDefaultRegionFilter(regionFilter);
 
 	// Set metatable for garbage collection
 	luaL_getmetatable(L, "Scanner");
@@ -389,142 +768,362 @@ int scanner_create(lua_State* L) {
 	return 1;
 }
 
-int scanner_first_scan(lua_State* L) {
-	// Creates Scanner*
-	GET_SCANNER(L, 1);
+bool checkScannerIdle(lua_State* L, Scanner* scanner) {
+	if (!scanner->hasAsyncJob()) {
+		return true;
+	}
+	if (!scanner->isAsyncDone()) {
+		luaL_error(L, "Scanner is busy with a background scan - poll isDone() or cancel() it first");
+		return false;
+	}
+	scanner->finishAsync();
+	logScannerErrors(L, scanner, "background scan");
+	return true;
+}
+
+LuaScanJob::LuaScanJob(const LuaScanJob& other) :
+	isRescan(other.isRescan), scanType(other.scanType), basicValue(other.basicValue), bytes(other.bytes),
+	pattern(other.pattern), patterns(other.patterns), target(other.target), targetSize(other.targetSize)
+{
+	if (other.target == &other.basicValue.value) {
+		target = &basicValue.value;
+	} else if (other.target == &other.pattern) {
+		target = &pattern;
+	} else if (other.target == &other.patterns) {
+		target = &patterns;
+	} else if (other.target != nullptr && other.target == other.bytes.data()) {
+		target = bytes.data();
+	}
+}
+
+void LuaScanJob::run(Scanner* scanner) {
+	if (isRescan) {
+		scanner->rescan(scanType, target, targetSize);
+	} else {
+		scanner->firstScan(scanType, target, targetSize);
+	}
+}
+
+bool parseScanJob(lua_State* L, Scanner* scanner, LuaScanJob& job) {
+	// Pointer maps have no target value
+	if (dynamic_cast<PointerScanner*>(scanner)) {
+		luaL_error(L, "POINTER scanners use buildPointerMap and findPointerChains");
+		return false;
+	}
+	if (dynamic_cast<VtableScanner*>(scanner)) {
+		luaL_error(L, "VTABLE scanners use buildCensus, countByVtable and instancesOf");
+		return false;
+	}
 
 	// Second arg is the scan type
 	const char* scanTypeStr = luaL_checkstring(L, 2);
-	ScanType scanType;
-	if (!parseScanType(scanTypeStr, scanType)) {
-		luaL_error(L, "Invalid scan type: %s (valid: EXACT, NOT, INCREASED, DECREASED, CHANGED, UNCHANGED)", scanTypeStr);
-		return 0;
+	if (!parseScanType(scanTypeStr, job.scanType)) {
+		luaL_error(L, "Invalid scan type: %s (valid: EXACT, NOT, INCREASED, DECREASED, CHANGED, UNCHANGED, UNKNOWN)", scanTypeStr);
+		return false;
+	}
+
+	// UNKNOWN takes no target and snapshots memory instead
+	BasicScanner* basicScanner = dynamic_cast<BasicScanner*>(scanner);
+	const bool unknown = !job.isRescan && job.scanType == ScanType::UNKNOWN;
+	if (unknown && !basicScanner) {
+		luaL_error(L, "UNKNOWN first scans are only supported for basic scanners");
+		return false;
 	}
 
 	// Third arg is the target value
-	if (lua_isnil(L, 3)) {
+	if (lua_isnil(L, 3) && !unknown) {
 		luaL_error(L, "Target value required for scanning");
-		return 0;
+		return false;
+	}
+
+	// Optional fourth arg is the per-scan options table
+	if (!parseScanOptions(L, 4, scanner)) {
+		return false; // Error already pushed
 	}
 
 	// Determine scanner type and parse accordingly
-	BasicScanner* basicScanner = dynamic_cast<BasicScanner*>(scanner);
 	SequenceScanner* seqScanner = dynamic_cast<SequenceScanner*>(scanner);
+	MultiSequenceScanner* multiScanner = dynamic_cast<MultiSequenceScanner*>(scanner);
 
-	if (basicScanner) {
-		ScanResult targetResult;
-		if (!parseBasicValue(L, 3, basicScanner->getDataType(), targetResult)) {
-			return 0; // Error already pushed
+	if (unknown) {
+		job.target = nullptr;
+	} else if (basicScanner) {
+		if (!parseBasicValue(L, 3, basicScanner->getDataType(), job.basicValue)) {
+			return false; // Error already pushed
+		}
+		job.target = &job.basicValue.value;
+	} else if (seqScanner && seqScanner->getDataType() == SequenceScanner::DataType::PATTERN) {
+		if (!parsePatternValue(L, 3, job.pattern)) {
+			return false; // Error already pushed
 		}
-		scanner->firstScan(scanType, &targetResult.value);
+		job.target = &job.pattern;
+		job.targetSize = job.pattern.bytes.size();
 	} else if (seqScanner) {
 		const void* data;
-		size_t size;
-		std::vector<uint8_t, ScannerAllocator<uint8_t>> bytesBuffer;
-
-		if (!parseSequenceValue(L, 3, seqScanner->getDataType(), data, size, bytesBuffer)) {
-			return 0; // Error already pushed
+		if (!parseSequenceValue(L, 3, seqScanner->getDataType(), data, job.targetSize, job.bytes)) {
+			return false; // Error already pushed
+		}
+		// Strings point into the Lua string, which a background scan can outlive
+		if (data != job.bytes.data()) {
+			job.bytes.assign((const uint8_t*)data, (const uint8_t*)data + job.targetSize);
+		}
+		job.target = job.bytes.data();
+	} else if (multiScanner) {
+		if (!parsePatternList(L, 3, multiScanner->getDataType(), job.patterns)) {
+			return false; // Error already pushed
 		}
-		scanner->firstScan(scanType, data, size);
+		job.target = &job.patterns;
 	} else if (dynamic_cast<StructScanner*>(scanner)) {
 		StructScanner::StructSearch** structPtr = (StructScanner::StructSearch**)lua_testudata(L, 3, "StructSearch");
 		if (!structPtr || !*structPtr) {
 			luaL_error(L, "Struct scanner requires StructSearch as target value");
-			return 0;
+			return false;
 		}
-		scanner->firstScan(scanType, *structPtr);
+		job.target = *structPtr;
 	} else {
 		luaL_error(L, "Unknown scanner type");
-		return 0;
+		return false;
 	}
+	return true;
+}
 
-	// Log any errors
-	logScannerErrors(L, scanner, "first scan");
-
-	// Return results table
+void pushScanSummary(lua_State* L, Scanner* scanner, bool firstScan) {
 	lua_newtable(L);
 
 	lua_pushstring(L, "resultCount");
 	lua_pushinteger(L, scanner->getResultCount());
 	lua_rawset(L, -3);
 
-	lua_pushstring(L, "maxResultsReached");
-	lua_pushboolean(L, scanner->isMaxResultsReached());
-	lua_rawset(L, -3);
+	if (firstScan) {
+		lua_pushstring(L, "maxResultsReached");
+		lua_pushboolean(L, scanner->isMaxResultsReached());
+		lua_rawset(L, -3);
 
-	return 1;
+		pushRegionFilterStats(L, scanner);
+	}
+
+	MultiSequenceScanner* multiScanner = dynamic_cast<MultiSequenceScanner*>(scanner);
+	if (multiScanner) {
+		pushPatternResultCounts(L, multiScanner);
+	}
 }
 
-int scanner_rescan(lua_State* L) {
+int scanner_first_scan(lua_State* L) {
 	// Creates Scanner*
-	GET_SCANNER(L, 1);
+	GET_IDLE_SCANNER(L, 1);
 
-	// Second arg is the scan type
-	const char* scanTypeStr = luaL_checkstring(L, 2);
-	ScanType scanType;
-	if (!parseScanType(scanTypeStr, scanType)) {
-		luaL_error(L, "Invalid scan type: %s (valid: EXACT, NOT, INCREASED, DECREASED, CHANGED, UNCHANGED)", scanTypeStr);
-		return 0;
+	LuaScanJob job(false);
+	if (!parseScanJob(L, scanner, job)) {
+		return 0; // Error already pushed
 	}
+	job.run(scanner);
 
-	// Third arg is the target value
-	if (lua_isnil(L, 3)) {
-		luaL_error(L, "Target value required for scanning");
-		return 0;
-	}
+	// Log any errors
+	logScannerErrors(L, scanner, "first scan");
 
-	// Determine scanner type and parse accordingly
-	BasicScanner* basicScanner = dynamic_cast<BasicScanner*>(scanner);
-	SequenceScanner* seqScanner = dynamic_cast<SequenceScanner*>(scanner);
+	// Return results table
+	pushScanSummary(L, scanner, true);
+	return 1;
+}
 
-	if (basicScanner) {
-		ScanResult targetResult;
-		if (!parseBasicValue(L, 3, basicScanner->getDataType(), targetResult)) {
-			return 0; // Error already pushed
-		}
-		scanner->rescan(scanType, &targetResult.value);
-	} else if (seqScanner) {
-		const void* data;
-		size_t size;
-		std::vector<uint8_t, ScannerAllocator<uint8_t>> bytesBuffer;
+int scanner_rescan(lua_State* L) {
+	// Creates Scanner*
+	GET_IDLE_SCANNER(L, 1);
 
-		if (!parseSequenceValue(L, 3, seqScanner->getDataType(), data, size, bytesBuffer)) {
-			return 0; // Error already pushed
-		}
-		scanner->rescan(scanType, data, size);
-	} else if (dynamic_cast<StructScanner*>(scanner)) {
-		StructScanner::StructSearch** structPtr = (StructScanner::StructSearch**)lua_testudata(L, 3, "StructSearch");
-		if (!structPtr || !*structPtr) {
-			luaL_error(L, "Struct scanner requires StructSearch as target value");
-			return 0;
-		}
-		scanner->rescan(scanType, *structPtr);
-	} else {
-		luaL_error(L, "Unknown scanner type");
-		return 0;
+	LuaScanJob job(true);
+	if (!parseScanJob(L, scanner, job)) {
+		return 0; // Error already pushed
 	}
+	job.run(scanner);
 
 	// Log any errors
 	logScannerErrors(L, scanner, "rescan");
 
 	// Return results table
-	lua_newtable(L);
+	pushScanSummary(L, scanner, false);
+	return 1;
+}
 
-	lua_pushstring(L, "resultCount");
-	lua_pushinteger(L, scanner->getResultCount());
-	lua_rawset(L, -3);
+// Same args as firstScan/rescan but the scan runs on a worker thread and
+// this returns right away. Poll isDone() and getProgress() until it finishes
+int startScanAsync(lua_State* L, bool rescan) {
+	// Creates Scanner*
+	GET_IDLE_SCANNER(L, 1);
+
+	// The StructSearch is owned by Lua and can change while the scan runs
+	if (dynamic_cast<StructScanner*>(scanner)) {
+		luaL_error(L, "Background scans are not supported for struct scanners");
+		return 0;
+	}
 
+	// Parsed on the stack since parse errors longjmp out. The worker gets a copy
+	LuaScanJob job(rescan);
+	if (!parseScanJob(L, scanner, job)) {
+		return 0; // Error already pushed
+	}
+
+	bool started = scanner->startAsync(new LuaScanJob(job));
+	if (!started) {
+		logScannerErrors(L, scanner, rescan ? "rescan" : "first scan");
+	}
+	lua_pushboolean(L, started);
 	return 1;
 }
 
-int scanner_get_results(lua_State* L) {
+int scanner_first_scan_async(lua_State* L) {
+	return startScanAsync(L, false);
+}
+
+int scanner_rescan_async(lua_State* L) {
+	return startScanAsync(L, true);
+}
+
+// Returns done and, once the background scan finished, the same summary
+// table as firstScan or rescan (plus cancelled). Errors are logged when it
+// is collected
+int scanner_is_done(lua_State* L) {
 	// Creates Scanner*
 	GET_SCANNER(L, 1);
 
-	// Read optional offset, limit, and readValues from table or individual args
-	size_t offset = 0;
-	size_t limit = 1000;
-	bool readValues = false;
+	if (scanner->hasAsyncJob() && !scanner->isAsyncDone()) {
+		lua_pushboolean(L, false);
+		return 1;
+	}
+
+	// Read before collecting since that deletes the job
+	bool collected = scanner->hasAsyncJob();
+	const LuaScanJob* job = dynamic_cast<const LuaScanJob*>(scanner->getAsyncJob());
+	bool firstScan = job != nullptr && !job->isRescan;
+	checkScannerIdle(L, scanner);
+
+	lua_pushboolean(L, true);
+	if (!collected) {
+		return 1;
+	}
+
+	pushScanSummary(L, scanner, firstScan);
+
+	lua_pushstring(L, "cancelled");
+	lua_pushboolean(L, scanner->wasCancelled());
+	lua_rawset(L, -3);
+
+	return 2;
+}
+
+// Progress of the running or last scan
+// Returns {done, total, unit = "bytes" or "results", results, cancelled, running}
+int scanner_get_progress(lua_State* L) {
+	// Creates Scanner*
+	GET_SCANNER(L, 1);
+
+	ScanProgress progress = scanner->getProgress();
+
+	lua_newtable(L);
+
+	lua_pushstring(L, "done");
+	lua_pushnumber(L, (lua_Number)progress.done);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "total");
+	lua_pushnumber(L, (lua_Number)progress.total);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "unit");
+	lua_pushstring(L, progress.countsBytes ? "bytes" : "results");
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "results");
+	lua_pushinteger(L, (lua_Integer)progress.results);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "cancelled");
+	lua_pushboolean(L, progress.cancelled);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "running");
+	lua_pushboolean(L, (scanner->hasAsyncJob() && !scanner->isAsyncDone()) || scanner->isStepScanActive());
+	lua_rawset(L, -3);
+
+	return 1;
+}
+
+// Ask a background scan to stop. isDone() still has to be polled
+// Stepped scans are dropped right away
+int scanner_cancel(lua_State* L) {
+	// Creates Scanner*
+	GET_SCANNER(L, 1);
+
+	scanner->cancel();
+	return 0;
+}
+
+// Same args as firstScan but only sets up the scan. step() then scans on
+// the Lua thread a time budget at a time, i.e. from a per frame event
+int scanner_first_scan_stepped(lua_State* L) {
+	// Creates Scanner*
+	GET_IDLE_SCANNER(L, 1);
+
+	// The StructSearch is owned by Lua and can change between steps
+	if (dynamic_cast<StructScanner*>(scanner)) {
+		luaL_error(L, "Stepped scans are not supported for struct scanners");
+		return 0;
+	}
+
+	// Parsed on the stack since parse errors longjmp out. The scanner keeps a copy
+	LuaScanJob job(false);
+	if (!parseScanJob(L, scanner, job)) {
+		return 0; // Error already pushed
+	}
+
+	LuaScanJob* owner = new LuaScanJob(job);
+	bool started = scanner->beginStepScan(owner->scanType, owner->target, owner->targetSize, owner);
+
+	// Logged now so they aren't repeated when the scan finishes
+	logScannerErrors(L, scanner, "first scan");
+	scanner->clearErrors();
+
+	lua_pushboolean(L, started);
+	return 1;
+}
+
+// Args are (scanner, budgetMicroseconds)
+// Returns done and, once the scan finished, the same table as firstScan
+int scanner_step(lua_State* L) {
+	// Creates Scanner*
+	GET_IDLE_SCANNER(L, 1);
+
+	if (!scanner->isStepScanActive()) {
+		luaL_error(L, "No stepped scan in progress - call firstScanStepped first");
+		return 0;
+	}
+
+	lua_Integer budget = luaL_checkinteger(L, 2);
+	if (budget <= 0) {
+		luaL_error(L, "budget must be positive, got: %d", (int)budget);
+		return 0;
+	}
+
+	if (!scanner->stepScan((uint64_t)budget)) {
+		lua_pushboolean(L, false);
+		return 1;
+	}
+
+	logScannerErrors(L, scanner, "first scan");
+
+	lua_pushboolean(L, true);
+	pushScanSummary(L, scanner, true);
+	return 2;
+}
+
+int scanner_get_results(lua_State* L) {
+	// Creates Scanner*
+	GET_IDLE_SCANNER(L, 1);
+
+	// Read optional offset, limit, and readValues from table or individual args
+	size_t offset = 0;
+	size_t limit = 1000;
+	bool readValues = false;
+	size_t pattern = 0; // 1-indexed. 0 = results for every pattern
 
 	if (lua_istable(L, 2)) {
 		lua_pushstring(L, "offset");
@@ -559,19 +1158,53 @@ int scanner_get_results(lua_State* L) {
 			readValues = lua_toboolean(L, -1);
 		}
 		lua_pop(L, 1);
-	}
 
-	const std::vector<ScanResult, ScannerAllocator<ScanResult>>& results = scanner->getResults();
-	size_t totalCount = results.size();
+		lua_pushstring(L, "pattern");
+		lua_gettable(L, 2);
+		if (lua_isnumber(L, -1)) {
+			lua_Integer value = lua_tointeger(L, -1);
+			if (value > 0) {
+				pattern = (size_t)value;
+			} else {
+				luaL_error(L, "pattern must be positive, got: %d", (int)value);
+				return 0;
+			}
+		}
+		lua_pop(L, 1);
+	}
 
 	// Determine scanner type upfront to avoid repeated checks in loop
 	BasicScanner* basicScanner = dynamic_cast<BasicScanner*>(scanner);
 	SequenceScanner* seqScanner = dynamic_cast<SequenceScanner*>(scanner);
+	MultiSequenceScanner* multiScanner = dynamic_cast<MultiSequenceScanner*>(scanner);
 	StructScanner* structScanner = dynamic_cast<StructScanner*>(scanner);
+	PointerScanner* pointerScanner = dynamic_cast<PointerScanner*>(scanner);
+	VtableScanner* vtableScanner = dynamic_cast<VtableScanner*>(scanner);
+
+	// Bitmap results are not a list so the requested page is built from the bitmap
+	const bool bitmapMode = basicScanner && basicScanner->isBitmapMode();
+	const ResultStore& results = scanner->getResults();
+	ResultStore bitmapPage;
+	size_t totalCount = scanner->getResultCount();
+
+	// Page through a single pattern's results for multi sequence scanners
+	const MultiSequenceScanner::IndexList* patternIndices = nullptr;
+	if (pattern > 0) {
+		if (!multiScanner) {
+			luaL_error(L, "pattern is only supported for multi sequence scanners");
+			return 0;
+		}
+		if (pattern > multiScanner->getPatternCount()) {
+			luaL_error(L, "pattern %d out of range (scanner has %d patterns)", (int)pattern, (int)multiScanner->getPatternCount());
+			return 0;
+		}
+		patternIndices = &multiScanner->getPatternResultIndices(pattern - 1);
+		totalCount = patternIndices->size();
+	}
 
 	// Validate readValues request based on scanner type
 	if (readValues) {
-		if (seqScanner) {
+		if (seqScanner || multiScanner) {
 			ScanType lastScanType = scanner->getLastScanType();
 			// For sequence scanners, only NOT scans have meaningful, readable values
 			if (lastScanType != ScanType::NOT) {
@@ -595,10 +1228,13 @@ int scanner_get_results(lua_State* L) {
 
 	size_t startIdx = offset;
 	size_t endIdx = std::min<size_t>(offset + limit, totalCount);
+	if (bitmapMode && startIdx < endIdx) {
+		basicScanner->getBitmapPage(startIdx, endIdx - startIdx, bitmapPage);
+	}
 
 	// Build results array
 	for (size_t i = startIdx; i < endIdx; i++) {
-		const ScanResult& result = results[i];
+		ScanResult result = bitmapMode ? bitmapPage[i - startIdx] : results[patternIndices ? (*patternIndices)[i] : i];
 
 		// Lua 1-indexed
 		lua_pushinteger(L, (lua_Integer)(i - startIdx + 1));
@@ -609,6 +1245,13 @@ int scanner_get_results(lua_State* L) {
 		lua_pushinteger(L, (lua_Integer)result.address);
 		lua_rawset(L, -3);
 
+		// Add the matched pattern for multi sequence scanners (Lua 1-indexed)
+		if (multiScanner) {
+			lua_pushstring(L, "pattern");
+			lua_pushinteger(L, (lua_Integer)(MultiSequenceScanner::getResultPattern(result) + 1));
+			lua_rawset(L, -3);
+		}
+
 		// Add value field if we are reading the results
 		if (readValues) {
 			lua_pushstring(L, "value");
@@ -619,6 +1262,17 @@ int scanner_get_results(lua_State* L) {
 			} else if (seqScanner) {
 				// Sequence scanner need to read from memory
 				pushSequenceValueToLua(L, scanner, result, seqScanner->getDataType(), true);
+			} else if (pointerScanner || vtableScanner) {
+				// Pointer scanners store the pointee and vtable scanners the vtable
+				lua_pushinteger(L, (lua_Integer)result.value.pointerValue);
+			} else if (multiScanner) {
+				// Multi sequence scanner reads the length of the pattern it matched
+				MultiSequenceScanner::Pattern bytes;
+				if (multiScanner->readPatternBytes(result.address, MultiSequenceScanner::getResultPattern(result), bytes)) {
+					pushBytesToLua(L, bytes, multiScanner->getDataType());
+				} else {
+					lua_pushnil(L);
+				}
 			} else {
 				// Other scanners (i.e. struct) don't have meaningful reads and we shouldn't have
 				// gotten here but have this just in case
@@ -645,12 +1299,47 @@ int scanner_get_results(lua_State* L) {
 	lua_pushinteger(L, (lua_Integer)limit);
 	lua_rawset(L, -3);
 
+	// Memory held by the result columns or bitmap
+	lua_pushstring(L, "resultBytes");
+	lua_pushinteger(L, (lua_Integer)(bitmapMode ? basicScanner->getBitmapMemoryUsage() : results.getMemoryUsage()));
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "bitmap");
+	lua_pushboolean(L, bitmapMode);
+	lua_rawset(L, -3);
+
+	// Compressed snapshot kept by UNKNOWN first scans
+	lua_pushstring(L, "snapshotBytes");
+	lua_pushinteger(L, (lua_Integer)(bitmapMode ? basicScanner->getSnapshotMemoryUsage() : 0));
+	lua_rawset(L, -3);
+
+	// Ranges whose write watch lets rescans skip clean chunks
+	lua_pushstring(L, "writeWatchRanges");
+	lua_pushinteger(L, (lua_Integer)(bitmapMode ? basicScanner->getWriteWatchRangeCount() : 0));
+	lua_rawset(L, -3);
+
 	return 1;
 }
 
 int scanner_get_result_count(lua_State* L) {
 	// Creates Scanner*
-	GET_SCANNER(L, 1);
+	GET_IDLE_SCANNER(L, 1);
+
+	// Optional pattern (1-indexed) for multi sequence scanners
+	if (lua_isnumber(L, 2)) {
+		MultiSequenceScanner* multiScanner = dynamic_cast<MultiSequenceScanner*>(scanner);
+		if (!multiScanner) {
+			luaL_error(L, "pattern is only supported for multi sequence scanners");
+			return 0;
+		}
+		lua_Integer pattern = lua_tointeger(L, 2);
+		if (pattern <= 0 || (size_t)pattern > multiScanner->getPatternCount()) {
+			luaL_error(L, "pattern %d out of range (scanner has %d patterns)", (int)pattern, (int)multiScanner->getPatternCount());
+			return 0;
+		}
+		lua_pushinteger(L, (lua_Integer)multiScanner->getPatternResultCount((size_t)pattern - 1));
+		return 1;
+	}
 
 	lua_pushinteger(L, scanner->getResultCount());
 	return 1;
@@ -658,7 +1347,7 @@ int scanner_get_result_count(lua_State* L) {
 
 int scanner_reset(lua_State* L) {
 	// Creates Scanner*
-	GET_SCANNER(L, 1);
+	GET_IDLE_SCANNER(L, 1);
 
 	scanner->reset();
 	return 0;
@@ -669,12 +1358,336 @@ int scanner_destroy(lua_State* L) {
 	Scanner** scannerPtr = (Scanner**)luaL_checkudata(L, 1, "Scanner");
 	if (*scannerPtr != nullptr) {
 		log(L, "Scanner: Destroyed");
+		(*scannerPtr)->cancel();
+		(*scannerPtr)->finishAsync();
 		delete *scannerPtr;
 		*scannerPtr = nullptr;
 	}
 	return 0;
 }
 
+// Sweep memory for every pointer and build the reverse pointer map
+// Optional options table takes the same regions option as firstScan
+int scanner_build_pointer_map(lua_State* L) {
+	// Creates Scanner*
+	GET_SCANNER(L, 1);
+
+	PointerScanner* pointerScanner = dynamic_cast<PointerScanner*>(scanner);
+	if (!pointerScanner) {
+		luaL_error(L, "buildPointerMap is only supported for POINTER scanners");
+		return 0;
+	}
+
+	if (!parseScanOptions(L, 2, scanner)) {
+		return 0; // Error already pushed
+	}
+
+	pointerScanner->buildPointerMap();
+	logScannerErrors(L, scanner, "build pointer map");
+
+	lua_newtable(L);
+
+	lua_pushstring(L, "pointerCount");
+	lua_pushinteger(L, (lua_Integer)scanner->getResultCount());
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "maxResultsReached");
+	lua_pushboolean(L, scanner->isMaxResultsReached());
+	lua_rawset(L, -3);
+
+	pushRegionFilterStats(L, scanner);
+
+	return 1;
+}
+
+// Save the pointer map for PointerMap.load
+int scanner_save_pointer_map(lua_State* L) {
+	// Creates Scanner*
+	GET_SCANNER(L, 1);
+
+	PointerScanner* pointerScanner = dynamic_cast<PointerScanner*>(scanner);
+	if (!pointerScanner) {
+		luaL_error(L, "savePointerMap is only supported for POINTER scanners");
+		return 0;
+	}
+
+	const char* path = luaL_checkstring(L, 2);
+	bool saved = pointerScanner->saveMap(path);
+	logScannerErrors(L, scanner, "save pointer map");
+
+	lua_pushboolean(L, saved);
+	return 1;
+}
+
+// Find static base to target chains in the pointerChain format
+int scanner_find_pointer_chains(lua_State* L) {
+	// Creates Scanner*
+	GET_IDLE_SCANNER(L, 1);
+
+	const PointerMapView* view = checkPointerMapView(L, 1);
+	return findPointerChains(L, *view, dynamic_cast<PointerScanner*>(scanner));
+}
+
+const PointerMapView* checkPointerMapView(lua_State* L, int index) {
+	PointerMapFile** filePtr = (PointerMapFile**)lua_testudata(L, index, "PointerMap");
+	if (filePtr != nullptr) {
+		if (*filePtr == nullptr || !(*filePtr)->isLoaded()) {
+			luaL_error(L, "PointerMap is not loaded");
+			return nullptr;
+		}
+		return &(*filePtr)->getView();
+	}
+
+	Scanner** scannerPtr = (Scanner**)lua_testudata(L, index, "Scanner");
+	PointerScanner* pointerScanner = scannerPtr ? dynamic_cast<PointerScanner*>(*scannerPtr) : nullptr;
+	if (pointerScanner == nullptr) {
+		luaL_error(L, "Expected a POINTER scanner or PointerMap");
+		return nullptr;
+	}
+	if (pointerScanner->isFirstScan()) {
+		luaL_error(L, "Pointer map has not been built - call buildPointerMap first");
+		return nullptr;
+	}
+	return &pointerScanner->getMapView();
+}
+
+// Args are (map, target, options)
+// Options: maxDepth (default 4), maxOffset (default 0x1000), maxChains (default 1000)
+//   compareWith - array of {map = PointerMap or POINTER scanner, target = address}. Only
+//                 chains that also reach each target through each map are kept
+// Returns an array of {base = address, baseOffset = base - exe base, offsets = {...}}
+int findPointerChains(lua_State* L, const PointerMapView& view, PointerScanner* pointerScanner) {
+	uintptr_t target = (uintptr_t)luaL_checkinteger(L, 2);
+	size_t maxDepth = 4;
+	size_t maxOffset = 0x1000;
+	size_t maxChains = 1000;
+
+	if (lua_istable(L, 3)) {
+		lua_pushstring(L, "maxDepth");
+		lua_gettable(L, 3);
+		if (lua_isnumber(L, -1)) {
+			lua_Integer value = lua_tointeger(L, -1);
+			if (value <= 0 || (size_t)value > MAX_POINTER_DEPTH) {
+				luaL_error(L, "maxDepth must be between 1 and %d, got: %d", (int)MAX_POINTER_DEPTH, (int)value);
+				return 0;
+			}
+			maxDepth = (size_t)value;
+		}
+		lua_pop(L, 1);
+
+		lua_pushstring(L, "maxOffset");
+		lua_gettable(L, 3);
+		if (lua_isnumber(L, -1)) {
+			lua_Integer value = lua_tointeger(L, -1);
+			if (value < 0 || (size_t)value > MAX_POINTER_OFFSET) {
+				luaL_error(L, "maxOffset must be between 0 and %d, got: %d", (int)MAX_POINTER_OFFSET, (int)value);
+				return 0;
+			}
+			maxOffset = (size_t)value;
+		}
+		lua_pop(L, 1);
+
+		lua_pushstring(L, "maxChains");
+		lua_gettable(L, 3);
+		if (lua_isnumber(L, -1)) {
+			lua_Integer value = lua_tointeger(L, -1);
+			if (value <= 0) {
+				luaL_error(L, "maxChains must be positive, got: %d", (int)value);
+				return 0;
+			}
+			maxChains = (size_t)value;
+		}
+		lua_pop(L, 1);
+	}
+
+	PointerMapView::ChainList chains;
+	if (pointerScanner != nullptr) {
+		// Only this search's diagnostics are logged
+		pointerScanner->clearErrors();
+		pointerScanner->findChains(target, maxDepth, maxOffset, maxChains, chains);
+		logScannerErrors(L, pointerScanner, "findPointerChains");
+	} else if (!view.findChains(target, maxDepth, maxOffset, maxChains, chains)) {
+		char logMsg[256];
+		sprintf_s(logMsg, sizeof(logMsg), "Scanner: findPointerChains stopped after visiting %zu slots, some chains may be missing",
+		          MAX_CHAIN_SEARCH_VISITS);
+		log(L, logMsg);
+	}
+
+	if (lua_istable(L, 3)) {
+		lua_pushstring(L, "compareWith");
+		lua_gettable(L, 3);
+		if (lua_istable(L, -1)) {
+			int compareIndex = lua_gettop(L);
+			size_t count = lua_objlen(L, compareIndex);
+			for (size_t i = 1; i <= count && !chains.empty(); i++) {
+				lua_rawgeti(L, compareIndex, (int)i);
+				if (!lua_istable(L, -1)) {
+					luaL_error(L, "compareWith[%d] must be a table of {map = PointerMap, target = address}", (int)i);
+					return 0;
+				}
+
+				lua_getfield(L, -1, "map");
+				const PointerMapView* otherView = checkPointerMapView(L, lua_gettop(L));
+				lua_getfield(L, -2, "target");
+				if (!lua_isnumber(L, -1)) {
+					luaL_error(L, "compareWith[%d] requires a numeric target", (int)i);
+					return 0;
+				}
+				otherView->filterChains(chains, (uintptr_t)lua_tointeger(L, -1));
+				lua_pop(L, 3);
+			}
+		} else if (!lua_isnil(L, -1)) {
+			luaL_error(L, "compareWith must be an array of {map = PointerMap, target = address}");
+			return 0;
+		}
+		lua_pop(L, 1);
+	}
+
+	lua_newtable(L);
+	for (size_t i = 0; i < chains.size(); i++) {
+		const PointerMapView::PointerChain& chain = chains[i];
+
+		lua_pushinteger(L, (lua_Integer)(i + 1));  // Lua 1-indexed
+		lua_newtable(L);
+
+		lua_pushstring(L, "base");
+		lua_pushinteger(L, (lua_Integer)chain.base);
+		lua_rawset(L, -3);
+
+		lua_pushstring(L, "baseOffset");
+		lua_pushinteger(L, (lua_Integer)chain.baseOffset);
+		lua_rawset(L, -3);
+
+		lua_pushstring(L, "offsets");
+		lua_newtable(L);
+		for (size_t j = 0; j < chain.offsets.size(); j++) {
+			lua_pushinteger(L, (lua_Integer)(j + 1));
+			lua_pushinteger(L, (lua_Integer)chain.offsets[j]);
+			lua_rawset(L, -3);
+		}
+		lua_rawset(L, -3);
+
+		lua_rawset(L, -3);
+	}
+
+	return 1;
+}
+
+// Sweep heap memory for every object with a vtable in the exe and group them
+// Optional options table takes the same regions option as firstScan
+int scanner_build_census(lua_State* L) {
+	// Creates Scanner*
+	GET_SCANNER(L, 1);
+
+	VtableScanner* vtableScanner = dynamic_cast<VtableScanner*>(scanner);
+	if (!vtableScanner) {
+		luaL_error(L, "buildCensus is only supported for VTABLE scanners");
+		return 0;
+	}
+
+	if (!parseScanOptions(L, 2, scanner)) {
+		return 0; // Error already pushed
+	}
+
+	vtableScanner->buildCensus();
+	logScannerErrors(L, scanner, "build census");
+
+	lua_newtable(L);
+
+	lua_pushstring(L, "objectCount");
+	lua_pushinteger(L, (lua_Integer)scanner->getResultCount());
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "typeCount");
+	lua_pushinteger(L, (lua_Integer)vtableScanner->getGroups().size());
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "vtableCount");
+	lua_pushinteger(L, (lua_Integer)vtableScanner->getVtableCount());
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "maxResultsReached");
+	lua_pushboolean(L, scanner->isMaxResultsReached());
+	lua_rawset(L, -3);
+
+	pushRegionFilterStats(L, scanner);
+
+	return 1;
+}
+
+// Returns a table of vtable address -> number of live objects
+int scanner_count_by_vtable(lua_State* L) {
+	// Creates Scanner*
+	GET_SCANNER(L, 1);
+
+	VtableScanner* vtableScanner = dynamic_cast<VtableScanner*>(scanner);
+	if (!vtableScanner) {
+		luaL_error(L, "countByVtable is only supported for VTABLE scanners");
+		return 0;
+	}
+	if (vtableScanner->isFirstScan()) {
+		luaL_error(L, "Census has not been taken - call buildCensus first");
+		return 0;
+	}
+
+	const VtableScanner::GroupList& groups = vtableScanner->getGroups();
+	lua_newtable(L);
+	for (const VtableScanner::VtableGroup& group : groups) {
+		lua_pushinteger(L, (lua_Integer)group.vtable);
+		lua_pushinteger(L, (lua_Integer)group.count);
+		lua_rawset(L, -3);
+	}
+	return 1;
+}
+
+// Returns an array of object addresses with the given vtable in address order
+int scanner_instances_of(lua_State* L) {
+	// Creates Scanner*
+	GET_SCANNER(L, 1);
+
+	VtableScanner* vtableScanner = dynamic_cast<VtableScanner*>(scanner);
+	if (!vtableScanner) {
+		luaL_error(L, "instancesOf is only supported for VTABLE scanners");
+		return 0;
+	}
+	if (vtableScanner->isFirstScan()) {
+		luaL_error(L, "Census has not been taken - call buildCensus first");
+		return 0;
+	}
+
+	uintptr_t vtable = (uintptr_t)luaL_checkinteger(L, 2);
+	std::vector<uintptr_t, ScannerAllocator<uintptr_t>> addresses;
+	vtableScanner->getInstances(vtable, addresses);
+
+	lua_newtable(L);
+	for (size_t i = 0; i < addresses.size(); i++) {
+		lua_pushinteger(L, (lua_Integer)(i + 1));  // Lua 1-indexed
+		lua_pushinteger(L, (lua_Integer)addresses[i]);
+		lua_rawset(L, -3);
+	}
+	return 1;
+}
+
+// Returns the active SIMD tier and the best tier the CPU supports
+int scanner_get_simd_level(lua_State* L) {
+	lua_pushstring(L, ScannerSimd::getLevelName(ScannerSimd::getLevel()));
+	lua_pushstring(L, ScannerSimd::getLevelName(ScannerSimd::getSupportedLevel()));
+	return 2;
+}
+
+// Override the SIMD tier used by new scans. Returns false if unsupported
+int scanner_set_simd_level(lua_State* L) {
+	const char* levelStr = luaL_checkstring(L, 1);
+	ScannerSimd::Level level;
+	if (!ScannerSimd::parseLevel(levelStr, level)) {
+		luaL_error(L, "Invalid SIMD level: %s (valid: SCALAR, SSE2, AVX2, AVX512BW)", levelStr);
+		return 0;
+	}
+
+	lua_pushboolean(L, ScannerSimd::setLevel(level));
+	return 1;
+}
+
 // StructSearch Lua bindings
 int struct_search_create(lua_State* L) {
 	// Get key byte (supports number, char, or hex string)
@@ -755,6 +1768,11 @@ int struct_search_add_field(lua_State* L) {
 	else {
 		SequenceScanner::DataType seqType;
 		if (parseSequenceDataType(typeStr, seqType)) {
+			if (seqType == SequenceScanner::DataType::PATTERN) {
+				luaL_error(L, "PATTERN data type not supported for struct fields");
+				return 0;
+			}
+
 			// Sequence field
 			const void* data;
 			size_t size;
@@ -788,6 +1806,72 @@ int struct_search_destroy(lua_State* L) {
 	return 0;
 }
 
+// PointerMap Lua bindings
+// Loads a file saved by savePointerMap. Memory mapped and read only
+int pointer_map_load(lua_State* L) {
+	const char* path = luaL_checkstring(L, 1);
+
+	PointerMapFile* file = new PointerMapFile();
+	if (!file->load(path)) {
+		std::string error = file->getError();
+		delete file;
+		luaL_error(L, "%s", error.c_str());
+		return 0;
+	}
+
+	PointerMapFile** filePtr = (PointerMapFile**)lua_newuserdata(L, sizeof(PointerMapFile*));
+	*filePtr = file;
+
+	// Set metatable for garbage collection
+	luaL_getmetatable(L, "PointerMap");
+	lua_setmetatable(L, -2);
+	return 1;
+}
+
+int pointer_map_find_chains(lua_State* L) {
+	return findPointerChains(L, *checkPointerMapView(L, 1), nullptr);
+}
+
+// Returns pointerCount, module name, module base and module size
+int pointer_map_get_info(lua_State* L) {
+	PointerMapFile** filePtr = (PointerMapFile**)luaL_checkudata(L, 1, "PointerMap");
+	if (*filePtr == nullptr || !(*filePtr)->isLoaded()) {
+		luaL_error(L, "PointerMap is not loaded");
+		return 0;
+	}
+
+	const PointerMapFile::ModuleEntry& module = (*filePtr)->getModule();
+	lua_newtable(L);
+
+	lua_pushstring(L, "pointerCount");
+	lua_pushinteger(L, (lua_Integer)(*filePtr)->getView().count);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "module");
+	lua_pushlstring(L, module.name, strnlen(module.name, sizeof(module.name)));
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "moduleBase");
+	lua_pushinteger(L, (lua_Integer)module.base);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "moduleSize");
+	lua_pushinteger(L, (lua_Integer)module.size);
+	lua_rawset(L, -3);
+
+	return 1;
+}
+
+int pointer_map_destroy(lua_State* L) {
+	// __gc metamethod
+	PointerMapFile** filePtr = (PointerMapFile**)luaL_checkudata(L, 1, "PointerMap");
+	if (*filePtr != nullptr) {
+		delete *filePtr;
+		*filePtr = nullptr;
+	}
+	return 0;
+}
+
 void add_scanner_functions(lua_State* L) {
 	if (!lua_istable(L, -1)) {
 		luaL_error(L, "add_scanner_functions failed: parent table does not exist");
@@ -813,6 +1897,34 @@ void add_scanner_functions(lua_State* L) {
 	lua_pushcfunction(L, scanner_rescan);
 	lua_rawset(L, -3);
 
+	lua_pushstring(L, "firstScanAsync");
+	lua_pushcfunction(L, scanner_first_scan_async);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "rescanAsync");
+	lua_pushcfunction(L, scanner_rescan_async);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "isDone");
+	lua_pushcfunction(L, scanner_is_done);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "getProgress");
+	lua_pushcfunction(L, scanner_get_progress);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "cancel");
+	lua_pushcfunction(L, scanner_cancel);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "firstScanStepped");
+	lua_pushcfunction(L, scanner_first_scan_stepped);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "step");
+	lua_pushcfunction(L, scanner_step);
+	lua_rawset(L, -3);
+
 	lua_pushstring(L, "getResults");
 	lua_pushcfunction(L, scanner_get_results);
 	lua_rawset(L, -3);
@@ -825,6 +1937,30 @@ void add_scanner_functions(lua_State* L) {
 	lua_pushcfunction(L, scanner_reset);
 	lua_rawset(L, -3);
 
+	lua_pushstring(L, "buildPointerMap");
+	lua_pushcfunction(L, scanner_build_pointer_map);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "findPointerChains");
+	lua_pushcfunction(L, scanner_find_pointer_chains);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "savePointerMap");
+	lua_pushcfunction(L, scanner_save_pointer_map);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "buildCensus");
+	lua_pushcfunction(L, scanner_build_census);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "countByVtable");
+	lua_pushcfunction(L, scanner_count_by_vtable);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "instancesOf");
+	lua_pushcfunction(L, scanner_instances_of);
+	lua_rawset(L, -3);
+
 	lua_rawset(L, -3);
 	lua_pop(L, 1); // Pop metatable
 
@@ -832,6 +1968,14 @@ void add_scanner_functions(lua_State* L) {
 	lua_pushcfunction(L, scanner_create);
 	lua_rawset(L, -3);
 
+	lua_pushstring(L, "getSimdLevel");
+	lua_pushcfunction(L, scanner_get_simd_level);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "setSimdLevel");
+	lua_pushcfunction(L, scanner_set_simd_level);
+	lua_rawset(L, -3);
+
 	// Create StructSearch metatable
 	luaL_newmetatable(L, "StructSearch");
 
@@ -861,6 +2005,39 @@ void add_scanner_functions(lua_State* L) {
 
 	lua_rawset(L, -3);
 
+	// Create PointerMap metatable
+	luaL_newmetatable(L, "PointerMap");
+
+	// Set __gc to unmap the file
+	lua_pushstring(L, "__gc");
+	lua_pushcfunction(L, pointer_map_destroy);
+	lua_rawset(L, -3);
+
+	// Set __index to itself for methods
+	lua_pushstring(L, "__index");
+	lua_newtable(L);
+
+	lua_pushstring(L, "findPointerChains");
+	lua_pushcfunction(L, pointer_map_find_chains);
+	lua_rawset(L, -3);
+
+	lua_pushstring(L, "getInfo");
+	lua_pushcfunction(L, pointer_map_get_info);
+	lua_rawset(L, -3);
+
+	lua_rawset(L, -3);
+	lua_pop(L, 1); // Pop metatable
+
+	lua_pushstring(L, "PointerMap");
+	lua_newtable(L);
+
+	// PointerMap.load constructor
+	lua_pushstring(L, "load");
+	lua_pushcfunction(L, pointer_map_load);
+	lua_rawset(L, -3);
+
+	lua_rawset(L, -3);
+
 	// Add scan type constants
 	lua_pushstring(L, "SCAN_TYPE");
 	lua_newtable(L);
@@ -870,6 +2047,7 @@ void add_scanner_functions(lua_State* L) {
 	lua_pushstring(L, "CHANGED"); lua_pushstring(L, "changed"); lua_rawset(L, -3);
 	lua_pushstring(L, "UNCHANGED"); lua_pushstring(L, "unchanged"); lua_rawset(L, -3);
 	lua_pushstring(L, "NOT"); lua_pushstring(L, "not"); lua_rawset(L, -3);
+	lua_pushstring(L, "UNKNOWN"); lua_pushstring(L, "unknown"); lua_rawset(L, -3);
 	lua_rawset(L, -3);
 
 	// Add data type constants
@@ -882,6 +2060,20 @@ void add_scanner_functions(lua_State* L) {
 	lua_pushstring(L, "BOOL"); lua_pushstring(L, "bool"); lua_rawset(L, -3);
 	lua_pushstring(L, "STRING"); lua_pushstring(L, "string"); lua_rawset(L, -3);
 	lua_pushstring(L, "BYTE_ARRAY"); lua_pushstring(L, "byte_array"); lua_rawset(L, -3);
+	lua_pushstring(L, "PATTERN"); lua_pushstring(L, "pattern"); lua_rawset(L, -3);
+	lua_pushstring(L, "MULTI_STRING"); lua_pushstring(L, "multi_string"); lua_rawset(L, -3);
+	lua_pushstring(L, "MULTI_BYTE_ARRAY"); lua_pushstring(L, "multi_byte_array"); lua_rawset(L, -3);
 	lua_pushstring(L, "STRUCT"); lua_pushstring(L, "struct"); lua_rawset(L, -3);
+	lua_pushstring(L, "POINTER"); lua_pushstring(L, "pointer"); lua_rawset(L, -3);
+	lua_pushstring(L, "VTABLE"); lua_pushstring(L, "vtable"); lua_rawset(L, -3);
+	lua_rawset(L, -3);
+
+	// Add SIMD level constants
+	lua_pushstring(L, "SIMD_LEVEL");
+	lua_newtable(L);
+	lua_pushstring(L, "SCALAR"); lua_pushstring(L, "scalar"); lua_rawset(L, -3);
+	lua_pushstring(L, "SSE2"); lua_pushstring(L, "sse2"); lua_rawset(L, -3);
+	lua_pushstring(L, "AVX2"); lua_pushstring(L, "avx2"); lua_rawset(L, -3);
+	lua_pushstring(L, "AVX512BW"); lua_pushstring(L, "avx512bw"); lua_rawset(L, -3);
 	lua_rawset(L, -3);
 }
@@ -5,8 +5,13 @@
 #include "scanner_base.h"
 #include "scanner_basic.h"
 #include "scanner_sequence.h"
+#include "scanner_multi_sequence.h"
 #include "scanner_struct.h"
+#include "scanner_pointer.h"
+#include "scanner_vtable.h"
 #include "scanner_heap.h"
+#include "scanner_simd.h"
+#include "scanner_async.h"
 #include "../log.h"
 #include <cctype>
 #include <cstdio>
@@ -23,6 +28,35 @@
 	} \
 	Scanner* scanner = *scannerPtr__
 
+// GET_SCANNER for methods that use results. Errors while a background scan
+// owns the scanner and collects it once it finished
+#define GET_IDLE_SCANNER(L, index) \
+	GET_SCANNER(L, index); \
+	if (!checkScannerIdle(L, scanner)) { \
+		return 0; \
+	}
+
+// Scan type and target value of a first scan or rescan parsed from Lua
+// Keeps its own copy of the target so it can run as a background or
+// stepped scan after the Lua call returned
+class LuaScanJob : public AsyncScanJob {
+public:
+	bool isRescan;
+	ScanType scanType;
+	ScanResult basicValue;
+	std::vector<uint8_t, ScannerAllocator<uint8_t>> bytes;
+	SequenceScanner::MaskedPattern pattern;
+	MultiSequenceScanner::PatternList patterns;
+	const void* target;
+	size_t targetSize;
+
+	explicit LuaScanJob(bool isRescan) : isRescan(isRescan), scanType(ScanType::EXACT), target(nullptr), targetSize(0) {}
+	// The copy's target points at its own copy of the value
+	LuaScanJob(const LuaScanJob& other);
+
+	virtual void run(Scanner* scanner) override;
+};
+
 // Helper functions
 std::string toLower(const char* str);
 bool parseInt(const char* str, int& outValue);
@@ -30,9 +64,21 @@ bool parseByte(lua_State* L, int index, uint8_t& outByte);
 bool parseScanType(const char* str, ScanType& outType);
 bool parseBasicDataType(const char* str, BasicScanner::DataType& outType);
 bool parseSequenceDataType(const char* str, SequenceScanner::DataType& outType);
+bool parseMultiSequenceDataType(const char* str, SequenceScanner::DataType& outType);
 
 void logScannerErrors(lua_State* L, Scanner* scanner, const char* operation);
 
+// Errors if a background scan is still running. A finished one is collected
+// and its errors are logged
+bool checkScannerIdle(lua_State* L, Scanner* scanner);
+
+// Helper to parse the scan type, target value and options (args 2-4) of
+// firstScan/rescan and their async versions into job
+bool parseScanJob(lua_State* L, Scanner* scanner, LuaScanJob& job);
+
+// Helper to push the summary table returned by firstScan/rescan
+void pushScanSummary(lua_State* L, Scanner* scanner, bool firstScan);
+
 // Helper to parse target value for basic types (INT, FLOAT, etc)
 bool parseBasicValue(lua_State* L, int valueIndex, BasicScanner::DataType dataType, ScanResult& outResult);
 
@@ -40,12 +86,38 @@ bool parseBasicValue(lua_State* L, int valueIndex, BasicScanner::DataType dataTy
 bool parseSequenceValue(lua_State* L, int valueIndex, SequenceScanner::DataType dataType,
                         const void*& outData, size_t& outSize, std::vector<uint8_t, ScannerAllocator<uint8_t>>& bytesBuffer);
 
+// Helper to parse a masked pattern string for PATTERN
+bool parsePatternValue(lua_State* L, int valueIndex, SequenceScanner::MaskedPattern& outPattern);
+
+// Helper to parse a table of patterns for multi sequence types
+bool parsePatternList(lua_State* L, int valueIndex, SequenceScanner::DataType dataType,
+                      MultiSequenceScanner::PatternList& outPatterns);
+
+// Helper to parse a table of strings
+bool parseStringList(lua_State* L, int index, const char* name,
+                     std::vector<std::string, ScannerAllocator<std::string>>& outList);
+
+// Helpers to parse the region filter keys shared by scanner_create and the scan options
+// memoryTypes/excludeMemoryTypes, writable, executable, minAddress, maxAddress, modules, excludeModules
+bool parseMemoryTypes(lua_State* L, int index, const char* name, uint32_t& outTypes);
+bool parseRegionFilter(lua_State* L, int optionsIndex, RegionFilter& filter);
+
+// Helper to apply the optional per-scan options table passed to firstScan/rescan
+// Options that are not given reset to the scanner defaults
+bool parseScanOptions(lua_State* L, int optionsIndex, Scanner* scanner);
+
 // Helper to push a basic type value to Lua stack
 void pushBasicValueToLua(lua_State* L, const ScanResult& result, BasicScanner::DataType dataType);
 
 // Helper to push a sequence type value to Lua stack
 void pushSequenceValueToLua(lua_State* L, Scanner* scanner, const ScanResult& result, SequenceScanner::DataType dataType, bool readValues);
 
+// Helper to add the region filter stats to the table on top of the stack
+void pushRegionFilterStats(lua_State* L, Scanner* scanner);
+
+// Helper to add per pattern result counts to the table on top of the stack
+void pushPatternResultCounts(lua_State* L, MultiSequenceScanner* multiScanner);
+
 // Push byte sequence to Lua as string or table depending on data type
 void pushBytesToLua(lua_State* L, const std::vector<uint8_t, ScannerAllocator<uint8_t>>& bytes, SequenceScanner::DataType dataType);
 
@@ -53,16 +125,49 @@ void pushBytesToLua(lua_State* L, const std::vector<uint8_t, ScannerAllocator<ui
 int scanner_create(lua_State* L);
 int scanner_first_scan(lua_State* L);
 int scanner_rescan(lua_State* L);
+int scanner_first_scan_async(lua_State* L);
+int scanner_rescan_async(lua_State* L);
+int scanner_is_done(lua_State* L);
+int scanner_get_progress(lua_State* L);
+int scanner_cancel(lua_State* L);
+int scanner_first_scan_stepped(lua_State* L);
+int scanner_step(lua_State* L);
 int scanner_get_results(lua_State* L);
 int scanner_get_result_count(lua_State* L);
 int scanner_reset(lua_State* L);
 int scanner_destroy(lua_State* L);
 
+// Lua wrappers for POINTER scanners
+int scanner_build_pointer_map(lua_State* L);
+int scanner_find_pointer_chains(lua_State* L);
+int scanner_save_pointer_map(lua_State* L);
+
+// Helpers shared by POINTER scanners and loaded PointerMaps
+// checkPointerMapView accepts either one at the index. pointerScanner is
+// set when view belongs to a POINTER scanner so the search goes through it
+const PointerMapView* checkPointerMapView(lua_State* L, int index);
+int findPointerChains(lua_State* L, const PointerMapView& view, PointerScanner* pointerScanner);
+
+// Lua wrappers for VTABLE scanners
+int scanner_build_census(lua_State* L);
+int scanner_count_by_vtable(lua_State* L);
+int scanner_instances_of(lua_State* L);
+
+// Lua wrappers for SIMD tier control (module level, not per scanner)
+int scanner_get_simd_level(lua_State* L);
+int scanner_set_simd_level(lua_State* L);
+
 // Lua wrappers for StructSearch
 int struct_search_create(lua_State* L);
 int struct_search_add_field(lua_State* L);
 int struct_search_destroy(lua_State* L);
 
+// Lua wrappers for PointerMap (saved pointer map files)
+int pointer_map_load(lua_State* L);
+int pointer_map_find_chains(lua_State* L);
+int pointer_map_get_info(lua_State* L);
+int pointer_map_destroy(lua_State* L);
+
 // Register scanner functions with Lua
 void add_scanner_functions(lua_State* L);
 
@@ -0,0 +1,354 @@
+#include "stdafx.h"
+#include "scanner_multi_sequence.h"
+#include "scanner_multi_sequence_kernels.h"
+#include "../safememory.h"
+
+#include <algorithm>
+#include <windows.h>
+
+namespace {
+	// Scalar tier entry point. The shared scalar loop also finishes vector tiers
+	void scanChunkScalar(const MultiSequenceScanner::BucketParams& params, const uint8_t* buffer, size_t chunkSize,
+	                     uintptr_t chunkBase, size_t leadingOverlap,
+	                     std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+		MultiSequenceKernels::scanChunkBucketsScalar(params, buffer, chunkSize, chunkBase, leadingOverlap, 0,
+		                                             localResults, maxLocalResults);
+	}
+}
+
+void* MultiSequenceScanner::operator new(size_t size) {
+	return ScannerHeap::allocate(size);
+}
+
+void MultiSequenceScanner::operator delete(void* ptr) noexcept {
+	if (ptr) {
+		ScannerHeap::deallocate(ptr, 0);
+	}
+}
+
+MultiSequenceScanner::MultiSequenceScanner(SequenceScanner::DataType dataType, size_t maxResults, size_t alignment) :
+	Scanner(maxResults, alignment), dataType(dataType), maxPatternSize(0), chunkKernel(nullptr)
+{
+	// Just default to 1 for sequences
+	if (this->alignment == 0) {
+		this->alignment = 1;
+	}
+	memset(&bucketParams, 0, sizeof(bucketParams));
+}
+
+MultiSequenceScanner::~MultiSequenceScanner() {}
+
+MultiSequenceScanner* MultiSequenceScanner::create(SequenceScanner::DataType dataType, size_t maxResults, size_t alignment) {
+	return new MultiSequenceScanner(dataType, maxResults, alignment);
+}
+
+size_t MultiSequenceScanner::getDataTypeSize() const {
+	return maxPatternSize > 0 ? maxPatternSize : 1;
+}
+
+size_t MultiSequenceScanner::getResultSize(const ScanResult& result) const {
+	size_t pattern = getResultPattern(result);
+	return pattern < patterns.size() ? patterns[pattern].size() : getDataTypeSize();
+}
+
+bool MultiSequenceScanner::setPatterns(const PatternList& newPatterns) {
+	if (newPatterns.empty()) {
+		addError("Pattern list cannot be empty");
+		return false;
+	}
+
+	if (newPatterns.size() > MAX_MULTI_PATTERNS) {
+		addError("Pattern count (%zu) exceeds maximum allowed count (%zu)", newPatterns.size(), MAX_MULTI_PATTERNS);
+		return false;
+	}
+
+	size_t maxSize = 0;
+	for (size_t i = 0; i < newPatterns.size(); i++) {
+		if (newPatterns[i].empty()) {
+			addError("Pattern %zu cannot be empty", i + 1);
+			return false;
+		}
+		if (newPatterns[i].size() > MAX_SEQUENCE_SIZE) {
+			addError("Pattern %zu size (%zu) exceeds maximum allowed size (%zu)", i + 1, newPatterns[i].size(), MAX_SEQUENCE_SIZE);
+			return false;
+		}
+		maxSize = std::max<size_t>(maxSize, newPatterns[i].size());
+	}
+
+	patterns = newPatterns;
+	maxPatternSize = maxSize;
+	return true;
+}
+
+// Split the patterns into buckets and build the filter tables
+// Patterns are ordered by their fingerprint and cut into contiguous runs so
+// similar patterns share a bucket. Patterns with identical fingerprints are
+// always kept together since splitting them would only set more bucket bits
+void MultiSequenceScanner::buildBuckets() {
+	memset(&bucketParams, 0, sizeof(bucketParams));
+
+	size_t minSize = patterns[0].size();
+	for (size_t i = 1; i < patterns.size(); i++) {
+		minSize = std::min<size_t>(minSize, patterns[i].size());
+	}
+	const size_t fingerprintSize = std::min<size_t>(minSize, MULTI_FINGERPRINT_MAX);
+
+	bucketParams.patterns = patterns.data();
+	bucketParams.minSize = minSize;
+	bucketParams.fingerprintSize = fingerprintSize;
+
+	// Order patterns by fingerprint. Ties keep their original order
+	size_t order[MAX_MULTI_PATTERNS];
+	for (size_t i = 0; i < patterns.size(); i++) {
+		order[i] = i;
+	}
+	std::stable_sort(order, order + patterns.size(), [&](size_t a, size_t b) {
+		return memcmp(patterns[a].data(), patterns[b].data(), fingerprintSize) < 0;
+	});
+
+	// Assign buckets
+	const size_t count = patterns.size();
+	const size_t bucketCount = std::min<size_t>(count, MULTI_BUCKET_COUNT);
+	size_t bucketOf[MAX_MULTI_PATTERNS];
+	for (size_t i = 0; i < count; i++) {
+		bucketOf[i] = i * bucketCount / count;
+		if (i > 0 && memcmp(patterns[order[i]].data(), patterns[order[i - 1]].data(), fingerprintSize) == 0) {
+			bucketOf[i] = bucketOf[i - 1];
+		}
+	}
+
+	// Bucket lists. Order is already grouped by bucket
+	size_t next = 0;
+	for (size_t bucket = 0; bucket < MULTI_BUCKET_COUNT; bucket++) {
+		bucketParams.bucketStart[bucket] = next;
+		while (next < count && bucketOf[next] == bucket) {
+			bucketParams.bucketPatterns[next] = order[next];
+			next++;
+		}
+	}
+	bucketParams.bucketStart[MULTI_BUCKET_COUNT] = next;
+
+	// Filter tables
+	for (size_t i = 0; i < count; i++) {
+		const uint8_t bit = (uint8_t)(1 << bucketOf[i]);
+		const Pattern& pattern = patterns[order[i]];
+		for (size_t k = 0; k < fingerprintSize; k++) {
+			bucketParams.byteMasks[k][pattern[k]] |= bit;
+			bucketParams.lowNibbleMasks[k][pattern[k] & 0x0F] |= bit;
+			bucketParams.highNibbleMasks[k][pattern[k] >> 4] |= bit;
+		}
+	}
+}
+
+MultiSequenceScanner::ChunkKernel MultiSequenceScanner::selectChunkKernel(ScannerSimd::Level level) {
+	// Nibble lookups need pshufb so SSE2 uses the scalar byte tables
+	switch (level) {
+		case ScannerSimd::Level::AVX512BW:
+			return MultiSequenceKernels::getChunkKernelAVX512();
+		case ScannerSimd::Level::AVX2:
+			return MultiSequenceKernels::getChunkKernelAVX2();
+		case ScannerSimd::Level::SSE2:
+		case ScannerSimd::Level::SCALAR:
+		default:
+			return scanChunkScalar;
+	}
+}
+
+bool MultiSequenceScanner::setupScanCommon(ScanType scanType, const void* targetValue, size_t valueSize) {
+	if (targetValue == nullptr) {
+		addError("Multi sequence types require non-null targetValue");
+		return false;
+	}
+
+	// Results refer to patterns by index so rescans must keep the same list size
+	const PatternList* targetPatterns = (const PatternList*)targetValue;
+	if (firstScanDone && targetPatterns->size() != patterns.size()) {
+		addError("Rescan pattern count (%zu) must match first scan pattern count (%zu)", targetPatterns->size(), patterns.size());
+		return false;
+	}
+
+	if (!setPatterns(*targetPatterns)) {
+		return false;
+	}
+
+	buildBuckets();
+	chunkKernel = selectChunkKernel(ScannerSimd::getLevel());
+	return true;
+}
+
+bool MultiSequenceScanner::validateFirstScanType(ScanType scanType) {
+	// First scan for sequences only supports EXACT
+	if (scanType != ScanType::EXACT) {
+		addError("First scan for multi sequences only supports EXACT scan type");
+		return false;
+	}
+	return true;
+}
+
+void MultiSequenceScanner::firstScanImpl(ScanType scanType, const void* targetValue, size_t valueSize) {
+	Scanner::firstScanImpl(scanType, targetValue, valueSize);
+	rebuildPatternResults();
+}
+
+void MultiSequenceScanner::rescanImpl(ScanType scanType, const void* targetValue, size_t valueSize) {
+	Scanner::rescanImpl(scanType, targetValue, valueSize);
+	rebuildPatternResults();
+}
+
+void MultiSequenceScanner::reset() {
+	Scanner::reset();
+	patternResults.clear();
+}
+
+void MultiSequenceScanner::rebuildPatternResults() {
+	patternResults.assign(patterns.size(), IndexList());
+	for (size_t i = 0; i < results.size(); i++) {
+		size_t pattern = getResultPattern(results[i]);
+		if (pattern < patternResults.size()) {
+			patternResults[pattern].push_back(i);
+		}
+	}
+}
+
+const MultiSequenceScanner::IndexList& MultiSequenceScanner::getPatternResultIndices(size_t pattern) const {
+	static const IndexList empty;
+	return pattern < patternResults.size() ? patternResults[pattern] : empty;
+}
+
+void MultiSequenceScanner::scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
+                                              ScanType scanType, const void* targetValue,
+                                              std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+	scanChunkAfterOverlap(buffer, chunkSize, chunkBase, 0, scanType, targetValue, localResults, maxLocalResults);
+}
+
+void MultiSequenceScanner::scanChunkAfterOverlap(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
+                                                  size_t leadingOverlap, ScanType scanType, const void* targetValue,
+                                                  std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+	// First scans are always EXACT (see validateFirstScanType)
+	chunkKernel(bucketParams, buffer, chunkSize, chunkBase, leadingOverlap, localResults, maxLocalResults);
+}
+
+bool MultiSequenceScanner::checkMatch(const uint8_t* data, size_t pattern, ScanType scanType) const {
+	const Pattern& bytes = patterns[pattern];
+	switch (scanType) {
+		case ScanType::EXACT:
+			return SequenceScanner::compare(data, bytes.data(), bytes.size());
+		case ScanType::NOT:
+			return !SequenceScanner::compare(data, bytes.data(), bytes.size());
+		case ScanType::CHANGED:
+		case ScanType::UNCHANGED:
+		case ScanType::INCREASED:
+		case ScanType::DECREASED:
+			addError("Only EXACT and NOT scans supported for multi STRING/BYTE_ARRAY");
+			return false;
+		default:
+			addError("Invalid scan type in checkMatch: %d", (int)scanType);
+			return false;
+	}
+}
+
+void MultiSequenceScanner::rescanResultBatch(const std::vector<ScanResult, ScannerAllocator<ScanResult>>& oldResults,
+                                              size_t batchStart, size_t batchEnd,
+                                              uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
+                                              ScanType scanType, const void* targetValue,
+                                              ResultStore& newResults) {
+	const ScanResult* batch = oldResults.data() + batchStart;
+	size_t count = batchEnd - batchStart;
+
+	switch (scanType) {
+		case ScanType::EXACT:
+			rescanPatternBatch<false>(batch, count, chunkStart, chunkSize, buffer, newResults);
+			break;
+		case ScanType::NOT:
+			rescanPatternBatch<true>(batch, count, chunkStart, chunkSize, buffer, newResults);
+			break;
+		default:
+			// Unsupported types go through the generic path so checkMatch reports them
+			Scanner::rescanResultBatch(oldResults, batchStart, batchEnd, chunkStart, chunkSize, buffer,
+			                           scanType, targetValue, newResults);
+			break;
+	}
+}
+
+template<bool INVERT>
+void MultiSequenceScanner::rescanPatternBatch(const ScanResult* oldResults, size_t count, uintptr_t chunkStart, size_t chunkSize,
+                                               const uint8_t* buffer, ResultStore& newResults) {
+	size_t invalidCount = 0;
+	for (size_t i = 0; i < count; i++) {
+		const ScanResult& oldResult = oldResults[i];
+		size_t offset = oldResult.address - chunkStart;
+		size_t pattern = getResultPattern(oldResult);
+
+		// Verify pattern is known and within chunk then compare
+		if (pattern >= patterns.size() || offset + patterns[pattern].size() > chunkSize ||
+		    SequenceScanner::compare(buffer + offset, patterns[pattern].data(), patterns[pattern].size()) == INVERT) {
+			invalidCount++;
+			continue;
+		}
+
+		ScanResult result;
+		result.address = oldResult.address;
+		result.value = oldResult.value;
+		result.oldValue = oldResult.value;
+		result.hasOldValue = true;
+		newResults.push_back(result);
+	}
+
+	invalidAddressCount += invalidCount;
+}
+
+// Validates the value in the buffer against the pattern the result matched
+// The pattern index is carried over from the old result
+bool MultiSequenceScanner::validateValueInBuffer(const uint8_t* buffer, size_t bufferSize, size_t offset,
+                                                   uintptr_t actualAddress, ScanType scanType, const void* targetValue,
+                                                   ScanResult& outResult) const {
+	outResult.address = actualAddress;
+	outResult.value = outResult.oldValue;
+
+	size_t pattern = getResultPattern(outResult);
+	if (pattern >= patterns.size() || offset + patterns[pattern].size() > bufferSize) {
+		return false;
+	}
+
+	return checkMatch(buffer + offset, pattern, scanType);
+}
+
+// Validates the pattern directly from memory with try/catch protection
+bool MultiSequenceScanner::validateValueDirect(uintptr_t address, uintptr_t regionStart, uintptr_t regionEnd,
+                                                 ScanType scanType, const void* targetValue,
+                                                 ScanResult& outResult) const {
+	outResult.address = address;
+	outResult.value = outResult.oldValue;
+
+	size_t pattern = getResultPattern(outResult);
+	if (pattern >= patterns.size() || address + patterns[pattern].size() > regionEnd) {
+		return false;
+	}
+
+	__try {
+		return checkMatch((const uint8_t*)address, pattern, scanType);
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER) {
+		return false;
+	}
+}
+
+bool MultiSequenceScanner::readPatternBytes(uintptr_t address, size_t pattern, Pattern& outBytes) const {
+	if (pattern >= patterns.size()) {
+		return false;
+	}
+
+	size_t size = patterns[pattern].size();
+	outBytes.clear();
+	outBytes.reserve(size);
+
+	__try {
+		const uint8_t* memBytes = (const uint8_t*)address;
+		outBytes.assign(memBytes, memBytes + size);
+		return true;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER) {
+		addError("Failed to read pattern value at address 0x%p: memory access violation", (void*)address);
+		return false;
+	}
+}
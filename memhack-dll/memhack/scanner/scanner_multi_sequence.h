@@ -0,0 +1,152 @@
+#ifndef SCANNER_MULTI_SEQUENCE_H
+#define SCANNER_MULTI_SEQUENCE_H
+
+#include "scanner_base.h"
+#include "scanner_sequence.h"
+#include "scanner_simd.h"
+#include <windows.h>
+
+// Maximum number of patterns in a single multi-pattern scan
+// Every pattern shares one of 8 filter buckets so verify cost grows with count
+const size_t MAX_MULTI_PATTERNS = 128;
+
+// Bytes at the start of each pattern used by the bucket filter
+const size_t MULTI_FINGERPRINT_MAX = 3;
+
+// Number of filter buckets. One bit each in a byte
+const size_t MULTI_BUCKET_COUNT = 8;
+
+// Scanner implementation for finding several sequences (STRING, BYTE_ARRAY)
+// in a single pass over memory
+// Patterns are split into 8 buckets by their first bytes. A Teddy style filter
+// finds positions whose leading bytes could start a pattern in some bucket and
+// only the patterns of matching buckets are compared in full
+//
+// Each result stores the index of the pattern it matched in value.intValue so
+// results can be split back out per pattern
+class MultiSequenceScanner : public Scanner {
+public:
+	typedef std::vector<uint8_t, ScannerAllocator<uint8_t>> Pattern;
+	typedef std::vector<Pattern, ScannerAllocator<Pattern>> PatternList;
+	typedef std::vector<size_t, ScannerAllocator<size_t>> IndexList;
+
+	// Per-scan parameters handed to the chunk kernels
+	struct BucketParams {
+		const Pattern* patterns;
+		size_t minSize;
+		size_t fingerprintSize;    // Leading bytes checked by the filter (1 to 3)
+
+		// Bucket bits for each value of the byte at each fingerprint position
+		uint8_t byteMasks[MULTI_FINGERPRINT_MAX][256];
+
+		// Same masks split by nibble for pshufb lookups. Looser than byteMasks
+		// since low and high nibbles are matched separately
+		uint8_t lowNibbleMasks[MULTI_FINGERPRINT_MAX][16];
+		uint8_t highNibbleMasks[MULTI_FINGERPRINT_MAX][16];
+
+		// Pattern indices of bucket b are bucketPatterns[bucketStart[b] .. bucketStart[b + 1])
+		size_t bucketStart[MULTI_BUCKET_COUNT + 1];
+		size_t bucketPatterns[MAX_MULTI_PATTERNS];
+	};
+
+	// Chunk kernel - finds every pattern occurrence in the buffer except those
+	// lying entirely in the first leadingOverlap bytes
+	typedef void (*ChunkKernel)(const BucketParams& params, const uint8_t* buffer, size_t chunkSize,
+	                            uintptr_t chunkBase, size_t leadingOverlap,
+	                            std::vector<ScanResult>& localResults, size_t maxLocalResults);
+
+	// Override new/delete to allocate from scanner heap
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr) noexcept;
+
+	MultiSequenceScanner(SequenceScanner::DataType dataType, size_t maxResults, size_t alignment);
+	virtual ~MultiSequenceScanner();
+
+	static MultiSequenceScanner* create(SequenceScanner::DataType dataType, size_t maxResults, size_t alignment);
+
+	SequenceScanner::DataType getDataType() const { return dataType; }
+
+	bool setPatterns(const PatternList& newPatterns);
+	const PatternList& getPatterns() const { return patterns; }
+	size_t getPatternCount() const { return patterns.size(); }
+
+	// Indices into getResults() of the results for one pattern, in result order
+	// Empty for unknown patterns or before the first scan
+	const IndexList& getPatternResultIndices(size_t pattern) const;
+	size_t getPatternResultCount(size_t pattern) const { return getPatternResultIndices(pattern).size(); }
+
+	static size_t getResultPattern(const ScanResult& result) { return (size_t)result.value.intValue; }
+
+	bool readPatternBytes(uintptr_t address, size_t pattern, Pattern& outBytes) const;
+
+	virtual void reset() override;
+
+	// Pick the chunk kernel for the given tier. Always returns a kernel
+	static ChunkKernel selectChunkKernel(ScannerSimd::Level level);
+
+protected:
+	// Setup hook - store patterns and build the bucket filter
+	virtual bool setupScanCommon(ScanType scanType, const void* targetValue, size_t valueSize) override;
+
+	// only allow EXACT for first scan
+	virtual bool validateFirstScanType(ScanType scanType) override;
+	// Results are split by pattern after the scan
+	virtual bool supportsStepScan() const override { return false; }
+
+	// Scans run through the base implementations. Results are split by
+	// pattern afterwards
+	virtual void firstScanImpl(ScanType scanType, const void* targetValue, size_t valueSize) override;
+	virtual void rescanImpl(ScanType scanType, const void* targetValue, size_t valueSize) override;
+
+	virtual void scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
+	                               ScanType scanType, const void* targetValue,
+	                               std::vector<ScanResult>& localResults, size_t maxLocalResults) override;
+	// Chunks overlap by the longest pattern, so shorter patterns that fall
+	// entirely in an overlap are dropped here rather than found twice
+	virtual void scanChunkAfterOverlap(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
+	                                   size_t leadingOverlap, ScanType scanType, const void* targetValue,
+	                                   std::vector<ScanResult>& localResults, size_t maxLocalResults) override;
+
+	// Rescan pure virtuals - compare each result against its own pattern
+	virtual bool validateValueDirect(uintptr_t address, uintptr_t regionStart, uintptr_t regionEnd,
+	                                  ScanType scanType, const void* targetValue,
+	                                  ScanResult& outResult) const override;
+	virtual bool validateValueInBuffer(const uint8_t* buffer, size_t bufferSize, size_t offset,
+	                                    uintptr_t actualAddress, ScanType scanType, const void* targetValue,
+	                                    ScanResult& outResult) const override;
+
+	// Batched rescan - EXACT/NOT compare inline against each result's own
+	// pattern length without per result virtual calls
+	virtual void rescanResultBatch(const std::vector<ScanResult, ScannerAllocator<ScanResult>>& oldResults, size_t batchStart, size_t batchEnd,
+	                               uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
+	                               ScanType scanType, const void* targetValue, ResultStore& newResults) override;
+
+	// Getters
+	// Longest pattern so chunk overlaps cover every pattern
+	virtual size_t getDataTypeSize() const override;
+	virtual size_t getResultSize(const ScanResult& result) const override;
+	// Only the pattern index is kept (see getResultPattern)
+	virtual size_t getStoredValueSize() const override { return sizeof(int32_t); }
+
+private:
+	void buildBuckets();
+	void rebuildPatternResults();
+	bool checkMatch(const uint8_t* data, size_t pattern, ScanType scanType) const;
+
+	template<bool INVERT>
+	void rescanPatternBatch(const ScanResult* oldResults, size_t count, uintptr_t chunkStart, size_t chunkSize,
+	                        const uint8_t* buffer, ResultStore& newResults);
+
+	SequenceScanner::DataType dataType;
+	PatternList patterns;
+	size_t maxPatternSize;
+
+	// Results split by pattern. Rebuilt after every scan
+	std::vector<IndexList, ScannerAllocator<IndexList>> patternResults;
+
+	// Kernel selected for the current scan
+	ChunkKernel chunkKernel;
+	BucketParams bucketParams;
+};
+
+#endif
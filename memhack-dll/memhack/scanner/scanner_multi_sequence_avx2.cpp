@@ -0,0 +1,44 @@
+#include "stdafx.h"
+#include "scanner_multi_sequence_kernels.h"
+#include <immintrin.h>  // AVX2 intrinsics
+
+// AVX2 tier - 32 candidate starts per window
+// Only called when ScannerSimd reports AVX2 support
+namespace {
+	struct BucketLookup {
+		static const size_t WIDTH = 32;
+		size_t fingerprintSize;
+		__m256i lowMasks[MULTI_FINGERPRINT_MAX];
+		__m256i highMasks[MULTI_FINGERPRINT_MAX];
+		__m256i nibbleMask;
+
+		explicit BucketLookup(const MultiSequenceScanner::BucketParams& params) :
+			fingerprintSize(params.fingerprintSize),
+			nibbleMask(_mm256_set1_epi8(0x0F))
+		{
+			// pshufb looks up within each 128 bit lane so both lanes get the table
+			for (size_t k = 0; k < fingerprintSize; k++) {
+				lowMasks[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)params.lowNibbleMasks[k]));
+				highMasks[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)params.highNibbleMasks[k]));
+			}
+		}
+
+		uint64_t operator()(const uint8_t* p, uint8_t* buckets) const {
+			__m256i result = _mm256_set1_epi8((char)0xFF);
+			for (size_t k = 0; k < fingerprintSize; k++) {
+				__m256i dataVec = _mm256_loadu_si256((const __m256i*)(p + k));
+				__m256i low = _mm256_shuffle_epi8(lowMasks[k], _mm256_and_si256(dataVec, nibbleMask));
+				__m256i high = _mm256_shuffle_epi8(highMasks[k], _mm256_and_si256(_mm256_srli_epi16(dataVec, 4), nibbleMask));
+				result = _mm256_and_si256(result, _mm256_and_si256(low, high));
+			}
+
+			_mm256_storeu_si256((__m256i*)buckets, result);
+			__m256i empty = _mm256_cmpeq_epi8(result, _mm256_setzero_si256());
+			return ~(uint32_t)_mm256_movemask_epi8(empty);
+		}
+	};
+}
+
+MultiSequenceScanner::ChunkKernel MultiSequenceKernels::getChunkKernelAVX2() {
+	return scanChunkBuckets<BucketLookup>;
+}
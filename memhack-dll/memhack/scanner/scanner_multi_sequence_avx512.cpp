@@ -0,0 +1,42 @@
+#include "stdafx.h"
+#include "scanner_multi_sequence_kernels.h"
+#include <immintrin.h>  // AVX-512 intrinsics
+
+// AVX-512BW tier - 64 candidate starts per window
+namespace {
+	struct BucketLookup {
+		static const size_t WIDTH = 64;
+		size_t fingerprintSize;
+		__m512i lowMasks[MULTI_FINGERPRINT_MAX];
+		__m512i highMasks[MULTI_FINGERPRINT_MAX];
+		__m512i nibbleMask;
+
+		explicit BucketLookup(const MultiSequenceScanner::BucketParams& params) :
+			fingerprintSize(params.fingerprintSize),
+			nibbleMask(_mm512_set1_epi8(0x0F))
+		{
+			// pshufb looks up within each 128 bit lane so every lane gets the table
+			for (size_t k = 0; k < fingerprintSize; k++) {
+				lowMasks[k] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)params.lowNibbleMasks[k]));
+				highMasks[k] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)params.highNibbleMasks[k]));
+			}
+		}
+
+		uint64_t operator()(const uint8_t* p, uint8_t* buckets) const {
+			__m512i result = _mm512_set1_epi8((char)0xFF);
+			for (size_t k = 0; k < fingerprintSize; k++) {
+				__m512i dataVec = _mm512_loadu_si512((const void*)(p + k));
+				__m512i low = _mm512_shuffle_epi8(lowMasks[k], _mm512_and_si512(dataVec, nibbleMask));
+				__m512i high = _mm512_shuffle_epi8(highMasks[k], _mm512_and_si512(_mm512_srli_epi16(dataVec, 4), nibbleMask));
+				result = _mm512_and_si512(result, _mm512_and_si512(low, high));
+			}
+
+			_mm512_storeu_si512((void*)buckets, result);
+			return _mm512_test_epi8_mask(result, result);
+		}
+	};
+}
+
+MultiSequenceScanner::ChunkKernel MultiSequenceKernels::getChunkKernelAVX512() {
+	return scanChunkBuckets<BucketLookup>;
+}
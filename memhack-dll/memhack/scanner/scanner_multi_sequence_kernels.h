@@ -0,0 +1,110 @@
+#ifndef SCANNER_MULTI_SEQUENCE_KERNELS_H
+#define SCANNER_MULTI_SEQUENCE_KERNELS_H
+
+#include "scanner_multi_sequence.h"
+#include "scanner_sequence_kernels.h"
+#include <cstring>
+
+// Bucket filter kernels for MultiSequenceScanner
+// The scalar tier looks up exact bucket bits per byte. The vector tiers look
+// up bucket bits per nibble with pshufb (so they need AVX2 or AVX-512BW) which
+// can let extra buckets through. Both then verify the same bucket lists in the
+// same order so every tier reports identically
+//
+// Bucket compares test WIDTH candidate starts at once. They store the bucket
+// bits for each start and return a mask of the starts with any bit set
+namespace MultiSequenceKernels {
+	// Tier lookups. Return nullptr if the tier is not available
+	MultiSequenceScanner::ChunkKernel getChunkKernelAVX2();
+	MultiSequenceScanner::ChunkKernel getChunkKernelAVX512();
+
+	// Compare the patterns of every bucket in buckets against the candidate
+	// Matches that end inside the leading overlap were reported by the
+	// previous chunk and are skipped. Returns false once localResults is full
+	inline bool verifyBuckets(const MultiSequenceScanner::BucketParams& params, const uint8_t* buffer, size_t chunkSize,
+	                          size_t offset, uint8_t buckets, uintptr_t chunkBase, size_t leadingOverlap,
+	                          std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+		while (buckets != 0) {
+			size_t bucket = SequenceKernels::lowestSetBit(buckets);
+			buckets &= buckets - 1;
+
+			for (size_t i = params.bucketStart[bucket]; i < params.bucketStart[bucket + 1]; i++) {
+				size_t pattern = params.bucketPatterns[i];
+				const MultiSequenceScanner::Pattern& bytes = params.patterns[pattern];
+				if (offset + bytes.size() > chunkSize || offset + bytes.size() <= leadingOverlap ||
+				    memcmp(buffer + offset, bytes.data(), bytes.size()) != 0) {
+					continue;
+				}
+
+				ScanResult result;
+				result.address = chunkBase + offset;
+				result.value.intValue = (int32_t)pattern;
+				localResults.push_back(result);
+				if (localResults.size() >= maxLocalResults) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// Scalar tier and the tail of the vector tiers. Checks starts from offset on
+	inline void scanChunkBucketsScalar(const MultiSequenceScanner::BucketParams& params, const uint8_t* buffer, size_t chunkSize,
+	                                   uintptr_t chunkBase, size_t leadingOverlap, size_t offset,
+	                                   std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+		if (chunkSize < params.minSize) {
+			return;
+		}
+
+		const size_t lastStart = chunkSize - params.minSize;
+		for (; offset <= lastStart; offset++) {
+			uint8_t buckets = params.byteMasks[0][buffer[offset]];
+			for (size_t k = 1; k < params.fingerprintSize && buckets != 0; k++) {
+				buckets &= params.byteMasks[k][buffer[offset + k]];
+			}
+
+			if (buckets != 0 &&
+			    !verifyBuckets(params, buffer, chunkSize, offset, buckets, chunkBase, leadingOverlap,
+			                   localResults, maxLocalResults)) {
+				return;
+			}
+		}
+	}
+
+	// Shared loop for the vector tiers
+	// Windows of WIDTH starts are tested until the last fingerprint load would
+	// pass the chunk end. The rest is finished by the scalar loop
+	template<typename Cmp>
+	void scanChunkBuckets(const MultiSequenceScanner::BucketParams& params, const uint8_t* buffer, size_t chunkSize,
+	                      uintptr_t chunkBase, size_t leadingOverlap,
+	                      std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+		if (chunkSize < params.minSize) {
+			return;
+		}
+
+		const Cmp cmp(params);
+		const size_t lastStart = chunkSize - params.minSize;
+		uint8_t buckets[Cmp::WIDTH];
+
+		size_t start = 0;
+		while (start + (params.fingerprintSize - 1) + Cmp::WIDTH <= chunkSize) {
+			uint64_t mask = cmp(buffer + start, buckets);
+			while (mask != 0) {
+				size_t lane = SequenceKernels::lowestSetBit(mask);
+				mask &= mask - 1;
+
+				size_t offset = start + lane;
+				if (offset <= lastStart &&
+				    !verifyBuckets(params, buffer, chunkSize, offset, buckets[lane], chunkBase, leadingOverlap,
+				                   localResults, maxLocalResults)) {
+					return;
+				}
+			}
+			start += Cmp::WIDTH;
+		}
+
+		scanChunkBucketsScalar(params, buffer, chunkSize, chunkBase, leadingOverlap, start, localResults, maxLocalResults);
+	}
+}
+
+#endif
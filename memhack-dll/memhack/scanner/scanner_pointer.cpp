@@ -0,0 +1,323 @@
+#include "stdafx.h"
+#include "scanner_pointer.h"
+#include "../safememory.h"
+
+#include <algorithm>
+#include <windows.h>
+
+// Granules of the readable span tracked by the pointee filter. 64KB (the
+// allocation granularity) keeps the 32 bit address space at 8KB of bits
+const unsigned MIN_GRANULE_SHIFT = 16;
+const size_t MAX_GRANULES = (size_t)1 << 20;
+
+void* PointerScanner::operator new(size_t size) {
+	return ScannerHeap::allocate(size);
+}
+
+void PointerScanner::operator delete(void* ptr) noexcept {
+	if (ptr) {
+		ScannerHeap::deallocate(ptr, 0);
+	}
+}
+
+PointerScanner::PointerScanner(size_t maxResults, size_t alignment) :
+	Scanner(maxResults, alignment), targetStart(0), targetEnd(0), granuleShift(MIN_GRANULE_SHIFT),
+	staticBase(0), staticSize(0)
+{
+	// Pointers are almost always stored aligned
+	if (this->alignment == 0) {
+		this->alignment = sizeof(uintptr_t);
+	}
+}
+
+PointerScanner::~PointerScanner() {}
+
+PointerScanner* PointerScanner::create(size_t maxResults, size_t alignment) {
+	return new PointerScanner(maxResults, alignment);
+}
+
+void PointerScanner::buildPointerMap() {
+	reset();
+	firstScan(ScanType::EXACT, nullptr);
+}
+
+void PointerScanner::reset() {
+	Scanner::reset();
+	mapValues.clear();
+	mapAddresses.clear();
+	mapAddressOrder.clear();
+	mapView = PointerMapView();
+}
+
+bool PointerScanner::getImageRange(HMODULE module, uintptr_t& outBase, size_t& outSize) {
+	outBase = (uintptr_t)module;
+	outSize = 0;
+	if (module == nullptr) {
+		return false;
+	}
+
+	__try {
+		const IMAGE_DOS_HEADER* dosHeader = (const IMAGE_DOS_HEADER*)module;
+		if (dosHeader->e_magic != IMAGE_DOS_SIGNATURE) {
+			return false;
+		}
+
+		const IMAGE_NT_HEADERS* ntHeaders = (const IMAGE_NT_HEADERS*)(outBase + dosHeader->e_lfanew);
+		if (ntHeaders->Signature != IMAGE_NT_SIGNATURE) {
+			return false;
+		}
+
+		outSize = ntHeaders->OptionalHeader.SizeOfImage;
+		return true;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER) {
+		return false;
+	}
+}
+
+void PointerScanner::buildTargetFilter() {
+	targetRegions.clear();
+	targetGranules.clear();
+	targetStart = 0;
+	targetEnd = 0;
+
+	// Pointers may target any readable memory, not just the scan ranges
+	std::vector<MemoryRegion> regions = enumerateSafeRegions(false);
+	for (const MemoryRegion& region : regions) {
+		if (!targetRegions.empty() && targetRegions.back().base + targetRegions.back().size == region.base) {
+			targetRegions.back().size += region.size;
+		} else {
+			targetRegions.push_back(region);
+		}
+	}
+
+	if (targetRegions.empty()) {
+		return;
+	}
+
+	targetStart = targetRegions.front().base;
+	targetEnd = targetRegions.back().base + targetRegions.back().size;
+
+	// Coarser granules if the span is too large (64 bit) so the bits stay small
+	granuleShift = MIN_GRANULE_SHIFT;
+	while (((targetEnd - targetStart) >> granuleShift) >= MAX_GRANULES) {
+		granuleShift++;
+	}
+
+	size_t granuleCount = ((targetEnd - targetStart - 1) >> granuleShift) + 1;
+	targetGranules.assign((granuleCount + 31) / 32, 0);
+	for (const MemoryRegion& region : targetRegions) {
+		size_t first = (region.base - targetStart) >> granuleShift;
+		size_t last = (region.base + region.size - 1 - targetStart) >> granuleShift;
+		for (size_t g = first; g <= last; g++) {
+			targetGranules[g >> 5] |= (uint32_t)1 << (g & 31);
+		}
+	}
+}
+
+bool PointerScanner::isPointerTarget(uintptr_t value) const {
+	// Single compare covers both ends since values below targetStart wrap
+	if (value - targetStart >= targetEnd - targetStart) {
+		return false;
+	}
+
+	size_t granule = (value - targetStart) >> granuleShift;
+	if ((targetGranules[granule >> 5] & ((uint32_t)1 << (granule & 31))) == 0) {
+		return false;
+	}
+
+	// Granules can be shared with unreadable pages so confirm with the region
+	auto it = std::upper_bound(targetRegions.begin(), targetRegions.end(), value,
+	                           [](uintptr_t v, const MemoryRegion& region) { return v < region.base; });
+	if (it == targetRegions.begin()) {
+		return false;
+	}
+	--it;
+	return value - it->base < it->size;
+}
+
+bool PointerScanner::setupScanCommon(ScanType scanType, const void* targetValue, size_t valueSize) {
+	// Memory layout changes between scans so the filter is rebuilt every time
+	buildTargetFilter();
+	if (targetRegions.empty()) {
+		addError("No readable memory regions found for pointer targets");
+		return false;
+	}
+
+	if (!getImageRange(GetModuleHandle(nullptr), staticBase, staticSize)) {
+		addError("Failed to read the exe image headers for the static base range");
+		return false;
+	}
+	return true;
+}
+
+bool PointerScanner::validateFirstScanType(ScanType scanType) {
+	// First scan builds the map of every pointer
+	if (scanType != ScanType::EXACT) {
+		addError("First scan for pointers only supports EXACT scan type");
+		return false;
+	}
+	return true;
+}
+
+void PointerScanner::firstScanImpl(ScanType scanType, const void* targetValue, size_t valueSize) {
+	Scanner::firstScanImpl(scanType, targetValue, valueSize);
+
+	rebuildPointerMap();
+}
+
+void PointerScanner::rescanImpl(ScanType scanType, const void* targetValue, size_t valueSize) {
+	Scanner::rescanImpl(scanType, targetValue, valueSize);
+	rebuildPointerMap();
+}
+
+void PointerScanner::rebuildPointerMap() {
+	if (results.size() > UINT32_MAX) {
+		addError("Too many pointers (%zu) for the pointer map", results.size());
+		results.truncate(UINT32_MAX);
+	}
+
+	// Results are in address order so sorting their indices by pointee gives
+	// the reverse map and inverting that gives the address order
+	std::vector<uint32_t, ScannerAllocator<uint32_t>> valueOrder(results.size());
+	for (size_t i = 0; i < results.size(); i++) {
+		valueOrder[i] = (uint32_t)i;
+	}
+	std::sort(valueOrder.begin(), valueOrder.end(), [this](uint32_t a, uint32_t b) {
+		uintptr_t valueA = results.getValue(a).pointerValue;
+		uintptr_t valueB = results.getValue(b).pointerValue;
+		return valueA < valueB || (valueA == valueB && a < b);
+	});
+
+	mapValues.resize(results.size());
+	mapAddresses.resize(results.size());
+	mapAddressOrder.resize(results.size());
+	for (size_t i = 0; i < valueOrder.size(); i++) {
+		mapValues[i] = results.getValue(valueOrder[i]).pointerValue;
+		mapAddresses[i] = results.getAddress(valueOrder[i]);
+		mapAddressOrder[valueOrder[i]] = (uint32_t)i;
+	}
+
+	mapView.values = mapValues.data();
+	mapView.addresses = mapAddresses.data();
+	mapView.addressOrder = mapAddressOrder.data();
+	mapView.count = mapValues.size();
+	mapView.staticBase = staticBase;
+	mapView.staticSize = staticSize;
+}
+
+bool PointerScanner::saveMap(const char* path) const {
+	if (!firstScanDone) {
+		addError("Pointer map has not been built - call buildPointerMap first");
+		return false;
+	}
+
+	// Store the exe name so snapshots from other builds are easy to tell apart
+	char modulePath[MAX_PATH] = {};
+	GetModuleFileNameA(GetModuleHandle(nullptr), modulePath, MAX_PATH);
+	const char* moduleName = strrchr(modulePath, '\\');
+	moduleName = moduleName ? moduleName + 1 : modulePath;
+
+	std::string error;
+	if (!PointerMapFile::save(path, mapView, moduleName, error)) {
+		addError("%s", error.c_str());
+		return false;
+	}
+	return true;
+}
+
+void PointerScanner::scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
+                                        ScanType scanType, const void* targetValue,
+                                        std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+	size_t misalignment = chunkBase % alignment;
+	size_t offset = misalignment == 0 ? 0 : alignment - misalignment;
+
+	while (offset + sizeof(uintptr_t) <= chunkSize && localResults.size() < maxLocalResults) {
+		uintptr_t value;
+		memcpy(&value, buffer + offset, sizeof(value));
+		if (isPointerTarget(value)) {
+			ScanResult result;
+			result.address = chunkBase + offset;
+			result.value.pointerValue = value;
+			localResults.push_back(result);
+		}
+		offset += alignment;
+	}
+}
+
+bool PointerScanner::checkMatch(uintptr_t current, uintptr_t old, ScanType scanType) const {
+	switch (scanType) {
+		case ScanType::EXACT:
+			return isPointerTarget(current);
+		case ScanType::NOT:
+			return !isPointerTarget(current);
+		case ScanType::UNCHANGED:
+			return current == old;
+		case ScanType::CHANGED:
+			return current != old && isPointerTarget(current);
+		case ScanType::INCREASED:
+		case ScanType::DECREASED:
+			addError("Only EXACT, NOT, CHANGED and UNCHANGED scans supported for POINTER");
+			return false;
+		default:
+			addError("Invalid scan type in checkMatch: %d", (int)scanType);
+			return false;
+	}
+}
+
+bool PointerScanner::validateValueInBuffer(const uint8_t* buffer, size_t bufferSize, size_t offset,
+                                             uintptr_t actualAddress, ScanType scanType, const void* targetValue,
+                                             ScanResult& outResult) const {
+	outResult.address = actualAddress;
+	if (offset + sizeof(uintptr_t) > bufferSize) {
+		return false;
+	}
+
+	memcpy(&outResult.value.pointerValue, buffer + offset, sizeof(uintptr_t));
+	return checkMatch(outResult.value.pointerValue, outResult.oldValue.pointerValue, scanType);
+}
+
+bool PointerScanner::validateValueDirect(uintptr_t address, uintptr_t regionStart, uintptr_t regionEnd,
+                                           ScanType scanType, const void* targetValue,
+                                           ScanResult& outResult) const {
+	outResult.address = address;
+	if (address + sizeof(uintptr_t) > regionEnd) {
+		return false;
+	}
+
+	__try {
+		outResult.value.pointerValue = *(const uintptr_t*)address;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER) {
+		return false;
+	}
+	return checkMatch(outResult.value.pointerValue, outResult.oldValue.pointerValue, scanType);
+}
+
+bool PointerScanner::findChains(uintptr_t target, size_t maxDepth, size_t maxOffset, size_t maxChains, ChainList& outChains) const {
+	outChains.clear();
+
+	if (!firstScanDone) {
+		addError("Pointer map has not been built - call buildPointerMap first");
+		return false;
+	}
+	if (maxDepth == 0 || maxDepth > MAX_POINTER_DEPTH) {
+		addError("maxDepth (%zu) must be between 1 and %zu", maxDepth, MAX_POINTER_DEPTH);
+		return false;
+	}
+	if (maxOffset > MAX_POINTER_OFFSET) {
+		addError("maxOffset (%zu) exceeds maximum allowed offset (%zu)", maxOffset, MAX_POINTER_OFFSET);
+		return false;
+	}
+	if (maxChains == 0) {
+		addError("maxChains cannot be 0");
+		return false;
+	}
+
+	if (!mapView.findChains(target, maxDepth, maxOffset, maxChains, outChains)) {
+		addError("Chain search stopped after visiting %zu slots, some chains may be missing", MAX_CHAIN_SEARCH_VISITS);
+	} else if (outChains.size() >= maxChains) {
+		addError("Maximum chains (%zu) reached, stopping search early", maxChains);
+	}
+	return true;
+}
@@ -0,0 +1,118 @@
+#ifndef SCANNER_POINTER_H
+#define SCANNER_POINTER_H
+
+#include "scanner_base.h"
+#include "scanner_pointer_map.h"
+#include <windows.h>
+
+// Maximum number of pointers followed from a static base to the target
+// Each extra level multiplies the search so keep this small
+const size_t MAX_POINTER_DEPTH = 8;
+
+// Maximum offset added to a pointer at each level of a chain
+const size_t MAX_POINTER_OFFSET = 0x10000;
+
+// Scanner implementation for pointer chain discovery
+// The first scan sweeps memory once for every aligned value that points into
+// readable memory and keeps it as a result (address = slot, value = pointee).
+// A reverse map sorted by pointee then answers "who points near X" with a
+// binary search so chains are found by walking back from the target to slots
+// in the exe image. The map can be saved and queried later through
+// PointerMapFile without rescanning
+//
+// Chains use the same format as MemoryAnalyzer's pointerChain. Starting at
+// the base, each offset is applied as addr = read(addr) + offset and the
+// last one lands on the target
+class PointerScanner : public Scanner {
+public:
+	typedef PointerMapView::PointerChain PointerChain;
+	typedef PointerMapView::ChainList ChainList;
+
+	// Override new/delete to allocate from scanner heap
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr) noexcept;
+
+	PointerScanner(size_t maxResults, size_t alignment);
+	virtual ~PointerScanner();
+
+	static PointerScanner* create(size_t maxResults, size_t alignment);
+
+	// Build the pointer map. Same as firstScan(EXACT, nullptr) but can be
+	// called again to rebuild it
+	void buildPointerMap();
+
+	// Find chains from a static base to the target, shortest first
+	// Returns false if the map has not been built or the limits are invalid
+	bool findChains(uintptr_t target, size_t maxDepth, size_t maxOffset, size_t maxChains, ChainList& outChains) const;
+
+	// View of the current map. Invalidated by the next scan or reset
+	const PointerMapView& getMapView() const { return mapView; }
+
+	// Save the current map for PointerMapFile::load
+	bool saveMap(const char* path) const;
+
+	// Address range chains may start from. Defaults to the exe image
+	uintptr_t getStaticBase() const { return staticBase; }
+	size_t getStaticSize() const { return staticSize; }
+
+	// Range of the loaded image that contains the module handle
+	static bool getImageRange(HMODULE module, uintptr_t& outBase, size_t& outSize);
+
+	virtual void reset() override;
+
+protected:
+	// Setup hook - build the pointee filter from the current memory layout
+	virtual bool setupScanCommon(ScanType scanType, const void* targetValue, size_t valueSize) override;
+
+	// only allow EXACT (build) for first scan
+	virtual bool validateFirstScanType(ScanType scanType) override;
+	// The pointer map is built after the scan
+	virtual bool supportsStepScan() const override { return false; }
+
+	// Results are sorted and the reverse map is rebuilt after each scan
+	virtual void firstScanImpl(ScanType scanType, const void* targetValue, size_t valueSize) override;
+	virtual void rescanImpl(ScanType scanType, const void* targetValue, size_t valueSize) override;
+
+	virtual void scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
+	                               ScanType scanType, const void* targetValue,
+	                               std::vector<ScanResult>& localResults, size_t maxLocalResults) override;
+
+	// Rescan pure virtuals - UNCHANGED keeps slots that still hold the same
+	// pointer, CHANGED keeps slots that now hold a different valid pointer
+	virtual bool validateValueDirect(uintptr_t address, uintptr_t regionStart, uintptr_t regionEnd,
+	                                  ScanType scanType, const void* targetValue,
+	                                  ScanResult& outResult) const override;
+	virtual bool validateValueInBuffer(const uint8_t* buffer, size_t bufferSize, size_t offset,
+	                                    uintptr_t actualAddress, ScanType scanType, const void* targetValue,
+	                                    ScanResult& outResult) const override;
+
+	// Getters
+	virtual size_t getDataTypeSize() const override { return sizeof(uintptr_t); }
+
+private:
+	// Pointee filter. A bit per granule of the readable address span rejects
+	// most non pointers before the region binary search
+	bool isPointerTarget(uintptr_t value) const;
+	void buildTargetFilter();
+	bool checkMatch(uintptr_t current, uintptr_t old, ScanType scanType) const;
+
+	void rebuildPointerMap();
+
+	// Readable regions sorted by base with adjacent regions merged
+	std::vector<MemoryRegion, ScannerAllocator<MemoryRegion>> targetRegions;
+	std::vector<uint32_t, ScannerAllocator<uint32_t>> targetGranules;
+	uintptr_t targetStart;
+	uintptr_t targetEnd;
+	unsigned granuleShift;
+
+	uintptr_t staticBase;
+	size_t staticSize;
+
+	// Map columns. See PointerMapView
+	std::vector<uintptr_t, ScannerAllocator<uintptr_t>> mapValues;
+	std::vector<uintptr_t, ScannerAllocator<uintptr_t>> mapAddresses;
+	std::vector<uint32_t, ScannerAllocator<uint32_t>> mapAddressOrder;
+	PointerMapView mapView;
+};
+
+#endif
@@ -0,0 +1,258 @@
+#include "stdafx.h"
+#include "scanner_pointer_map.h"
+
+#include <algorithm>
+#include <cstring>
+#include <windows.h>
+
+bool PointerMapView::readSlot(uintptr_t address, uintptr_t& outValue) const {
+	size_t low = 0;
+	size_t high = count;
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		if (addresses[addressOrder[mid]] < address) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	if (low == count || addresses[addressOrder[low]] != address) {
+		return false;
+	}
+	outValue = values[addressOrder[low]];
+	return true;
+}
+
+bool PointerMapView::findChains(uintptr_t target, size_t maxDepth, size_t maxOffset, size_t maxChains, ChainList& outChains) const {
+	outChains.clear();
+
+	ChainSearch search;
+	search.maxOffset = maxOffset;
+	search.maxChains = maxChains;
+	search.visits = 0;
+	search.deadEnds.assign(count, 0);
+
+	// Iterative deepening so chains come out shortest first and long chains
+	// can't fill maxChains before the short ones are found. Dead ends carry
+	// over between depths since they only depend on the steps left
+	for (size_t chainDepth = 1; chainDepth <= maxDepth && outChains.size() < maxChains; chainDepth++) {
+		search.chainDepth = chainDepth;
+		searchChains(target, 0, search, outChains);
+		if (search.visits >= MAX_CHAIN_SEARCH_VISITS) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Walk back from address through every slot pointing at most maxOffset below it
+// offsets holds the offsets from the target outwards. Slots already known to
+// be dead ends at this depth are skipped, so shared subtrees are walked once
+bool PointerMapView::searchChains(uintptr_t address, size_t depth, ChainSearch& search, ChainList& outChains) const {
+	uintptr_t lowest = address > search.maxOffset ? address - search.maxOffset : 0;
+	size_t i = std::lower_bound(values, values + count, lowest) - values;
+	size_t remaining = search.chainDepth - depth - 1;
+	bool found = false;
+
+	for (; i < count && values[i] <= address && outChains.size() < search.maxChains; i++) {
+		// Out of budget. Reported as found so nothing is marked a dead end
+		if (++search.visits >= MAX_CHAIN_SEARCH_VISITS) {
+			return true;
+		}
+
+		// Static slots end a chain so they are only reported at their own depth
+		if (isStaticAddress(addresses[i])) {
+			if (remaining == 0) {
+				search.offsets.push_back(address - values[i]);
+				PointerChain chain;
+				chain.base = addresses[i];
+				chain.baseOffset = addresses[i] - staticBase;
+				chain.offsets.assign(search.offsets.rbegin(), search.offsets.rend());
+				outChains.push_back(chain);
+				search.offsets.pop_back();
+				found = true;
+			}
+		} else if (remaining > 0) {
+			// One bit per depth fits MAX_POINTER_DEPTH. Deeper searches aren't memoized
+			uint8_t deadBit = remaining < 8 ? (uint8_t)(1 << remaining) : 0;
+			if (search.deadEnds[i] & deadBit) {
+				continue;
+			}
+
+			search.offsets.push_back(address - values[i]);
+			if (searchChains(addresses[i], depth + 1, search, outChains)) {
+				found = true;
+			} else {
+				search.deadEnds[i] |= deadBit;
+			}
+			search.offsets.pop_back();
+		}
+	}
+	return found;
+}
+
+bool PointerMapView::resolveChain(const PointerChain& chain, uintptr_t& outAddress) const {
+	uintptr_t address = staticBase + chain.baseOffset;
+	for (size_t offset : chain.offsets) {
+		uintptr_t value;
+		if (!readSlot(address, value)) {
+			return false;
+		}
+		address = value + offset;
+	}
+
+	outAddress = address;
+	return true;
+}
+
+size_t PointerMapView::filterChains(ChainList& chains, uintptr_t target) const {
+	chains.erase(std::remove_if(chains.begin(), chains.end(), [&](const PointerChain& chain) {
+		uintptr_t address;
+		return !resolveChain(chain, address) || address != target;
+	}), chains.end());
+	return chains.size();
+}
+
+void* PointerMapFile::operator new(size_t size) {
+	return ScannerHeap::allocate(size);
+}
+
+void PointerMapFile::operator delete(void* ptr) noexcept {
+	if (ptr) {
+		ScannerHeap::deallocate(ptr, 0);
+	}
+}
+
+PointerMapFile::PointerMapFile() :
+	file(INVALID_HANDLE_VALUE), mapping(nullptr), data(nullptr), module(nullptr)
+{
+}
+
+PointerMapFile::~PointerMapFile() {
+	close();
+}
+
+namespace {
+	bool writeAll(HANDLE file, const void* data, size_t size) {
+		const uint8_t* bytes = (const uint8_t*)data;
+		while (size > 0) {
+			// WriteFile takes a DWORD size so write large columns in pieces
+			DWORD toWrite = (DWORD)std::min<size_t>(size, 0x10000000);
+			DWORD written = 0;
+			if (!WriteFile(file, bytes, toWrite, &written, nullptr) || written != toWrite) {
+				return false;
+			}
+			bytes += written;
+			size -= written;
+		}
+		return true;
+	}
+}
+
+bool PointerMapFile::save(const char* path, const PointerMapView& view, const char* moduleName, std::string& outError) {
+	HANDLE out = CreateFileA(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (out == INVALID_HANDLE_VALUE) {
+		outError = "Failed to create pointer map file: " + std::string(path);
+		return false;
+	}
+
+	Header header;
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.pointerSize = sizeof(uintptr_t);
+	header.moduleCount = 1;
+	header.count = view.count;
+
+	ModuleEntry moduleEntry;
+	memset(&moduleEntry, 0, sizeof(moduleEntry));
+	strncpy_s(moduleEntry.name, sizeof(moduleEntry.name), moduleName ? moduleName : "", _TRUNCATE);
+	moduleEntry.base = view.staticBase;
+	moduleEntry.size = view.staticSize;
+
+	bool ok = writeAll(out, &header, sizeof(header)) &&
+	          writeAll(out, &moduleEntry, sizeof(moduleEntry)) &&
+	          writeAll(out, view.values, view.count * sizeof(uintptr_t)) &&
+	          writeAll(out, view.addresses, view.count * sizeof(uintptr_t)) &&
+	          writeAll(out, view.addressOrder, view.count * sizeof(uint32_t));
+	CloseHandle(out);
+
+	if (!ok) {
+		outError = "Failed to write pointer map file: " + std::string(path);
+	}
+	return ok;
+}
+
+bool PointerMapFile::load(const char* path) {
+	close();
+	error.clear();
+
+	file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		error = "Failed to open pointer map file: " + std::string(path);
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || (uint64_t)fileSize.QuadPart < sizeof(Header)) {
+		error = "Pointer map file is too small: " + std::string(path);
+		close();
+		return false;
+	}
+
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	data = mapping ? (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (data == nullptr) {
+		error = "Failed to map pointer map file: " + std::string(path);
+		close();
+		return false;
+	}
+
+	// Validate the header and that every column fits before using any of it
+	const Header* header = (const Header*)data;
+	if (header->magic != MAGIC || header->version != VERSION) {
+		error = "Not a pointer map file or unsupported version: " + std::string(path);
+		close();
+		return false;
+	}
+	if (header->pointerSize != sizeof(uintptr_t)) {
+		error = "Pointer map file was saved with a different pointer size: " + std::string(path);
+		close();
+		return false;
+	}
+
+	uint64_t count = header->count;
+	uint64_t columnsStart = sizeof(Header) + (uint64_t)header->moduleCount * sizeof(ModuleEntry);
+	uint64_t expectedSize = columnsStart + count * (2 * sizeof(uintptr_t) + sizeof(uint32_t));
+	if (header->moduleCount == 0 || count > UINT32_MAX || (uint64_t)fileSize.QuadPart < expectedSize) {
+		error = "Pointer map file is truncated or corrupt: " + std::string(path);
+		close();
+		return false;
+	}
+
+	module = (const ModuleEntry*)(data + sizeof(Header));
+	view.count = (size_t)count;
+	view.values = (const uintptr_t*)(data + columnsStart);
+	view.addresses = view.values + view.count;
+	view.addressOrder = (const uint32_t*)(view.addresses + view.count);
+	view.staticBase = (uintptr_t)module->base;
+	view.staticSize = (size_t)module->size;
+	return true;
+}
+
+void PointerMapFile::close() {
+	if (data != nullptr) {
+		UnmapViewOfFile(data);
+		data = nullptr;
+	}
+	if (mapping != nullptr) {
+		CloseHandle(mapping);
+		mapping = nullptr;
+	}
+	if (file != INVALID_HANDLE_VALUE) {
+		CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+	}
+	module = nullptr;
+	view = PointerMapView();
+}
@@ -0,0 +1,131 @@
+#ifndef SCANNER_POINTER_MAP_H
+#define SCANNER_POINTER_MAP_H
+
+#include "scanner_heap.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <windows.h>
+
+// Slots one chain search may visit before it gives up
+const size_t MAX_CHAIN_SEARCH_VISITS = 64 * 1024 * 1024;
+
+// Read only view of a pointer map. Backed either by a live PointerScanner or
+// by a memory mapped snapshot file so chain queries work the same on both
+//
+// Columns are parallel arrays. values/addresses are sorted by pointee for
+// reverse lookups and addressOrder indexes them in slot address order for
+// forward lookups (reading a slot without touching live memory)
+class PointerMapView {
+public:
+	struct PointerChain {
+		uintptr_t base;       // Static slot the chain starts from
+		size_t baseOffset;    // base relative to the static range so chains compare across launches
+		std::vector<size_t, ScannerAllocator<size_t>> offsets;
+	};
+
+	typedef std::vector<PointerChain, ScannerAllocator<PointerChain>> ChainList;
+
+	const uintptr_t* values;
+	const uintptr_t* addresses;
+	const uint32_t* addressOrder;
+	size_t count;
+
+	// Range chains may start from (the exe image)
+	uintptr_t staticBase;
+	size_t staticSize;
+
+	PointerMapView() : values(nullptr), addresses(nullptr), addressOrder(nullptr), count(0), staticBase(0), staticSize(0) {}
+
+	bool isStaticAddress(uintptr_t address) const { return address - staticBase < staticSize; }
+
+	// Value the map recorded for a slot. False if the slot held no pointer
+	bool readSlot(uintptr_t address, uintptr_t& outValue) const;
+
+	// Find chains from a static base to the target, shortest first
+	// Limits are checked by the callers. Returns false if the search stopped
+	// after MAX_CHAIN_SEARCH_VISITS slots, so chains may be missing
+	bool findChains(uintptr_t target, size_t maxDepth, size_t maxOffset, size_t maxChains, ChainList& outChains) const;
+
+	// Follow a chain through this map starting at staticBase + chain.baseOffset
+	// False if a slot along the way held no pointer
+	bool resolveChain(const PointerChain& chain, uintptr_t& outAddress) const;
+
+	// Drop chains that don't reach target when followed through this map
+	// Used to keep chains that survive a restart. Returns the chains left
+	size_t filterChains(ChainList& chains, uintptr_t target) const;
+
+private:
+	// State of one findChains call
+	struct ChainSearch {
+		size_t chainDepth;
+		size_t maxOffset;
+		size_t maxChains;
+		size_t visits;
+		std::vector<size_t, ScannerAllocator<size_t>> offsets;
+		// Per slot, bit r is set once the slot is known to reach no static
+		// base in exactly r more steps
+		std::vector<uint8_t, ScannerAllocator<uint8_t>> deadEnds;
+	};
+
+	// Returns true if any chain was found below address
+	bool searchChains(uintptr_t address, size_t depth, ChainSearch& search, ChainList& outChains) const;
+};
+
+// Pointer map snapshot on disk
+// Layout (native pointer size, little endian):
+//   PointerMapFile::Header
+//   ModuleEntry[moduleCount]  - module base table. Entry 0 is the static range
+//   uintptr_t values[count]
+//   uintptr_t addresses[count]
+//   uint32_t addressOrder[count]
+// Files are mapped read only so queries don't copy the columns
+class PointerMapFile {
+public:
+	static const uint32_t MAGIC = 0x4D504D48;  // "HMPM"
+	static const uint32_t VERSION = 1;
+
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t pointerSize;
+		uint32_t moduleCount;
+		uint64_t count;
+	};
+
+	// Module the addresses are relative to. Kept so snapshots from other
+	// launches can be rebased onto where the module loaded this time
+	struct ModuleEntry {
+		char name[64];
+		uint64_t base;
+		uint64_t size;
+	};
+
+	// Override new/delete to allocate from scanner heap
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr) noexcept;
+
+	PointerMapFile();
+	~PointerMapFile();
+
+	// Write a view to disk. moduleName is stored in the module table
+	static bool save(const char* path, const PointerMapView& view, const char* moduleName, std::string& outError);
+
+	bool load(const char* path);
+	void close();
+
+	bool isLoaded() const { return data != nullptr; }
+	const PointerMapView& getView() const { return view; }
+	const ModuleEntry& getModule() const { return *module; }
+	const std::string& getError() const { return error; }
+
+private:
+	HANDLE file;
+	HANDLE mapping;
+	const uint8_t* data;
+	const ModuleEntry* module;
+	PointerMapView view;
+	std::string error;
+};
+
+#endif
@@ -0,0 +1,112 @@
+#include "stdafx.h"
+#include "scanner_result_sink.h"
+
+#include <algorithm>
+#include <memory>
+
+ResultSink::ResultSink(size_t capacity, int threadCount) :
+	capacity(capacity), reserved(0), full(capacity == 0), threads(threadCount < 1 ? 1 : threadCount)
+{
+	for (ThreadState& state : threads) {
+		state.used = RESULT_BLOCK_SIZE;
+		state.lastUnit = UINT32_MAX;
+		state.sequence = 0;
+	}
+}
+
+ResultSink::~ResultSink() {
+	for (ThreadState& state : threads) {
+		for (ScanResult* block : state.blocks) {
+			if (block != nullptr) {
+				ScannerHeap::deallocate(block, RESULT_BLOCK_SIZE * sizeof(ScanResult));
+			}
+		}
+	}
+}
+
+size_t ResultSink::reserve(size_t count) {
+	size_t current = reserved.load(std::memory_order_relaxed);
+	for (;;) {
+		size_t granted = std::min<size_t>(count, capacity - current);
+		if (granted < count) {
+			full.store(true, std::memory_order_relaxed);
+		}
+		if (granted == 0) {
+			return 0;
+		}
+		if (reserved.compare_exchange_weak(current, current + granted, std::memory_order_relaxed)) {
+			return granted;
+		}
+	}
+}
+
+size_t ResultSink::getRemaining() const {
+	return capacity - reserved.load(std::memory_order_relaxed);
+}
+
+void ResultSink::append(int thread, uint32_t unit, const ScanResult* first, size_t count) {
+	ThreadState& state = threads[thread];
+	if (unit != state.lastUnit) {
+		state.lastUnit = unit;
+		state.sequence = 0;
+	}
+
+	while (count > 0) {
+		if (state.used == RESULT_BLOCK_SIZE) {
+			ScanResult* block = (ScanResult*)ScannerHeap::allocate(RESULT_BLOCK_SIZE * sizeof(ScanResult));
+			if (block == nullptr) {
+				throw std::bad_alloc();
+			}
+			state.blocks.push_back(block);
+			state.blockPending.push_back(0);
+			state.used = 0;
+		}
+
+		size_t toCopy = std::min<size_t>(count, RESULT_BLOCK_SIZE - state.used);
+		ScanResult* dest = state.blocks.back() + state.used;
+		std::uninitialized_copy(first, first + toCopy, dest);
+
+		// Extend the last span if this continues it in the same block
+		size_t blockIdx = state.blocks.size() - 1;
+		if (!state.spans.empty() && state.spans.back().unit == unit && state.spans.back().block == blockIdx &&
+		    state.spans.back().first + state.spans.back().count == dest) {
+			state.spans.back().count += toCopy;
+		} else {
+			Span span = { unit, state.sequence++, dest, toCopy, blockIdx, thread };
+			state.spans.push_back(span);
+		}
+
+		state.blockPending[blockIdx] += toCopy;
+		state.used += toCopy;
+		first += toCopy;
+		count -= toCopy;
+	}
+}
+
+void ResultSink::drain(ResultStore& out) {
+	std::vector<Span, ScannerAllocator<Span>> spans;
+	for (const ThreadState& state : threads) {
+		spans.insert(spans.end(), state.spans.begin(), state.spans.end());
+	}
+	std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) {
+		return a.unit < b.unit || (a.unit == b.unit && a.sequence < b.sequence);
+	});
+
+	// Blocks are freed as soon as they are copied out so the peak stays near
+	// one copy of the results
+	out.reserve(out.size() + reserved.load());
+	for (const Span& span : spans) {
+		out.append(span.first, span.count);
+
+		ThreadState& state = threads[span.thread];
+		state.blockPending[span.block] -= span.count;
+		if (state.blockPending[span.block] == 0) {
+			ScannerHeap::deallocate(state.blocks[span.block], RESULT_BLOCK_SIZE * sizeof(ScanResult));
+			state.blocks[span.block] = nullptr;
+		}
+	}
+
+	for (ThreadState& state : threads) {
+		state.spans.clear();
+	}
+}
@@ -0,0 +1,64 @@
+#ifndef SCANNER_RESULT_SINK_H
+#define SCANNER_RESULT_SINK_H
+
+#include "scanner_base.h"
+#include <atomic>
+
+// Results per sink block. 16K results is 512KB at 32 bytes each
+const size_t RESULT_BLOCK_SIZE = 16384;
+
+// Shared, bounded store for first scan results
+// Threads reserve slots with an atomic counter before keeping results so the
+// capacity is never exceeded and every thread sees the sink fill at once.
+// Kept results are copied into per thread blocks that are only allocated
+// as they fill, so memory follows the number of results rather than
+// threads x capacity. Results are tagged with their work unit and drained
+// in unit order
+class ResultSink {
+public:
+	ResultSink(size_t capacity, int threadCount);
+	~ResultSink();
+
+	// Reserve up to count slots. Returns the number granted which is less
+	// than count once the sink fills
+	size_t reserve(size_t count);
+
+	bool isFull() const { return full.load(std::memory_order_relaxed); }
+	size_t getRemaining() const;
+	size_t getCount() const { return reserved.load(std::memory_order_relaxed); }
+
+	// Store results that were granted by reserve
+	void append(int thread, uint32_t unit, const ScanResult* first, size_t count);
+
+	// Move every result into out in unit order and free the blocks
+	void drain(ResultStore& out);
+
+private:
+	// Run of results from one unit in one block
+	struct Span {
+		uint32_t unit;
+		uint32_t sequence;  // Order within the unit when it spans blocks
+		ScanResult* first;
+		size_t count;
+		size_t block;       // Index into the thread's blocks
+		int thread;
+	};
+
+	// Own cache line per thread so appends don't contend
+	struct ThreadState {
+		std::vector<ScanResult*, ScannerAllocator<ScanResult*>> blocks;
+		std::vector<size_t, ScannerAllocator<size_t>> blockPending;  // Results of a block not yet drained
+		std::vector<Span, ScannerAllocator<Span>> spans;
+		size_t used;         // Results in the last block
+		uint32_t lastUnit;
+		uint32_t sequence;
+		uint8_t padding[64];
+	};
+
+	size_t capacity;
+	std::atomic<size_t> reserved;
+	std::atomic<bool> full;
+	std::vector<ThreadState, ScannerAllocator<ThreadState>> threads;
+};
+
+#endif
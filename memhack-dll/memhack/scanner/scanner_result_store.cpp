@@ -0,0 +1,86 @@
+#include "stdafx.h"
+#include "scanner_result_store.h"
+
+#include <algorithm>
+
+ResultStore::ResultStore(size_t valueSize, bool hasOldValues) :
+	valueSize(std::min<size_t>(valueSize, sizeof(ScanValue))), hasOldValues(hasOldValues) {}
+
+size_t ResultStore::getMemoryUsage() const {
+	return addresses.capacity() * sizeof(uintptr_t) + values.capacity() + oldValues.capacity();
+}
+
+void ResultStore::clear() {
+	addresses.clear();
+	values.clear();
+	oldValues.clear();
+}
+
+void ResultStore::reserve(size_t count) {
+	addresses.reserve(count);
+	values.reserve(count * valueSize);
+	if (hasOldValues) {
+		oldValues.reserve(count * valueSize);
+	}
+}
+
+void ResultStore::truncate(size_t count) {
+	if (count >= addresses.size()) {
+		return;
+	}
+	addresses.resize(count);
+	values.resize(count * valueSize);
+	if (hasOldValues) {
+		oldValues.resize(count * valueSize);
+	}
+}
+
+void ResultStore::append(const ScanResult* first, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		push_back(first[i]);
+	}
+}
+
+void ResultStore::append(const ResultStore& other) {
+	addresses.insert(addresses.end(), other.addresses.begin(), other.addresses.end());
+	values.insert(values.end(), other.values.begin(), other.values.end());
+	oldValues.insert(oldValues.end(), other.oldValues.begin(), other.oldValues.end());
+}
+
+void ResultStore::copyTo(size_t first, size_t last, std::vector<ScanResult, ScannerAllocator<ScanResult>>& out) const {
+	out.clear();
+	out.reserve(last - first);
+	for (size_t i = first; i < last; i++) {
+		out.push_back((*this)[i]);
+	}
+}
+
+void ResultStore::sortByAddress() {
+	std::vector<size_t, ScannerAllocator<size_t>> order(addresses.size());
+	for (size_t i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+		return addresses[a] < addresses[b];
+	});
+
+	// Permute each column through a copy
+	std::vector<uintptr_t, ScannerAllocator<uintptr_t>> sortedAddresses(order.size());
+	for (size_t i = 0; i < order.size(); i++) {
+		sortedAddresses[i] = addresses[order[i]];
+	}
+	addresses.swap(sortedAddresses);
+
+	auto permuteValues = [&](std::vector<uint8_t, ScannerAllocator<uint8_t>>& column) {
+		if (column.empty()) {
+			return;
+		}
+		std::vector<uint8_t, ScannerAllocator<uint8_t>> sorted(column.size());
+		for (size_t i = 0; i < order.size(); i++) {
+			memcpy(sorted.data() + i * valueSize, column.data() + order[i] * valueSize, valueSize);
+		}
+		column.swap(sorted);
+	};
+	permuteValues(values);
+	permuteValues(oldValues);
+}
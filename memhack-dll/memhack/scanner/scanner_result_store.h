@@ -0,0 +1,111 @@
+#ifndef SCANNER_RESULT_STORE_H
+#define SCANNER_RESULT_STORE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include "scanner_heap.h"
+
+union ScanValue {
+	uint8_t byteValue;
+	int32_t intValue;
+	float floatValue;
+	double doubleValue;
+	bool boolValue;
+	uintptr_t pointerValue;
+};
+
+// Single scan result
+// Will only include basic type data. Sequences are not stored
+// Used while scanning. Results kept between scans live in a ResultStore
+struct ScanResult {
+	uintptr_t address;
+	ScanValue value;
+	ScanValue oldValue;
+	bool hasOldValue;
+
+	ScanResult() : address(0), hasOldValue(false) {
+		value.doubleValue = 0.0;
+		oldValue.doubleValue = 0.0;
+	}
+};
+
+// Column storage for the results kept between scans
+// Addresses, values and old values are separate columns and values only
+// take the size of the scanned type, so an INT result is 12 bytes rather
+// than a full ScanResult. Scanners that don't keep values store addresses
+// only. Every union member starts at offset 0 so the low valueSize bytes
+// of a ScanValue hold the value
+class ResultStore {
+public:
+	ResultStore() : valueSize(0), hasOldValues(false) {}
+	ResultStore(size_t valueSize, bool hasOldValues);
+
+	size_t size() const { return addresses.size(); }
+	bool empty() const { return addresses.empty(); }
+	size_t getValueSize() const { return valueSize; }
+	bool storesOldValues() const { return hasOldValues; }
+
+	// Bytes held by the columns
+	size_t getMemoryUsage() const;
+
+	// Clear results but keep the layout and the allocations
+	void clear();
+	void reserve(size_t count);
+	// Only shrinks. Used to cap results that index into 32 bit tables
+	void truncate(size_t count);
+
+	void push_back(const ScanResult& result) {
+		addresses.push_back(result.address);
+		if (valueSize > 0) {
+			size_t offset = values.size();
+			values.resize(offset + valueSize);
+			memcpy(values.data() + offset, &result.value, valueSize);
+			if (hasOldValues) {
+				oldValues.resize(offset + valueSize);
+				memcpy(oldValues.data() + offset, &result.oldValue, valueSize);
+			}
+		}
+	}
+	void append(const ScanResult* first, size_t count);
+	// other must have the same layout
+	void append(const ResultStore& other);
+
+	uintptr_t getAddress(size_t index) const { return addresses[index]; }
+	ScanValue getValue(size_t index) const { return readValue(values, index); }
+	ScanValue getOldValue(size_t index) const { return hasOldValues ? readValue(oldValues, index) : ScanValue(); }
+
+	// Rebuild a full result
+	ScanResult operator[](size_t index) const {
+		ScanResult result;
+		result.address = addresses[index];
+		result.value = getValue(index);
+		result.oldValue = getOldValue(index);
+		result.hasOldValue = hasOldValues;
+		return result;
+	}
+
+	// Rebuild results [first, last) into out
+	void copyTo(size_t first, size_t last, std::vector<ScanResult, ScannerAllocator<ScanResult>>& out) const;
+
+	// Stable sort of every column by address
+	void sortByAddress();
+
+private:
+	ScanValue readValue(const std::vector<uint8_t, ScannerAllocator<uint8_t>>& column, size_t index) const {
+		ScanValue value;
+		value.doubleValue = 0.0;
+		if (valueSize > 0) {
+			memcpy(&value, column.data() + index * valueSize, valueSize);
+		}
+		return value;
+	}
+
+	std::vector<uintptr_t, ScannerAllocator<uintptr_t>> addresses;
+	std::vector<uint8_t, ScannerAllocator<uint8_t>> values;
+	std::vector<uint8_t, ScannerAllocator<uint8_t>> oldValues;
+	size_t valueSize;
+	bool hasOldValues;
+};
+
+#endif
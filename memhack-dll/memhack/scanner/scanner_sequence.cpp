@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "scanner_sequence.h"
+#include "scanner_sequence_kernels.h"
 #include "../safememory.h"
 
 #include <cmath>
@@ -17,8 +18,14 @@ void SequenceScanner::operator delete(void* ptr) noexcept {
 }
 
 SequenceScanner::SequenceScanner(DataType dataType, size_t maxResults, size_t alignment) :
-	Scanner(maxResults, alignment), dataType(dataType)
+	Scanner(maxResults, alignment), dataType(dataType), chunkKernel(nullptr)
 {
+	anchorParams.sequence = nullptr;
+	anchorParams.size = 0;
+	anchorParams.mask = nullptr;
+	anchorParams.rareIndex = 0;
+	anchorParams.pairIndex = 0;
+
 	// Just default to 1 for sequences
 	if (this->alignment == 0) {
 		this->alignment = 1;
@@ -49,23 +56,233 @@ void SequenceScanner::setSearchSequence(const void* data, size_t size) {
 	searchSequence.assign(bytes, bytes + size);
 }
 
+void SequenceScanner::setSearchPattern(const MaskedPattern& pattern) {
+	if (pattern.bytes.empty()) {
+		addError("Search pattern cannot be empty");
+		return;
+	}
+
+	// Bytes are masked again in case the caller built the pattern by hand
+	searchSequence.resize(pattern.bytes.size());
+	for (size_t i = 0; i < pattern.bytes.size(); i++) {
+		searchSequence[i] = pattern.bytes[i] & pattern.mask[i];
+	}
+	searchMask.assign(pattern.mask.begin(), pattern.mask.end());
+}
+
 bool SequenceScanner::compare(const uint8_t* a, const uint8_t* b, size_t size) {
 	// do mem compare to optimize and since we have the full
 	// string read in already
 	return memcmp(a, b, size) == 0;
 }
 
+bool SequenceScanner::matchesAt(const uint8_t* data) const {
+	if (searchMask.empty()) {
+		return compare(data, searchSequence.data(), searchSequence.size());
+	}
+	return SequenceKernels::maskedEquals(data, searchSequence.data(), searchMask.data(), searchSequence.size());
+}
+
+namespace {
+	int parseHexDigit(char c) {
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	bool isPatternSpace(char c) {
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	}
+}
+
+bool SequenceScanner::parsePattern(const char* text, MaskedPattern& outPattern) {
+	outPattern.bytes.clear();
+	outPattern.mask.clear();
+	if (text == nullptr) {
+		return false;
+	}
+
+	bool hasFixedByte = false;
+	const char* p = text;
+	while (true) {
+		while (isPatternSpace(*p)) {
+			p++;
+		}
+		if (*p == '\0') {
+			break;
+		}
+
+		// Token is one or two digits up to the next space
+		const char* tokenStart = p;
+		while (*p != '\0' && !isPatternSpace(*p)) {
+			p++;
+		}
+		size_t tokenSize = p - tokenStart;
+		if (tokenSize > 2) {
+			return false;
+		}
+
+		// Lone "?" is a full wildcard
+		if (tokenSize == 1) {
+			if (tokenStart[0] != '?') {
+				return false;
+			}
+			outPattern.bytes.push_back(0);
+			outPattern.mask.push_back(0);
+			continue;
+		}
+
+		uint8_t byte = 0;
+		uint8_t mask = 0;
+		for (size_t i = 0; i < 2; i++) {
+			byte <<= 4;
+			mask <<= 4;
+			if (tokenStart[i] == '?') {
+				continue;
+			}
+
+			int digit = parseHexDigit(tokenStart[i]);
+			if (digit < 0) {
+				return false;
+			}
+			byte |= (uint8_t)digit;
+			mask |= 0x0F;
+		}
+
+		hasFixedByte = hasFixedByte || mask == 0xFF;
+		outPattern.bytes.push_back(byte);
+		outPattern.mask.push_back(mask);
+	}
+
+	if (outPattern.bytes.size() > MAX_SEQUENCE_SIZE) {
+		return false;
+	}
+	return hasFixedByte;
+}
+
+// Rough byte frequencies of a 32 bit game process. Zero fill, small integers,
+// ASCII text, float exponent bytes and common x86 opcodes rank high. Only the
+// relative order matters
+uint8_t SequenceScanner::getByteFrequency(uint8_t value) {
+	static const uint8_t BYTE_FREQUENCY[256] = {
+		255, 200, 194, 188, 182, 176, 170, 164, 158, 152, 146, 140, 134, 128, 122, 150,  // 0x00
+		100,  45,  45,  45,  45,  45,  45,  45,  45,  45,  45,  45,  45,  45,  45,  45,  // 0x10
+		170,  40,  40,  40,  90,  40,  40,  40,  75,  75,  40,  40,  75,  75,  75,  75,  // 0x20
+		 85,  85,  85,  85,  85,  85,  85,  85,  85,  85,  75,  40,  40,  40,  40, 140,  // 0x30
+		135, 110, 105,  95,  85,  95,  70,  70,  70,  70,  70,  70,  70,  70,  70,  70,  // 0x40
+		 70,  70,  70,  70,  70,  80,  70,  70,  70,  70,  70,  40,  75,  75,  40,  75,  // 0x50
+		 40, 142,  74, 106, 114, 150,  90,  86, 122, 134,  62,  66, 110,  98, 130, 138,  // 0x60
+		 78,  54, 118, 126, 146, 102,  70,  94,  58,  82,  50,  40,  40,  40,  40,  40,  // 0x70
+		120,  30,  30,  85,  30,  30,  30,  30,  30, 100,  30, 110,  30,  30,  30,  30,  // 0x80
+		 95,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  // 0x90
+		 30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  60,  30,  30,  30,  30,  // 0xA0
+		 30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  55,  30,  30,  30,  30,  90,  // 0xB0
+		 90,  30,  30,  75,  30,  30,  30,  70,  30,  30,  30,  30, 120,  75,  30,  30,  // 0xC0
+		 30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  60,  30,  30,  // 0xD0
+		 30,  30,  30,  30,  30,  30,  30,  30,  90,  30,  30,  70,  30,  30,  55,  30,  // 0xE0
+		 65,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  30,  55,  60,  80, 220,  // 0xF0
+	};
+	return BYTE_FREQUENCY[value];
+}
+
+void SequenceScanner::selectAnchors(const uint8_t* sequence, const uint8_t* mask, size_t size, size_t& rareIndex, size_t& pairIndex) {
+	// Anchors are compared as whole bytes so only fully fixed positions qualify
+	// Patterns always have at least one (see setupScanCommon)
+	size_t rareRank = SIZE_MAX;
+	rareIndex = 0;
+	for (size_t i = 0; i < size; i++) {
+		if (mask != nullptr && mask[i] != 0xFF) {
+			continue;
+		}
+
+		size_t rank = getByteFrequency(sequence[i]);
+		if (rank < rareRank) {
+			rareIndex = i;
+			rareRank = rank;
+		}
+	}
+
+	// Prefer a different byte value for the pair. Two copies of the same byte
+	// filter far less than two different bytes
+	pairIndex = rareIndex;
+	size_t pairRank = SIZE_MAX;
+	for (size_t i = 0; i < size; i++) {
+		if (i == rareIndex || (mask != nullptr && mask[i] != 0xFF)) {
+			continue;
+		}
+
+		size_t rank = getByteFrequency(sequence[i]) + (sequence[i] == sequence[rareIndex] ? 256 : 0);
+		if (rank < pairRank) {
+			pairIndex = i;
+			pairRank = rank;
+		}
+	}
+}
+
+void SequenceScanner::buildSkipTable(const uint8_t* sequence, const uint8_t* mask, size_t size, size_t* skip) {
+	// A full wildcard matches any byte so no shift may move past the last one
+	// before the final position
+	size_t defaultShift = size;
+	size_t first = 0;
+	for (size_t j = 0; j + 1 < size; j++) {
+		if (mask != nullptr && mask[j] == 0) {
+			defaultShift = size - 1 - j;
+			first = j + 1;
+		}
+	}
+
+	for (size_t c = 0; c < 256; c++) {
+		skip[c] = defaultShift;
+	}
+
+	// Later positions overwrite earlier ones so each byte gets its smallest shift
+	for (size_t j = first; j + 1 < size; j++) {
+		uint8_t byteMask = mask != nullptr ? mask[j] : 0xFF;
+		for (size_t c = 0; c < 256; c++) {
+			if (((uint8_t)c & byteMask) == sequence[j]) {
+				skip[c] = size - 1 - j;
+			}
+		}
+	}
+}
+
+SequenceScanner::ChunkKernel SequenceScanner::selectChunkKernel(ScannerSimd::Level level, size_t sequenceSize, bool masked) {
+	// Masked patterns without SIMD skip with Horspool. The fixed bytes of
+	// typical signatures sit at both ends so the shifts stay long
+	if (masked && (level == ScannerSimd::Level::SCALAR || sequenceSize < 2)) {
+		return SequenceKernels::scanChunkHorspool;
+	}
+
+	// A single byte has no pair to check so memchr is as good as it gets
+	if (sequenceSize < 2) {
+		return SequenceKernels::scanChunkMemchr<false>;
+	}
+
+	switch (level) {
+		case ScannerSimd::Level::AVX512BW:
+			return SequenceKernels::getChunkKernelAVX512(masked);
+		case ScannerSimd::Level::AVX2:
+			return SequenceKernels::getChunkKernelAVX2(masked);
+		case ScannerSimd::Level::SSE2:
+			return SequenceKernels::getChunkKernelSSE2(masked);
+		case ScannerSimd::Level::SCALAR:
+		default:
+			return SequenceKernels::scanChunkMemchr<false>;
+	}
+}
+
 bool SequenceScanner::checkMatch(const uint8_t* dataToCompare, ScanType scanType) const {
 	switch (scanType) {
 		case ScanType::EXACT:
-			return compare(dataToCompare, searchSequence.data(), searchSequence.size());
+			return matchesAt(dataToCompare);
 		case ScanType::NOT:
-			return !compare(dataToCompare, searchSequence.data(), searchSequence.size());
+			return !matchesAt(dataToCompare);
 		case ScanType::CHANGED:
 		case ScanType::UNCHANGED:
 		case ScanType::INCREASED:
 		case ScanType::DECREASED:
-			addError("Only EXACT and NOT scans supported for STRING/BYTE_ARRAY");
+			addError("Only EXACT and NOT scans supported for STRING/BYTE_ARRAY/PATTERN");
 			return false;
 		default:
 			addError("Invalid scan type in checkMatch: %d", (int)scanType);
@@ -120,7 +337,36 @@ bool SequenceScanner::setupScanCommon(ScanType scanType, const void* targetValue
 		return false;
 	}
 
-	setSearchSequence(targetValue, valueSize);
+	// PATTERN targets are a MaskedPattern rather than raw bytes
+	if (dataType == DataType::PATTERN) {
+		const MaskedPattern* pattern = (const MaskedPattern*)targetValue;
+		if (pattern->bytes.size() != valueSize || pattern->mask.size() != valueSize) {
+			addError("Pattern bytes (%zu) and mask (%zu) must both match size (%zu)",
+			         pattern->bytes.size(), pattern->mask.size(), valueSize);
+			return false;
+		}
+		if (std::find(pattern->mask.begin(), pattern->mask.end(), (uint8_t)0xFF) == pattern->mask.end()) {
+			addError("Pattern must have at least one byte without wildcards");
+			return false;
+		}
+		setSearchPattern(*pattern);
+	} else {
+		setSearchSequence(targetValue, valueSize);
+		searchMask.clear();
+	}
+
+	// Anchors are picked per scan since the sequence can change between scans
+	const bool masked = !searchMask.empty();
+	anchorParams.sequence = searchSequence.data();
+	anchorParams.size = searchSequence.size();
+	anchorParams.mask = masked ? searchMask.data() : nullptr;
+	selectAnchors(anchorParams.sequence, anchorParams.mask, anchorParams.size, anchorParams.rareIndex, anchorParams.pairIndex);
+
+	ScannerSimd::Level level = ScannerSimd::getLevel();
+	chunkKernel = selectChunkKernel(level, anchorParams.size, masked);
+	if (chunkKernel == SequenceKernels::scanChunkHorspool) {
+		buildSkipTable(anchorParams.sequence, anchorParams.mask, anchorParams.size, anchorParams.skip);
+	}
 	return true;
 }
 
@@ -136,33 +382,58 @@ bool SequenceScanner::validateFirstScanType(ScanType scanType) {
 void SequenceScanner::scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
                                          ScanType scanType, const void* targetValue,
                                          std::vector<ScanResult>& localResults, size_t maxLocalResults) {
-	size_t dataSize = getDataTypeSize();
-	
-	// Optimized path using memchr
-	const uint8_t firstByte = searchSequence[0];
-	const uint8_t* searchStart = buffer;
-	const uint8_t* bufferEnd = buffer + chunkSize;
-	
-	while (searchStart < bufferEnd && localResults.size() < maxLocalResults) {
-		const uint8_t* found = (const uint8_t*)memchr(searchStart, firstByte, bufferEnd - searchStart);
-		
-		if (found == nullptr) {
+	// First scans are always EXACT (see validateFirstScanType) so the kernel
+	// only has to find exact matches
+	chunkKernel(anchorParams, buffer, chunkSize, chunkBase, localResults, maxLocalResults);
+}
+
+void SequenceScanner::rescanResultBatch(const std::vector<ScanResult, ScannerAllocator<ScanResult>>& oldResults,
+                                         size_t batchStart, size_t batchEnd,
+                                         uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
+                                         ScanType scanType, const void* targetValue,
+                                         ResultStore& newResults) {
+	const ScanResult* batch = oldResults.data() + batchStart;
+	size_t count = batchEnd - batchStart;
+
+	switch (scanType) {
+		case ScanType::EXACT:
+			rescanSequenceBatch<false>(batch, count, chunkStart, chunkSize, buffer, newResults);
 			break;
+		case ScanType::NOT:
+			rescanSequenceBatch<true>(batch, count, chunkStart, chunkSize, buffer, newResults);
+			break;
+		default:
+			// Unsupported types go through the generic path so checkMatch reports them
+			Scanner::rescanResultBatch(oldResults, batchStart, batchEnd, chunkStart, chunkSize, buffer,
+			                           scanType, targetValue, newResults);
+			break;
+	}
+}
+
+template<bool INVERT>
+void SequenceScanner::rescanSequenceBatch(const ScanResult* oldResults, size_t count, uintptr_t chunkStart, size_t chunkSize,
+                                          const uint8_t* buffer, ResultStore& newResults) {
+	const size_t seqSize = searchSequence.size();
+
+	size_t invalidCount = 0;
+	for (size_t i = 0; i < count; i++) {
+		const ScanResult& oldResult = oldResults[i];
+		size_t offset = oldResult.address - chunkStart;
+
+		// Verify address is within chunk and compare
+		if (offset + seqSize > chunkSize || matchesAt(buffer + offset) == INVERT) {
+			invalidCount++;
+			continue;
 		}
-		
-		size_t offset = found - buffer;
-		
-		if (offset + dataSize <= chunkSize) {
-			uintptr_t actualAddress = chunkBase + offset;
-			
-			ScanResult result;
-			if (validateValueInBuffer(buffer, chunkSize, offset, actualAddress, scanType, targetValue, result)) {
-				localResults.push_back(result);
-			}
-		}
-		
-		searchStart = found + 1;
+
+		ScanResult result;
+		result.address = oldResult.address;
+		result.oldValue = oldResult.value;
+		result.hasOldValue = true;
+		newResults.push_back(result);
 	}
+
+	invalidAddressCount += invalidCount;
 }
 
 // Process a single isolated result with direct memory read for rescan
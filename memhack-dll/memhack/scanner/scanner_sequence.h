@@ -2,6 +2,7 @@
 #define SCANNER_SEQUENCE_H
 
 #include "scanner_base.h"
+#include "scanner_simd.h"
 #include <windows.h>
 
 // Maximum size for sequence searches (strings/byte arrays)
@@ -14,15 +15,41 @@ static_assert(SCAN_BUFFER_SIZE > MAX_SEQUENCE_SIZE,
               "SCAN_BUFFER_SIZE must be greater than MAX_SEQUENCE_SIZE for overlap to work");
 
 // Scanner implementation for sequence types (STRING, BYTE_ARRAY)
-// Uses memchr-based optimization to quickly find candidate positions
+// Candidates are found by the two rarest bytes of the sequence rather than the
+// first byte so common leading bytes (0x00, spaces, 'e') don't turn every
+// position into a full compare
 class SequenceScanner : public Scanner {
 public:
     // Data types
     enum class DataType {
     	STRING, // Fixed length string. Does not check null term. If needed use byte array for now at least
-    	BYTE_ARRAY
+    	BYTE_ARRAY,
+    	PATTERN // Byte array with per byte masks, i.e. "8B 0D ?? ?? ?? ?? 85 C9"
     };
 
+	// Byte pattern with a mask per byte. A byte matches when (data & mask) == byte
+	// Bytes are stored pre-masked. Wildcards have mask 0x00
+	struct MaskedPattern {
+		std::vector<uint8_t, ScannerAllocator<uint8_t>> bytes;
+		std::vector<uint8_t, ScannerAllocator<uint8_t>> mask;
+	};
+
+	// Per-scan parameters handed to the chunk kernels
+	// Anchors are positions in the sequence. Both must match before the
+	// full sequence is compared
+	struct AnchorParams {
+		const uint8_t* sequence;
+		size_t size;
+		const uint8_t* mask;  // Per byte masks for PATTERN. nullptr for exact sequences
+		size_t rareIndex;     // Rarest fixed byte - memchr/SIMD search byte
+		size_t pairIndex;     // Second rarest. Same as rareIndex if there is only one fixed byte
+		size_t skip[256];     // Horspool shifts by last window byte. Only built for masked scalar scans
+	};
+
+	// Chunk kernel - finds every sequence start in the buffer
+	typedef void (*ChunkKernel)(const AnchorParams& params, const uint8_t* buffer, size_t chunkSize,
+	                            uintptr_t chunkBase, std::vector<ScanResult>& localResults, size_t maxLocalResults);
+
 	// Override new/delete to allocate from scanner heap
 	static void* operator new(size_t size);
 	static void operator delete(void* ptr) noexcept;
@@ -42,6 +69,29 @@ public:
 
 	static bool compare(const uint8_t* a, const uint8_t* b, size_t size);
 
+	// Approximate frequency of a byte in game process memory (0 = rare, 255 = common)
+	static uint8_t getByteFrequency(uint8_t value);
+
+	// Pick the two rarest positions of the sequence to anchor on
+	// Only positions fully fixed by the mask (if any) are used
+	static void selectAnchors(const uint8_t* sequence, const uint8_t* mask, size_t size, size_t& rareIndex, size_t& pairIndex);
+
+	// Horspool shift for each value of the last byte of a window. Wildcards
+	// match every value so the shifts never pass a wildcard position
+	static void buildSkipTable(const uint8_t* sequence, const uint8_t* mask, size_t size, size_t* skip);
+
+	// Pick the chunk kernel for the given tier. Always returns a kernel
+	static ChunkKernel selectChunkKernel(ScannerSimd::Level level, size_t sequenceSize, bool masked);
+
+	// Parse a pattern such as "8B 0D ?? ?? ?? ?? 85 C9". Bytes are two hex
+	// digits separated by whitespace. "??" (or "?") is a full wildcard and a
+	// single "?" digit (i.e. "8?") masks that nibble
+	// Returns false if the text is malformed or has no fully fixed byte
+	static bool parsePattern(const char* text, MaskedPattern& outPattern);
+
+	void setSearchPattern(const MaskedPattern& pattern);
+	const std::vector<uint8_t, ScannerAllocator<uint8_t>>& getSearchMask() const { return searchMask; }
+
 protected:
 	// Setup hook - store/update search sequence
 	virtual bool setupScanCommon(ScanType scanType, const void* targetValue, size_t valueSize) override;
@@ -62,17 +112,34 @@ protected:
 	                                    uintptr_t actualAddress, ScanType scanType, const void* targetValue,
 	                                    ScanResult& outResult) const override;
 
+	// Batched rescan - EXACT/NOT compare inline without per result virtual calls
+	virtual void rescanResultBatch(const std::vector<ScanResult, ScannerAllocator<ScanResult>>& oldResults, size_t batchStart, size_t batchEnd,
+	                               uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
+	                               ScanType scanType, const void* targetValue, ResultStore& newResults) override;
+
 	// Getters
 	virtual size_t getDataTypeSize() const override;
+	// Only addresses are kept. Values are read from memory when needed
+	virtual size_t getStoredValueSize() const override { return 0; }
 	size_t getSequenceSize() const { return searchSequence.size(); }
 
 	// Sequence specific helpers
+	bool matchesAt(const uint8_t* data) const;
 	bool checkMatch(const uint8_t* dataToCompare, ScanType scanType) const;
 	bool validateSequenceDirect(uintptr_t address, uintptr_t regionEnd, ScanType scanType) const;
 
+	template<bool INVERT>
+	void rescanSequenceBatch(const ScanResult* oldResults, size_t count, uintptr_t chunkStart, size_t chunkSize,
+	                         const uint8_t* buffer, ResultStore& newResults);
+
 	// Sequence storage
 	DataType dataType;
 	std::vector<uint8_t, ScannerAllocator<uint8_t>> searchSequence;
+	std::vector<uint8_t, ScannerAllocator<uint8_t>> searchMask;  // Empty unless PATTERN
+
+	// Kernel selected for the current scan
+	ChunkKernel chunkKernel;
+	AnchorParams anchorParams;
 };
 
 #endif
@@ -0,0 +1,31 @@
+#include "stdafx.h"
+#include "scanner_sequence_kernels.h"
+#include <immintrin.h>  // AVX2 intrinsics
+
+// AVX2 tier - 32 candidate starts per window
+// Only called when ScannerSimd reports AVX2 support
+namespace {
+	struct PairEq {
+		static const size_t WIDTH = 32;
+		size_t rareIndex;
+		size_t pairIndex;
+		__m256i rareByte;
+		__m256i pairByte;
+
+		explicit PairEq(const SequenceScanner::AnchorParams& params) :
+			rareIndex(params.rareIndex),
+			pairIndex(params.pairIndex),
+			rareByte(_mm256_set1_epi8((char)params.sequence[params.rareIndex])),
+			pairByte(_mm256_set1_epi8((char)params.sequence[params.pairIndex])) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m256i rareEq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + rareIndex)), rareByte);
+			__m256i pairEq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + pairIndex)), pairByte);
+			return (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(rareEq, pairEq));
+		}
+	};
+}
+
+SequenceScanner::ChunkKernel SequenceKernels::getChunkKernelAVX2(bool masked) {
+	return masked ? scanChunkAnchored<PairEq, true> : scanChunkAnchored<PairEq, false>;
+}
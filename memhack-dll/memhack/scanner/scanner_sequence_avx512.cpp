@@ -0,0 +1,30 @@
+#include "stdafx.h"
+#include "scanner_sequence_kernels.h"
+#include <immintrin.h>  // AVX-512 intrinsics
+
+// AVX-512BW tier - 64 candidate starts per window
+// The second compare is masked by the first so only one k-mask is produced
+namespace {
+	struct PairEq {
+		static const size_t WIDTH = 64;
+		size_t rareIndex;
+		size_t pairIndex;
+		__m512i rareByte;
+		__m512i pairByte;
+
+		explicit PairEq(const SequenceScanner::AnchorParams& params) :
+			rareIndex(params.rareIndex),
+			pairIndex(params.pairIndex),
+			rareByte(_mm512_set1_epi8((char)params.sequence[params.rareIndex])),
+			pairByte(_mm512_set1_epi8((char)params.sequence[params.pairIndex])) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__mmask64 rareEq = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512((const void*)(p + rareIndex)), rareByte);
+			return _mm512_mask_cmpeq_epi8_mask(rareEq, _mm512_loadu_si512((const void*)(p + pairIndex)), pairByte);
+		}
+	};
+}
+
+SequenceScanner::ChunkKernel SequenceKernels::getChunkKernelAVX512(bool masked) {
+	return masked ? scanChunkAnchored<PairEq, true> : scanChunkAnchored<PairEq, false>;
+}
@@ -0,0 +1,147 @@
+#ifndef SCANNER_SEQUENCE_KERNELS_H
+#define SCANNER_SEQUENCE_KERNELS_H
+
+#include "scanner_sequence.h"
+#include <cstring>
+#include <intrin.h>
+
+// Anchored search kernels for SequenceScanner
+// Candidates must match the rarest byte and a second rare byte of the sequence
+// before the full compare. Each SIMD tier lives in its own translation unit and
+// only provides a pair compare functor. The shared loop below turns its masks
+// into results so every tier reports identically
+//
+// MASKED kernels compare (data & mask) against the pre-masked pattern bytes.
+// Anchors are always fully fixed bytes so the prefilter is the same
+//
+// Pair compares load WIDTH candidate starts at once and return a mask with a
+// bit set for each start whose two anchor bytes both matched
+namespace SequenceKernels {
+	// Tier lookups. Return nullptr if the tier is not available
+	SequenceScanner::ChunkKernel getChunkKernelSSE2(bool masked);
+	SequenceScanner::ChunkKernel getChunkKernelAVX2(bool masked);
+	SequenceScanner::ChunkKernel getChunkKernelAVX512(bool masked);
+
+	// Index of the lowest set bit. Done in halves since _BitScanForward64 is x64 only
+	inline unsigned long lowestSetBit(uint64_t mask) {
+		unsigned long index;
+		if ((uint32_t)mask != 0) {
+			_BitScanForward(&index, (uint32_t)mask);
+		} else {
+			_BitScanForward(&index, (uint32_t)(mask >> 32));
+			index += 32;
+		}
+		return index;
+	}
+
+	inline bool maskedEquals(const uint8_t* data, const uint8_t* bytes, const uint8_t* mask, size_t size) {
+		for (size_t i = 0; i < size; i++) {
+			if ((data[i] & mask[i]) != bytes[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Full compare of a candidate start
+	template<bool MASKED>
+	inline bool sequenceEquals(const SequenceScanner::AnchorParams& params, const uint8_t* candidate) {
+		return MASKED ? maskedEquals(candidate, params.sequence, params.mask, params.size)
+		              : memcmp(candidate, params.sequence, params.size) == 0;
+	}
+
+	// Second anchor then the full sequence. The rare byte is already known to match
+	template<bool MASKED>
+	inline bool verifyCandidate(const SequenceScanner::AnchorParams& params, const uint8_t* candidate) {
+		return candidate[params.pairIndex] == params.sequence[params.pairIndex] &&
+		       sequenceEquals<MASKED>(params, candidate);
+	}
+
+	inline void addResult(uintptr_t address, std::vector<ScanResult>& localResults) {
+		ScanResult result;
+		result.address = address;
+		localResults.push_back(result);
+	}
+
+	// Scalar tier - memchr for the rare byte then verify
+	// Also used by the vector tiers for single byte sequences
+	template<bool MASKED>
+	void scanChunkMemchr(const SequenceScanner::AnchorParams& params, const uint8_t* buffer, size_t chunkSize,
+	                     uintptr_t chunkBase, std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+		if (chunkSize < params.size) {
+			return;
+		}
+
+		// Rare byte positions of the first and one past the last start that fits
+		const uint8_t rareByte = params.sequence[params.rareIndex];
+		const uint8_t* searchStart = buffer + params.rareIndex;
+		const uint8_t* searchEnd = buffer + (chunkSize - params.size) + params.rareIndex + 1;
+
+		while (searchStart < searchEnd && localResults.size() < maxLocalResults) {
+			const uint8_t* found = (const uint8_t*)memchr(searchStart, rareByte, searchEnd - searchStart);
+			if (found == nullptr) {
+				break;
+			}
+
+			const uint8_t* candidate = found - params.rareIndex;
+			if (verifyCandidate<MASKED>(params, candidate)) {
+				addResult(chunkBase + (candidate - buffer), localResults);
+			}
+			searchStart = found + 1;
+		}
+	}
+
+	// Scalar tier for masked patterns - Horspool using params.skip
+	// Wildcards near the end of a pattern limit the shift so memchr on a
+	// rare byte may still win there, but a fixed tail gives long skips
+	inline void scanChunkHorspool(const SequenceScanner::AnchorParams& params, const uint8_t* buffer, size_t chunkSize,
+	                              uintptr_t chunkBase, std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+		const size_t last = params.size - 1;
+		size_t start = 0;
+		while (start + params.size <= chunkSize && localResults.size() < maxLocalResults) {
+			const uint8_t* candidate = buffer + start;
+			if (sequenceEquals<true>(params, candidate)) {
+				addResult(chunkBase + start, localResults);
+			}
+			start += params.skip[candidate[last]];
+		}
+	}
+
+	// Shared loop for the vector tiers
+	// Windows of WIDTH starts are tested until either anchor load would pass
+	// the chunk end. The rest is finished with memchr
+	template<typename Cmp, bool MASKED>
+	void scanChunkAnchored(const SequenceScanner::AnchorParams& params, const uint8_t* buffer, size_t chunkSize,
+	                       uintptr_t chunkBase, std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+		if (chunkSize < params.size) {
+			return;
+		}
+
+		const Cmp cmp(params);
+		const size_t lastStart = chunkSize - params.size;
+		const size_t farIndex = params.rareIndex > params.pairIndex ? params.rareIndex : params.pairIndex;
+
+		size_t start = 0;
+		while (start + farIndex + Cmp::WIDTH <= chunkSize) {
+			uint64_t mask = cmp(buffer + start);
+			while (mask != 0) {
+				size_t candidate = start + lowestSetBit(mask);
+				mask &= mask - 1;
+
+				if (candidate <= lastStart && sequenceEquals<MASKED>(params, buffer + candidate)) {
+					addResult(chunkBase + candidate, localResults);
+					if (localResults.size() >= maxLocalResults) {
+						return;
+					}
+				}
+			}
+			start += Cmp::WIDTH;
+		}
+
+		if (start <= lastStart) {
+			scanChunkMemchr<MASKED>(params, buffer + start, chunkSize - start, chunkBase + start, localResults, maxLocalResults);
+		}
+	}
+}
+
+#endif
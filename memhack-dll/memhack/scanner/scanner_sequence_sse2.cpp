@@ -0,0 +1,30 @@
+#include "stdafx.h"
+#include "scanner_sequence_kernels.h"
+#include <emmintrin.h>  // SSE2 intrinsics
+
+// SSE2 tier - 16 candidate starts per window
+namespace {
+	struct PairEq {
+		static const size_t WIDTH = 16;
+		size_t rareIndex;
+		size_t pairIndex;
+		__m128i rareByte;
+		__m128i pairByte;
+
+		explicit PairEq(const SequenceScanner::AnchorParams& params) :
+			rareIndex(params.rareIndex),
+			pairIndex(params.pairIndex),
+			rareByte(_mm_set1_epi8((char)params.sequence[params.rareIndex])),
+			pairByte(_mm_set1_epi8((char)params.sequence[params.pairIndex])) {}
+
+		uint64_t operator()(const uint8_t* p) const {
+			__m128i rareEq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + rareIndex)), rareByte);
+			__m128i pairEq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + pairIndex)), pairByte);
+			return (uint32_t)_mm_movemask_epi8(_mm_and_si128(rareEq, pairEq));
+		}
+	};
+}
+
+SequenceScanner::ChunkKernel SequenceKernels::getChunkKernelSSE2(bool masked) {
+	return masked ? scanChunkAnchored<PairEq, true> : scanChunkAnchored<PairEq, false>;
+}
@@ -0,0 +1,141 @@
+#include "stdafx.h"
+#include "scanner_simd.h"
+#include <immintrin.h>  // _xgetbv
+#include <intrin.h>     // __cpuid
+
+namespace ScannerSimd {
+	// Global state vars
+	static Level g_supportedLevel = Level::SCALAR;
+	static Level g_activeLevel = Level::SCALAR;
+
+	// CPUID feature bits we care about
+	const int CPUID1_EDX_SSE2 = 1 << 26;
+	const int CPUID1_ECX_OSXSAVE = 1 << 27;
+	const int CPUID1_ECX_AVX = 1 << 28;
+	const int CPUID7_EBX_AVX2 = 1 << 5;
+	const int CPUID7_EBX_AVX512F = 1 << 16;
+	const int CPUID7_EBX_AVX512BW = 1 << 30;
+
+	// XCR0 state components the OS must enable
+	// SSE + AVX (YMM upper halves)
+	const unsigned long long XCR0_AVX_STATE = 0x6;
+	// SSE + AVX + opmask + ZMM upper halves + ZMM16-31
+	const unsigned long long XCR0_AVX512_STATE = 0xE6;
+
+	// Cached CPUID results so the individual checks are cheap
+	static bool g_probed = false;
+	static int g_cpuid1[4] = { 0 };
+	static int g_cpuid7[4] = { 0 };
+	static unsigned long long g_xcr0 = 0;
+
+	static void probe() {
+		if (g_probed) {
+			return;
+		}
+		g_probed = true;
+
+		int cpuInfo[4];
+
+		// CPUID function 0: Get maximum supported function number
+		__cpuid(cpuInfo, 0);
+		int maxFunctionId = cpuInfo[0];
+
+		if (maxFunctionId >= 1) {
+			__cpuid(g_cpuid1, 1);
+		}
+		if (maxFunctionId >= 7) {
+			// Function 7, sub-leaf 0: Get extended features
+			__cpuidex(g_cpuid7, 7, 0);
+		}
+
+		// Only safe to read XCR0 if the OS has enabled XSAVE
+		if (g_cpuid1[2] & CPUID1_ECX_OSXSAVE) {
+			g_xcr0 = _xgetbv(0);
+		}
+	}
+
+	bool isSSE2Supported() {
+		probe();
+		return (g_cpuid1[3] & CPUID1_EDX_SSE2) != 0;
+	}
+
+	bool isAVX2Supported() {
+		probe();
+		if (!(g_cpuid1[2] & CPUID1_ECX_AVX) || !(g_cpuid7[1] & CPUID7_EBX_AVX2)) {
+			return false;
+		}
+		return (g_xcr0 & XCR0_AVX_STATE) == XCR0_AVX_STATE;
+	}
+
+	bool isAVX512BWSupported() {
+		probe();
+		if (!isAVX2Supported()) {
+			return false;
+		}
+		if (!(g_cpuid7[1] & CPUID7_EBX_AVX512F) || !(g_cpuid7[1] & CPUID7_EBX_AVX512BW)) {
+			return false;
+		}
+		return (g_xcr0 & XCR0_AVX512_STATE) == XCR0_AVX512_STATE;
+	}
+
+	void initialize() {
+		if (isAVX512BWSupported()) {
+			g_supportedLevel = Level::AVX512BW;
+		} else if (isAVX2Supported()) {
+			g_supportedLevel = Level::AVX2;
+		} else if (isSSE2Supported()) {
+			g_supportedLevel = Level::SSE2;
+		} else {
+			g_supportedLevel = Level::SCALAR;
+		}
+		g_activeLevel = g_supportedLevel;
+	}
+
+	Level getLevel() {
+		return g_activeLevel;
+	}
+
+	Level getSupportedLevel() {
+		return g_supportedLevel;
+	}
+
+	bool setLevel(Level level) {
+		if (level > g_supportedLevel) {
+			return false;
+		}
+		g_activeLevel = level;
+		return true;
+	}
+
+	const char* getLevelName(Level level) {
+		switch (level) {
+			case Level::SCALAR: return "scalar";
+			case Level::SSE2: return "sse2";
+			case Level::AVX2: return "avx2";
+			case Level::AVX512BW: return "avx512bw";
+			default: return "unknown";
+		}
+	}
+
+	bool parseLevel(const char* str, Level& outLevel) {
+		if (!str) {
+			return false;
+		}
+
+		if (_stricmp(str, "scalar") == 0) {
+			outLevel = Level::SCALAR;
+			return true;
+		} else if (_stricmp(str, "sse2") == 0) {
+			outLevel = Level::SSE2;
+			return true;
+		} else if (_stricmp(str, "avx2") == 0) {
+			outLevel = Level::AVX2;
+			return true;
+		} else if (_stricmp(str, "avx512bw") == 0 || _stricmp(str, "avx512") == 0) {
+			outLevel = Level::AVX512BW;
+			return true;
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,39 @@
+#ifndef SCANNER_SIMD_H
+#define SCANNER_SIMD_H
+
+// Runtime SIMD dispatch for the scanners
+// The best instruction set tier the CPU and OS support is detected once at DLL
+// load. Scanners then pick their kernels from the active tier when a scan starts
+namespace ScannerSimd {
+	// Ordered lowest to highest so tiers can be compared
+	enum class Level {
+		SCALAR,
+		SSE2,
+		AVX2,
+		AVX512BW
+	};
+
+	// Probe the CPU and select the best supported level
+	void initialize();
+
+	// Level used when selecting kernels for new scans
+	Level getLevel();
+
+	// Highest level the CPU and OS support
+	Level getSupportedLevel();
+
+	// Override the active level (i.e. to compare against scalar results)
+	// Returns false if the level is not supported on this CPU
+	bool setLevel(Level level);
+
+	const char* getLevelName(Level level);
+	bool parseLevel(const char* str, Level& outLevel);
+
+	// Individual feature checks. These check both CPUID and that the
+	// OS saves the wider register state on context switches
+	bool isSSE2Supported();
+	bool isAVX2Supported();
+	bool isAVX512BWSupported();
+}
+
+#endif
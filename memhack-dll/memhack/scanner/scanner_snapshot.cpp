@@ -0,0 +1,129 @@
+#include "stdafx.h"
+#include "scanner_snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+	inline uint64_t loadQword(const uint8_t* p, size_t available) {
+		uint64_t value = 0;
+		memcpy(&value, p, std::min<size_t>(available, sizeof(uint64_t)));
+		return value;
+	}
+
+	inline uint64_t mix(uint64_t hash, uint64_t value) {
+		hash = (hash ^ value) * 0x9E3779B97F4A7C15ULL;
+		return hash ^ (hash >> 32);
+	}
+}
+
+void MemorySnapshot::reset(size_t chunkCount) {
+	std::vector<Chunk, ScannerAllocator<Chunk>>().swap(chunks);
+	chunks.resize(chunkCount);
+	memoryUsage = chunks.capacity() * sizeof(Chunk);
+}
+
+// Four independent lanes so the multiplies overlap and hashing keeps up
+// with the copy
+uint64_t MemorySnapshot::hashPage(const uint8_t* page, size_t size) {
+	uint64_t h0 = size, h1 = 0x243F6A8885A308D3ULL, h2 = 0x13198A2E03707344ULL, h3 = 0xA4093822299F31D0ULL;
+
+	size_t offset = 0;
+	for (; offset + 32 <= size; offset += 32) {
+		h0 = mix(h0, loadQword(page + offset, 8));
+		h1 = mix(h1, loadQword(page + offset + 8, 8));
+		h2 = mix(h2, loadQword(page + offset + 16, 8));
+		h3 = mix(h3, loadQword(page + offset + 24, 8));
+	}
+	for (; offset < size; offset += 8) {
+		h0 = mix(h0, loadQword(page + offset, size - offset));
+	}
+
+	return mix(mix(mix(h0, h1), h2), h3);
+}
+
+void MemorySnapshot::compressPage(const uint8_t* page, size_t size, Page& outPage, std::vector<uint64_t>& data) {
+	memset(outPage.literals, 0, sizeof(outPage.literals));
+	outPage.dataOffset = (uint32_t)data.size();
+
+	uint64_t previous = 0;
+	const size_t qwords = (size + 7) / 8;
+	for (size_t q = 0; q < qwords; q++) {
+		uint64_t value = loadQword(page + q * 8, size - q * 8);
+		if (value != previous) {
+			outPage.literals[q >> 6] |= 1ULL << (q & 63);
+			data.push_back(value);
+			previous = value;
+		}
+	}
+}
+
+void MemorySnapshot::decompressPage(const Page& page, const uint64_t* data, size_t size, uint8_t* out) {
+	const uint64_t* source = data + page.dataOffset;
+	uint64_t previous = 0;
+	const size_t qwords = (size + 7) / 8;
+	for (size_t q = 0; q < qwords; q++) {
+		if (page.literals[q >> 6] & (1ULL << (q & 63))) {
+			previous = *source++;
+		}
+		memcpy(out + q * 8, &previous, std::min<size_t>(size - q * 8, sizeof(uint64_t)));
+	}
+}
+
+void MemorySnapshot::store(size_t chunk, const uint8_t* buffer, size_t size, std::vector<uint64_t>& scratch) {
+	Chunk& target = chunks[chunk];
+	const size_t pageCount = (size + SNAPSHOT_PAGE_SIZE - 1) / SNAPSHOT_PAGE_SIZE;
+
+	// Hash first so an unchanged chunk is left as is
+	uint64_t hashes[SNAPSHOT_MAX_CHUNK_PAGES];
+	bool changed = target.pages.size() != pageCount;
+	for (size_t i = 0; i < pageCount; i++) {
+		size_t offset = i * SNAPSHOT_PAGE_SIZE;
+		hashes[i] = hashPage(buffer + offset, std::min<size_t>(SNAPSHOT_PAGE_SIZE, size - offset));
+		changed = changed || target.pages[i].hash != hashes[i];
+	}
+	if (!changed) {
+		return;
+	}
+
+	size_t oldUsage = target.getMemoryUsage();
+	std::vector<Page, ScannerAllocator<Page>> pages(pageCount);
+	scratch.clear();
+	for (size_t i = 0; i < pageCount; i++) {
+		size_t offset = i * SNAPSHOT_PAGE_SIZE;
+		pages[i].hash = hashes[i];
+		compressPage(buffer + offset, std::min<size_t>(SNAPSHOT_PAGE_SIZE, size - offset), pages[i], scratch);
+	}
+
+	// Exact sized copies so the snapshot holds no slack
+	target.pages.swap(pages);
+	std::vector<uint64_t, ScannerAllocator<uint64_t>>(scratch.begin(), scratch.end()).swap(target.data);
+
+	memoryUsage += target.getMemoryUsage();
+	memoryUsage -= oldUsage;
+}
+
+void MemorySnapshot::release(size_t chunk) {
+	Chunk& target = chunks[chunk];
+	memoryUsage -= target.getMemoryUsage();
+	std::vector<Page, ScannerAllocator<Page>>().swap(target.pages);
+	std::vector<uint64_t, ScannerAllocator<uint64_t>>().swap(target.data);
+}
+
+size_t MemorySnapshot::restore(size_t chunk, const uint8_t* buffer, size_t size, uint8_t* oldBuffer) const {
+	const Chunk& source = chunks[chunk];
+	const size_t pageCount = std::min<size_t>(source.pages.size(), (size + SNAPSHOT_PAGE_SIZE - 1) / SNAPSHOT_PAGE_SIZE);
+
+	size_t changedPages = 0;
+	for (size_t i = 0; i < pageCount; i++) {
+		size_t offset = i * SNAPSHOT_PAGE_SIZE;
+		size_t pageSize = std::min<size_t>(SNAPSHOT_PAGE_SIZE, size - offset);
+		if (hashPage(buffer + offset, pageSize) == source.pages[i].hash) {
+			memcpy(oldBuffer + offset, buffer + offset, pageSize);
+		} else {
+			decompressPage(source.pages[i], source.data.data(), pageSize, oldBuffer + offset);
+			changedPages++;
+		}
+	}
+	return changedPages;
+}
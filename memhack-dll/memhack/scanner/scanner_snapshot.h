@@ -0,0 +1,75 @@
+#ifndef SCANNER_SNAPSHOT_H
+#define SCANNER_SNAPSHOT_H
+
+#include <vector>
+#include <cstdint>
+#include <atomic>
+#include "scanner_heap.h"
+
+// Pages are hashed and compressed separately so unchanged pages can be
+// skipped without decompressing them
+const size_t SNAPSHOT_PAGE_SIZE = 4096;
+const size_t SNAPSHOT_PAGE_QWORDS = SNAPSHOT_PAGE_SIZE / sizeof(uint64_t);
+
+// Chunks are at most one scan buffer plus a value, so 17 pages
+const size_t SNAPSHOT_MAX_CHUNK_PAGES = 32;
+
+// Cap on compressed snapshot memory
+const size_t SNAPSHOT_MAX_BYTES = 512 * 1024 * 1024;
+
+// Compressed copy of scanned memory used by UNKNOWN first scans so later
+// relative rescans have the previous values without a result per slot
+// The snapshot is split into the same chunks as the result bitmap and
+// each chunk is only touched by the thread scanning it
+//
+// Pages keep a 64 bit content hash and the qwords that differ from the
+// one before them. Zero filled and repeated fill memory, which makes up
+// most of a typical process, takes a few bits per qword
+class MemorySnapshot {
+public:
+	MemorySnapshot() : memoryUsage(0) {}
+
+	// Drop everything and make room for chunkCount empty chunks
+	void reset(size_t chunkCount);
+	void clear() { reset(0); }
+
+	bool empty() const { return chunks.empty(); }
+	size_t getMemoryUsage() const { return memoryUsage.load(std::memory_order_relaxed); }
+
+	// Compress size bytes of buffer as the chunk's snapshot. size must be at
+	// most SNAPSHOT_MAX_CHUNK_PAGES pages. Nothing is done
+	// if every page hash still matches. scratch is the caller's staging
+	void store(size_t chunk, const uint8_t* buffer, size_t size, std::vector<uint64_t>& scratch);
+
+	// Free a chunk that has no candidates left
+	void release(size_t chunk);
+
+	// Rebuild the chunk's snapshot into oldBuffer. Pages whose hash matches
+	// buffer are copied from it rather than decompressed. Returns the number
+	// of pages that changed
+	size_t restore(size_t chunk, const uint8_t* buffer, size_t size, uint8_t* oldBuffer) const;
+
+	static uint64_t hashPage(const uint8_t* page, size_t size);
+
+private:
+	struct Page {
+		uint64_t hash;
+		uint64_t literals[SNAPSHOT_PAGE_QWORDS / 64];   // Set bits are stored qwords, clear bits repeat the previous one
+		uint32_t dataOffset;
+	};
+
+	struct Chunk {
+		std::vector<Page, ScannerAllocator<Page>> pages;
+		std::vector<uint64_t, ScannerAllocator<uint64_t>> data;
+
+		size_t getMemoryUsage() const { return pages.capacity() * sizeof(Page) + data.capacity() * sizeof(uint64_t); }
+	};
+
+	static void compressPage(const uint8_t* page, size_t size, Page& outPage, std::vector<uint64_t>& data);
+	static void decompressPage(const Page& page, const uint64_t* data, size_t size, uint8_t* out);
+
+	std::vector<Chunk, ScannerAllocator<Chunk>> chunks;
+	std::atomic<size_t> memoryUsage;
+};
+
+#endif
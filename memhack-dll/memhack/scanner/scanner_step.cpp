@@ -0,0 +1,145 @@
+#include "stdafx.h"
+#include "scanner_base.h"
+#include "scanner_async.h"
+
+#include <algorithm>
+#include <windows.h>
+
+
+bool Scanner::beginStepScan(ScanType scanType, const void* targetValue, size_t valueSize, AsyncScanJob* targetOwner) {
+	scanCancelled = false;
+	endStepScan();
+
+	ULONGLONG startTime = checkTiming ? GetTickCount64() : 0;
+	if (!prepareFirstScan(scanType, targetValue, valueSize)) {
+		delete targetOwner;
+		return false;
+	}
+
+	// UNKNOWN keeps a snapshot of every chunk, which needs the bitmap path
+	if (!supportsStepScan() || scanType == ScanType::UNKNOWN) {
+		addError("Stepped scans don't support UNKNOWN scans, bitmap results or multi sequence, pointer and vtable scanners");
+		delete targetOwner;
+		return false;
+	}
+
+	if (!validateFirstScanType(scanType)) {
+		delete targetOwner;
+		return false;
+	}
+
+	std::vector<MemoryRegion> regions = enumerateSafeRegions();
+	if (regions.empty()) {
+		addError("No scannable memory regions found");
+		delete targetOwner;
+		return false;
+	}
+
+	uint64_t totalBytes = 0;
+	for (const MemoryRegion& region : regions) {
+		totalBytes += region.size;
+	}
+	resetProgress(totalBytes, true);
+
+	stepRegions.assign(regions.begin(), regions.end());
+	stepRegion = 0;
+	stepOffset = 0;
+	stepScanType = scanType;
+	stepTarget = targetValue;
+	stepTargetOwner = targetOwner;
+	stepStartTime = startTime;
+	stepActive = true;
+	return true;
+}
+
+// Regions are walked in address order one chunk at a time like scanRegion
+// does, so results come out sorted and the budget is checked per chunk
+bool Scanner::stepScan(uint64_t budgetMicroseconds) {
+	if (!stepActive) {
+		return true;
+	}
+
+	LARGE_INTEGER frequency, start, now;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&start);
+	const uint64_t budgetTicks = budgetMicroseconds * (uint64_t)frequency.QuadPart / 1000000;
+
+	const size_t dataSize = getDataTypeSize();
+
+	// The buffer lives on the scanner heap so chunks copied in one step
+	// aren't found again by a later one. In place scans only copy chunks
+	// that fault
+	std::vector<uint8_t, ScannerAllocator<uint8_t>> buffer(SCAN_BUFFER_SIZE);
+	std::vector<ScanResult> localResults;
+
+	do {
+		if (stepRegion >= stepRegions.size() || maxResultsReached || alignment == 0) {
+			break;
+		}
+
+		const MemoryRegion& region = stepRegions[stepRegion];
+		uintptr_t chunkBase = region.base + stepOffset;
+		size_t chunkSize = std::min<size_t>(SCAN_BUFFER_SIZE, region.size - stepOffset);
+
+		// Memory can be freed between steps. Unreadable memory is skipped
+		size_t remaining = maxResults - results.size();
+		localResults.clear();
+		size_t leadingOverlap = (stepOffset == 0 || dataSize < 2) ? 0 : dataSize - 1;
+		scanChunk(chunkBase, chunkSize, leadingOverlap, stepScanType, stepTarget, buffer.data(), localResults, remaining);
+
+		size_t kept = std::min<size_t>(localResults.size(), remaining);
+		results.append(localResults.data(), kept);
+		if (results.size() >= maxResults) {
+			maxResultsReached = true;
+		}
+
+		// Move to next chunk with overlap
+		size_t advance = chunkSize;
+		if (dataSize > 1 && stepOffset + chunkSize < region.size) {
+			advance -= std::min<size_t>(dataSize - 1, chunkSize);
+		}
+		stepOffset += advance;
+		addProgress(advance, kept);
+		if (stepOffset >= region.size) {
+			stepRegion++;
+			stepOffset = 0;
+		}
+
+		QueryPerformanceCounter(&now);
+	} while ((uint64_t)(now.QuadPart - start.QuadPart) < budgetTicks);
+
+	if (stepRegion < stepRegions.size() && !maxResultsReached) {
+		return false;
+	}
+
+	ULONGLONG startTime = stepStartTime;
+	endStepScan();
+	firstScanDone = true;
+	resultsSorted = true;
+	progressResults = getResultCount();
+
+	if (maxResultsReached) {
+		addError("Maximum results (%zu) reached, stopping scan early", maxResults);
+	}
+	reportInvalidAddressStats();
+
+	// Wall time from the first step, including the frames in between
+	if (checkTiming) {
+		ULONGLONG elapsed = GetTickCount64() - startTime;
+		addError("firstScan timing: %llu ms (%zu results found)", elapsed, getResultCount());
+	}
+	return true;
+}
+
+void Scanner::endStepScan() {
+	if (!stepActive && stepTargetOwner == nullptr) {
+		return;
+	}
+
+	stepActive = false;
+	stepRegions.clear();
+	stepRegions.shrink_to_fit();
+	stepTarget = nullptr;
+	delete stepTargetOwner;
+	stepTargetOwner = nullptr;
+}
@@ -96,17 +96,81 @@ size_t StructScanner::getDataTypeSize() const {
 	return searchStruct.getSize();
 }
 
+namespace {
+	template<typename T>
+	void addTypedField(std::vector<T, ScannerAllocator<T>>& fields, int offsetFromKey, const void* val, size_t size) {
+		T field;
+		field.offsetFromKey = offsetFromKey;
+		memcpy(&field.val, val, size);
+		fields.push_back(field);
+	}
+
+	// Same semantics as BasicScanner::compare with the default epsilons
+	inline bool fieldEquals(uint8_t a, uint8_t b) { return a == b; }
+	inline bool fieldEquals(int32_t a, int32_t b) { return a == b; }
+	inline bool fieldEquals(float a, float b) { return std::abs(a - b) < FLOAT_EPSILON; }
+	inline bool fieldEquals(double a, double b) { return std::abs(a - b) < DOUBLE_EPSILON; }
+}
+
 void StructScanner::setSearchStruct(const StructSearch& targetStruct) {
     // Default copy will use the ScannerAllocator to copy the vectors
     searchStruct = targetStruct;
-}
 
-bool StructScanner::compare(const uint8_t* keyAddr) const {
+    // Split basic fields by type for the compare loops
+    byteFields.clear();
+    boolFields.clear();
+    intFields.clear();
+    floatFields.clear();
+    doubleFields.clear();
     for (const StructFieldBasic& field : searchStruct.basicFields) {
-        if (!field.compare(keyAddr)) {
+        size_t size = BasicScanner::getDataTypeSize(field.type);
+        switch (field.type) {
+            case BasicScanner::DataType::BYTE:
+                addTypedField(byteFields, field.offsetFromKey, &field.val, size);
+                break;
+            case BasicScanner::DataType::BOOL:
+                addTypedField(boolFields, field.offsetFromKey, &field.val, size);
+                break;
+            case BasicScanner::DataType::INT:
+                addTypedField(intFields, field.offsetFromKey, &field.val, size);
+                break;
+            case BasicScanner::DataType::FLOAT:
+                addTypedField(floatFields, field.offsetFromKey, &field.val, size);
+                break;
+            case BasicScanner::DataType::DOUBLE:
+                addTypedField(doubleFields, field.offsetFromKey, &field.val, size);
+                break;
+        }
+    }
+}
+
+template<typename T>
+bool StructScanner::fieldsMatch(const TypedFieldList<T>& fields, const uint8_t* keyAddr) {
+    for (const TypedField<T>& field : fields) {
+        T value;
+        memcpy(&value, keyAddr + field.offsetFromKey, sizeof(T));
+        if (!fieldEquals(value, field.val)) {
             return false;
         }
     }
+    return true;
+}
+
+bool StructScanner::boolFieldsMatch(const TypedFieldList<uint8_t>& fields, const uint8_t* keyAddr) {
+    for (const TypedField<uint8_t>& field : fields) {
+        if ((keyAddr[field.offsetFromKey] != 0) != (field.val != 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StructScanner::compare(const uint8_t* keyAddr) const {
+    if (!fieldsMatch(intFields, keyAddr) || !fieldsMatch(byteFields, keyAddr) ||
+        !boolFieldsMatch(boolFields, keyAddr) ||
+        !fieldsMatch(floatFields, keyAddr) || !fieldsMatch(doubleFields, keyAddr)) {
+        return false;
+    }
     for (const StructFieldSequence& field : searchStruct.sequenceFields) {
         if (!field.compare(keyAddr)) {
             return false;
@@ -115,6 +179,12 @@ bool StructScanner::compare(const uint8_t* keyAddr) const {
     return true;
 }
 
+// Checks the whole struct around a key position fits in the buffer
+bool StructScanner::isKeyInBuffer(size_t keyOffset, size_t bufferSize) const {
+	// sizeBeforeKey includes the distance from base to key or any earlier fields
+	return keyOffset >= searchStruct.sizeBeforeKey && keyOffset + searchStruct.sizeFromKey <= bufferSize;
+}
+
 bool StructScanner::checkMatch(const uint8_t* dataToCompare, ScanType scanType) const {
 	switch (scanType) {
 		case ScanType::EXACT:
@@ -142,13 +212,8 @@ bool StructScanner::validateValueInBuffer(const uint8_t* buffer, size_t bufferSi
 	// Calculate struct base address by subtracting key's offset from base
 	outResult.address = actualAddress - searchStruct.keyOffsetFromBase;
 
-	// offset is where the key byte is in the buffer so we just need to make sure its larger than the size before
-	// sizeBeforeKey includes the distance from base to key or any earlier fields
-	if (offset < searchStruct.sizeBeforeKey) {
-		return false;
-	}
-	// Check if we have enough bytes from the key position onwards
-	if (offset + searchStruct.sizeFromKey > bufferSize) {
+	// offset is where the key byte is in the buffer
+	if (!isKeyInBuffer(offset, bufferSize)) {
 		return false;
 	}
 
@@ -213,6 +278,9 @@ bool StructScanner::validateFirstScanType(ScanType scanType) {
 void StructScanner::scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
                                          ScanType scanType, const void* targetValue,
                                          std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+	// First scans are always EXACT (see validateFirstScanType) so candidates
+	// are compared inline rather than through validateValueInBuffer
+
 	// Optimized path using memchr to find key byte
 	const uint8_t* searchStart = buffer;
 	const uint8_t* bufferEnd = buffer + chunkSize;
@@ -227,12 +295,11 @@ void StructScanner::scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, u
 		// offset is the position of the key byte in the buffer
 		size_t offset = found - buffer;
 
-		// Calculate actual memory address where key was found
-		uintptr_t actualAddress = chunkBase + offset;
-
 		// Validate the full struct
-		ScanResult result;
-		if (validateValueInBuffer(buffer, chunkSize, offset, actualAddress, scanType, targetValue, result)) {
+		if (isKeyInBuffer(offset, chunkSize) && compare(found)) {
+			// Results are struct base addresses
+			ScanResult result;
+			result.address = chunkBase + offset - searchStruct.keyOffsetFromBase;
 			localResults.push_back(result);
 		}
 
@@ -240,6 +307,54 @@ void StructScanner::scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, u
 	}
 }
 
+void StructScanner::rescanResultBatch(const std::vector<ScanResult, ScannerAllocator<ScanResult>>& oldResults,
+                                       size_t batchStart, size_t batchEnd,
+                                       uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
+                                       ScanType scanType, const void* targetValue,
+                                       ResultStore& newResults) {
+	const ScanResult* batch = oldResults.data() + batchStart;
+	size_t count = batchEnd - batchStart;
+
+	switch (scanType) {
+		case ScanType::EXACT:
+			rescanStructBatch<false>(batch, count, chunkStart, chunkSize, buffer, newResults);
+			break;
+		case ScanType::NOT:
+			rescanStructBatch<true>(batch, count, chunkStart, chunkSize, buffer, newResults);
+			break;
+		default:
+			// Unsupported types go through the generic path so checkMatch reports them
+			Scanner::rescanResultBatch(oldResults, batchStart, batchEnd, chunkStart, chunkSize, buffer,
+			                           scanType, targetValue, newResults);
+			break;
+	}
+}
+
+template<bool INVERT>
+void StructScanner::rescanStructBatch(const ScanResult* oldResults, size_t count, uintptr_t chunkStart, size_t chunkSize,
+                                      const uint8_t* buffer, ResultStore& newResults) {
+	size_t invalidCount = 0;
+	for (size_t i = 0; i < count; i++) {
+		const ScanResult& oldResult = oldResults[i];
+
+		// Results are struct base addresses but fields are relative to the key
+		intptr_t keyOffset = (intptr_t)(oldResult.address - chunkStart) + searchStruct.keyOffsetFromBase;
+		if (keyOffset < 0 || !isKeyInBuffer((size_t)keyOffset, chunkSize) ||
+		    compare(buffer + keyOffset) == INVERT) {
+			invalidCount++;
+			continue;
+		}
+
+		ScanResult result;
+		result.address = oldResult.address;
+		result.oldValue = oldResult.value;
+		result.hasOldValue = true;
+		newResults.push_back(result);
+	}
+
+	invalidAddressCount += invalidCount;
+}
+
 // Process a single isolated result with direct memory read for rescan
 // Wrapper for validateStructDirect to match base class interface
 bool StructScanner::validateValueDirect(uintptr_t address, uintptr_t regionStart, uintptr_t regionEnd,
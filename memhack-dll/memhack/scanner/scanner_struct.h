@@ -141,14 +141,47 @@ protected:
 	                                    uintptr_t actualAddress, ScanType scanType, const void* targetValue,
 	                                    ScanResult& outResult) const override;
 
+	// Batched rescan - EXACT/NOT compare inline without per result virtual calls
+	virtual void rescanResultBatch(const std::vector<ScanResult, ScannerAllocator<ScanResult>>& oldResults, size_t batchStart, size_t batchEnd,
+	                               uintptr_t chunkStart, size_t chunkSize, const uint8_t* buffer,
+	                               ScanType scanType, const void* targetValue, ResultStore& newResults) override;
+
 	// Getters
 	virtual size_t getDataTypeSize() const override;
+	// Only addresses are kept
+	virtual size_t getStoredValueSize() const override { return 0; }
 
 private:
+	// Basic field flattened to its value type
+	template<typename T>
+	struct TypedField {
+		int offsetFromKey;
+		T val;
+	};
+
+	template<typename T>
+	using TypedFieldList = std::vector<TypedField<T>, ScannerAllocator<TypedField<T>>>;
+
 	// Struct storage
 	StructSearch searchStruct;
 
+	// Basic fields of the search split by type when the search is set so
+	// compares run without a per field type switch. BOOL fields keep the raw
+	// byte and match on truth like BasicScanner::compare
+	TypedFieldList<uint8_t> byteFields;
+	TypedFieldList<uint8_t> boolFields;
+	TypedFieldList<int32_t> intFields;
+	TypedFieldList<float> floatFields;
+	TypedFieldList<double> doubleFields;
+
 	// Struct specific helpers
+	template<typename T>
+	static bool fieldsMatch(const TypedFieldList<T>& fields, const uint8_t* keyAddr);
+	static bool boolFieldsMatch(const TypedFieldList<uint8_t>& fields, const uint8_t* keyAddr);
+	template<bool INVERT>
+	void rescanStructBatch(const ScanResult* oldResults, size_t count, uintptr_t chunkStart, size_t chunkSize,
+	                       const uint8_t* buffer, ResultStore& newResults);
+	bool isKeyInBuffer(size_t keyOffset, size_t bufferSize) const;
 	bool compare(const uint8_t* keyAddr) const;
 	bool checkMatch(const uint8_t* keyAddr, ScanType scanType) const;
 	bool validateStructDirect(uintptr_t baseAddress, uintptr_t regionStart, uintptr_t regionEnd, ScanType scanType) const;
@@ -0,0 +1,329 @@
+#include "stdafx.h"
+#include "scanner_vtable.h"
+
+#include <algorithm>
+#include <windows.h>
+
+// Sections read from the exe headers. Real images have a handful
+const size_t MAX_IMAGE_SECTIONS = 96;
+
+void* VtableScanner::operator new(size_t size) {
+	return ScannerHeap::allocate(size);
+}
+
+void VtableScanner::operator delete(void* ptr) noexcept {
+	if (ptr) {
+		ScannerHeap::deallocate(ptr, 0);
+	}
+}
+
+VtableScanner::VtableScanner(size_t maxResults, size_t alignment) :
+	Scanner(maxResults, alignment), imageBase(0), imageSize(0), vtableCount(0)
+{
+	// Objects are always aligned so their vtable pointer is too
+	if (this->alignment == 0) {
+		this->alignment = sizeof(uintptr_t);
+	}
+}
+
+VtableScanner::~VtableScanner() {}
+
+VtableScanner* VtableScanner::create(size_t maxResults, size_t alignment) {
+	return new VtableScanner(maxResults, alignment);
+}
+
+void VtableScanner::buildCensus() {
+	reset();
+	firstScan(ScanType::EXACT, nullptr);
+}
+
+void VtableScanner::reset() {
+	Scanner::reset();
+	instanceOrder.clear();
+	groups.clear();
+}
+
+namespace {
+	struct ImageSection {
+		uintptr_t base;
+		size_t size;
+		DWORD characteristics;
+	};
+
+	// Kept free of C++ objects so it can use SEH
+	bool readImageSections(HMODULE module, uintptr_t& outSize, ImageSection* outSections, size_t& outCount) {
+		uintptr_t base = (uintptr_t)module;
+		outSize = 0;
+		outCount = 0;
+		if (module == nullptr) {
+			return false;
+		}
+
+		__try {
+			const IMAGE_DOS_HEADER* dosHeader = (const IMAGE_DOS_HEADER*)module;
+			if (dosHeader->e_magic != IMAGE_DOS_SIGNATURE) {
+				return false;
+			}
+
+			const IMAGE_NT_HEADERS* ntHeaders = (const IMAGE_NT_HEADERS*)(base + dosHeader->e_lfanew);
+			if (ntHeaders->Signature != IMAGE_NT_SIGNATURE) {
+				return false;
+			}
+
+			outSize = ntHeaders->OptionalHeader.SizeOfImage;
+			const IMAGE_SECTION_HEADER* section = IMAGE_FIRST_SECTION(ntHeaders);
+			size_t count = std::min<size_t>(ntHeaders->FileHeader.NumberOfSections, MAX_IMAGE_SECTIONS);
+			for (size_t i = 0; i < count; i++, section++) {
+				outSections[i].base = base + section->VirtualAddress;
+				outSections[i].size = section->Misc.VirtualSize;
+				outSections[i].characteristics = section->Characteristics;
+			}
+			outCount = count;
+			return true;
+		}
+		__except (EXCEPTION_EXECUTE_HANDLER) {
+			return false;
+		}
+	}
+
+	bool isCodeSection(const ImageSection& section) {
+		return (section.characteristics & IMAGE_SCN_MEM_EXECUTE) != 0;
+	}
+
+	bool isReadOnlyDataSection(const ImageSection& section) {
+		return (section.characteristics & IMAGE_SCN_MEM_READ) != 0 &&
+		       (section.characteristics & (IMAGE_SCN_MEM_WRITE | IMAGE_SCN_MEM_EXECUTE)) == 0;
+	}
+}
+
+bool VtableScanner::buildVtableFilter() {
+	vtableSections.clear();
+	vtableBits.clear();
+	vtableCount = 0;
+
+	ImageSection sections[MAX_IMAGE_SECTIONS];
+	size_t sectionCount = 0;
+	imageBase = (uintptr_t)GetModuleHandle(nullptr);
+	if (!readImageSections(GetModuleHandle(nullptr), imageSize, sections, sectionCount)) {
+		addError("Failed to read the exe image headers");
+		return false;
+	}
+
+	// Lay out a bit per aligned slot of every read only data section
+	size_t totalBits = 0;
+	for (size_t i = 0; i < sectionCount; i++) {
+		if (!isReadOnlyDataSection(sections[i]) || sections[i].size < sizeof(uintptr_t)) {
+			continue;
+		}
+		VtableSection vtableSection;
+		vtableSection.base = sections[i].base;
+		vtableSection.size = sections[i].size;
+		vtableSection.firstBit = totalBits;
+		vtableSections.push_back(vtableSection);
+		totalBits += sections[i].size / sizeof(uintptr_t);
+	}
+	vtableBits.assign((totalBits + 31) / 32, 0);
+
+	// Mark slots whose value is a code address. The section is copied a
+	// chunk at a time so a bad page only drops that chunk
+	std::vector<uint8_t, ScannerAllocator<uint8_t>> buffer(SCAN_BUFFER_SIZE);
+	for (const VtableSection& vtableSection : vtableSections) {
+		for (size_t offset = 0; offset + sizeof(uintptr_t) <= vtableSection.size; offset += buffer.size()) {
+			size_t chunkSize = std::min<size_t>(buffer.size(), vtableSection.size - offset);
+			chunkSize -= chunkSize % sizeof(uintptr_t);
+			if (chunkSize == 0 || !safeCopyMemory(buffer.data(), (const void*)(vtableSection.base + offset), chunkSize)) {
+				continue;
+			}
+
+			for (size_t slot = 0; slot < chunkSize; slot += sizeof(uintptr_t)) {
+				uintptr_t value;
+				memcpy(&value, buffer.data() + slot, sizeof(value));
+
+				for (size_t i = 0; i < sectionCount; i++) {
+					if (isCodeSection(sections[i]) && value - sections[i].base < sections[i].size) {
+						size_t bit = vtableSection.firstBit + (offset + slot) / sizeof(uintptr_t);
+						vtableBits[bit >> 5] |= (uint32_t)1 << (bit & 31);
+						vtableCount++;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	if (vtableCount == 0) {
+		addError("No vtables found in the exe image read only data");
+		return false;
+	}
+	return true;
+}
+
+bool VtableScanner::isVtable(uintptr_t value) const {
+	if (value % sizeof(uintptr_t) != 0) {
+		return false;
+	}
+
+	for (const VtableSection& vtableSection : vtableSections) {
+		if (value - vtableSection.base < vtableSection.size) {
+			size_t bit = vtableSection.firstBit + (value - vtableSection.base) / sizeof(uintptr_t);
+			return (vtableBits[bit >> 5] & ((uint32_t)1 << (bit & 31))) != 0;
+		}
+	}
+	return false;
+}
+
+bool VtableScanner::setupScanCommon(ScanType scanType, const void* targetValue, size_t valueSize) {
+	// The image doesn't move but rebuilding is cheap and keeps reset simple
+	return buildVtableFilter();
+}
+
+bool VtableScanner::validateFirstScanType(ScanType scanType) {
+	// First scan takes the census of every object
+	if (scanType != ScanType::EXACT) {
+		addError("First scan for vtables only supports EXACT scan type");
+		return false;
+	}
+	return true;
+}
+
+void VtableScanner::firstScanImpl(ScanType scanType, const void* targetValue, size_t valueSize) {
+	Scanner::firstScanImpl(scanType, targetValue, valueSize);
+
+	rebuildGroups();
+}
+
+void VtableScanner::rescanImpl(ScanType scanType, const void* targetValue, size_t valueSize) {
+	Scanner::rescanImpl(scanType, targetValue, valueSize);
+	rebuildGroups();
+}
+
+void VtableScanner::rebuildGroups() {
+	groups.clear();
+	if (results.size() > UINT32_MAX) {
+		addError("Too many objects (%zu) for the census", results.size());
+		results.truncate(UINT32_MAX);
+	}
+
+	// Results are in address order so sorting their indices by vtable keeps
+	// each group in address order too
+	instanceOrder.resize(results.size());
+	for (size_t i = 0; i < results.size(); i++) {
+		instanceOrder[i] = (uint32_t)i;
+	}
+	std::sort(instanceOrder.begin(), instanceOrder.end(), [this](uint32_t a, uint32_t b) {
+		uintptr_t valueA = results.getValue(a).pointerValue;
+		uintptr_t valueB = results.getValue(b).pointerValue;
+		return valueA < valueB || (valueA == valueB && a < b);
+	});
+
+	for (size_t i = 0; i < instanceOrder.size(); i++) {
+		uintptr_t vtable = results.getValue(instanceOrder[i]).pointerValue;
+		if (groups.empty() || groups.back().vtable != vtable) {
+			VtableGroup group;
+			group.vtable = vtable;
+			group.first = (uint32_t)i;
+			group.count = 0;
+			groups.push_back(group);
+		}
+		groups.back().count++;
+	}
+}
+
+size_t VtableScanner::getInstanceCount(uintptr_t vtable) const {
+	auto it = std::lower_bound(groups.begin(), groups.end(), vtable,
+	                           [](const VtableGroup& group, uintptr_t v) { return group.vtable < v; });
+	if (it == groups.end() || it->vtable != vtable) {
+		return 0;
+	}
+	return it->count;
+}
+
+bool VtableScanner::getInstances(uintptr_t vtable, std::vector<uintptr_t, ScannerAllocator<uintptr_t>>& outAddresses) const {
+	outAddresses.clear();
+
+	auto it = std::lower_bound(groups.begin(), groups.end(), vtable,
+	                           [](const VtableGroup& group, uintptr_t v) { return group.vtable < v; });
+	if (it == groups.end() || it->vtable != vtable) {
+		return false;
+	}
+
+	outAddresses.reserve(it->count);
+	for (uint32_t i = it->first; i < it->first + it->count; i++) {
+		outAddresses.push_back(results.getAddress(instanceOrder[i]));
+	}
+	return true;
+}
+
+void VtableScanner::scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
+                                       ScanType scanType, const void* targetValue,
+                                       std::vector<ScanResult>& localResults, size_t maxLocalResults) {
+	// Only heap objects are counted. The image holds the vtables themselves
+	// and RTTI data that points back into read only data
+	if (chunkBase - imageBase < imageSize) {
+		return;
+	}
+
+	size_t misalignment = chunkBase % alignment;
+	size_t offset = misalignment == 0 ? 0 : alignment - misalignment;
+
+	while (offset + sizeof(uintptr_t) <= chunkSize && localResults.size() < maxLocalResults) {
+		uintptr_t value;
+		memcpy(&value, buffer + offset, sizeof(value));
+		if (isVtable(value)) {
+			ScanResult result;
+			result.address = chunkBase + offset;
+			result.value.pointerValue = value;
+			localResults.push_back(result);
+		}
+		offset += alignment;
+	}
+}
+
+bool VtableScanner::checkMatch(uintptr_t current, uintptr_t old, ScanType scanType) const {
+	switch (scanType) {
+		case ScanType::EXACT:
+			return isVtable(current);
+		case ScanType::NOT:
+			return !isVtable(current);
+		case ScanType::UNCHANGED:
+			return current == old;
+		case ScanType::CHANGED:
+			return current != old && isVtable(current);
+		case ScanType::INCREASED:
+		case ScanType::DECREASED:
+			addError("Only EXACT, NOT, CHANGED and UNCHANGED scans supported for VTABLE");
+			return false;
+		default:
+			addError("Invalid scan type in checkMatch: %d", (int)scanType);
+			return false;
+	}
+}
+
+bool VtableScanner::validateValueInBuffer(const uint8_t* buffer, size_t bufferSize, size_t offset,
+                                            uintptr_t actualAddress, ScanType scanType, const void* targetValue,
+                                            ScanResult& outResult) const {
+	outResult.address = actualAddress;
+	if (offset + sizeof(uintptr_t) > bufferSize) {
+		return false;
+	}
+
+	memcpy(&outResult.value.pointerValue, buffer + offset, sizeof(uintptr_t));
+	return checkMatch(outResult.value.pointerValue, outResult.oldValue.pointerValue, scanType);
+}
+
+bool VtableScanner::validateValueDirect(uintptr_t address, uintptr_t regionStart, uintptr_t regionEnd,
+                                          ScanType scanType, const void* targetValue,
+                                          ScanResult& outResult) const {
+	outResult.address = address;
+	if (address + sizeof(uintptr_t) > regionEnd) {
+		return false;
+	}
+
+	__try {
+		outResult.value.pointerValue = *(const uintptr_t*)address;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER) {
+		return false;
+	}
+	return checkMatch(outResult.value.pointerValue, outResult.oldValue.pointerValue, scanType);
+}
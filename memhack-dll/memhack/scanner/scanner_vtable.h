@@ -0,0 +1,109 @@
+#ifndef SCANNER_VTABLE_H
+#define SCANNER_VTABLE_H
+
+#include "scanner_base.h"
+#include <windows.h>
+
+// Scanner implementation for an object census by vtable
+// The first scan sweeps heap memory once for every aligned value that points
+// at a vtable in the exe image and keeps it as a result (address = object,
+// value = vtable). Results are then grouped by vtable so every live object of
+// a type is a binary search away instead of a targeted scan per struct
+//
+// A vtable is any aligned slot in a read only data section of the exe whose
+// value points into an executable section. These are found once per scan from
+// the section headers so the sweep itself never touches the image
+class VtableScanner : public Scanner {
+public:
+	// Objects of a single vtable. Indices are into getInstanceOrder()
+	struct VtableGroup {
+		uintptr_t vtable;
+		uint32_t first;
+		uint32_t count;
+	};
+
+	typedef std::vector<VtableGroup, ScannerAllocator<VtableGroup>> GroupList;
+
+	// Override new/delete to allocate from scanner heap
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr) noexcept;
+
+	VtableScanner(size_t maxResults, size_t alignment);
+	virtual ~VtableScanner();
+
+	static VtableScanner* create(size_t maxResults, size_t alignment);
+
+	// Take the census. Same as firstScan(EXACT, nullptr) but can be called
+	// again to retake it
+	void buildCensus();
+
+	// Groups sorted by vtable
+	const GroupList& getGroups() const { return groups; }
+
+	// Result indices ordered by (vtable, address). Groups index into this
+	const std::vector<uint32_t, ScannerAllocator<uint32_t>>& getInstanceOrder() const { return instanceOrder; }
+
+	// Object addresses of a vtable in address order. False if none were found
+	bool getInstances(uintptr_t vtable, std::vector<uintptr_t, ScannerAllocator<uintptr_t>>& outAddresses) const;
+	size_t getInstanceCount(uintptr_t vtable) const;
+
+	// Number of vtables found in the exe image during the last scan
+	size_t getVtableCount() const { return vtableCount; }
+
+	virtual void reset() override;
+
+protected:
+	// Setup hook - find the vtables in the exe image
+	virtual bool setupScanCommon(ScanType scanType, const void* targetValue, size_t valueSize) override;
+
+	// only allow EXACT (build) for first scan
+	virtual bool validateFirstScanType(ScanType scanType) override;
+	// Groups are built after the scan
+	virtual bool supportsStepScan() const override { return false; }
+
+	// Results are kept in address order for rescans and regrouped after each scan
+	virtual void firstScanImpl(ScanType scanType, const void* targetValue, size_t valueSize) override;
+	virtual void rescanImpl(ScanType scanType, const void* targetValue, size_t valueSize) override;
+
+	virtual void scanChunkInRegion(const uint8_t* buffer, size_t chunkSize, uintptr_t chunkBase,
+	                               ScanType scanType, const void* targetValue,
+	                               std::vector<ScanResult>& localResults, size_t maxLocalResults) override;
+
+	// Rescan pure virtuals - UNCHANGED keeps objects that still hold the same
+	// vtable (i.e. are still alive), EXACT keeps any that still hold a vtable
+	virtual bool validateValueDirect(uintptr_t address, uintptr_t regionStart, uintptr_t regionEnd,
+	                                  ScanType scanType, const void* targetValue,
+	                                  ScanResult& outResult) const override;
+	virtual bool validateValueInBuffer(const uint8_t* buffer, size_t bufferSize, size_t offset,
+	                                    uintptr_t actualAddress, ScanType scanType, const void* targetValue,
+	                                    ScanResult& outResult) const override;
+
+	// Getters
+	virtual size_t getDataTypeSize() const override { return sizeof(uintptr_t); }
+
+private:
+	// Read only data section with a bit per aligned slot that holds a vtable
+	struct VtableSection {
+		uintptr_t base;
+		size_t size;
+		size_t firstBit;
+	};
+
+	bool buildVtableFilter();
+	bool isVtable(uintptr_t value) const;
+	bool checkMatch(uintptr_t current, uintptr_t old, ScanType scanType) const;
+
+	void rebuildGroups();
+
+	uintptr_t imageBase;
+	size_t imageSize;
+	size_t vtableCount;
+
+	std::vector<VtableSection, ScannerAllocator<VtableSection>> vtableSections;
+	std::vector<uint32_t, ScannerAllocator<uint32_t>> vtableBits;
+
+	std::vector<uint32_t, ScannerAllocator<uint32_t>> instanceOrder;
+	GroupList groups;
+};
+
+#endif
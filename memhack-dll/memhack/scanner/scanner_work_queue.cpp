@@ -0,0 +1,85 @@
+#include "stdafx.h"
+#include "scanner_work_queue.h"
+
+void splitWorkUnits(const std::vector<MemoryRegion>& regions, size_t overlap,
+                    std::vector<WorkUnit, ScannerAllocator<WorkUnit>>& outUnits) {
+	outUnits.clear();
+	for (const MemoryRegion& region : regions) {
+		uintptr_t regionEnd = region.base + region.size;
+		for (uintptr_t start = region.base; start < regionEnd; start += WORK_UNIT_SIZE) {
+			WorkUnit unit;
+			unit.base = start;
+			unit.size = (size_t)std::min<uintptr_t>(WORK_UNIT_SIZE + overlap, regionEnd - start);
+			unit.leadingOverlap = start == region.base ? 0 : overlap;
+			outUnits.push_back(unit);
+		}
+	}
+}
+
+namespace {
+	uint64_t packBounds(uint32_t front, uint32_t back) {
+		return ((uint64_t)back << 32) | front;
+	}
+}
+
+WorkStealingQueue::WorkStealingQueue(size_t unitCount, int threadCount) :
+	ranges(threadCount < 1 ? 1 : threadCount), threadCount(threadCount < 1 ? 1 : threadCount)
+{
+	// Even contiguous ranges. Earlier threads take the remainder
+	size_t perThread = unitCount / this->threadCount;
+	size_t remainder = unitCount % this->threadCount;
+	uint32_t front = 0;
+	for (int i = 0; i < this->threadCount; i++) {
+		uint32_t back = front + (uint32_t)(perThread + ((size_t)i < remainder ? 1 : 0));
+		ranges[i].bounds.store(packBounds(front, back), std::memory_order_relaxed);
+		front = back;
+	}
+}
+
+bool WorkStealingQueue::takeFront(Range& range, uint32_t& outUnit) {
+	uint64_t bounds = range.bounds.load(std::memory_order_relaxed);
+	for (;;) {
+		uint32_t front = (uint32_t)bounds;
+		uint32_t back = (uint32_t)(bounds >> 32);
+		if (front >= back) {
+			return false;
+		}
+		if (range.bounds.compare_exchange_weak(bounds, packBounds(front + 1, back), std::memory_order_relaxed)) {
+			outUnit = front;
+			return true;
+		}
+	}
+}
+
+bool WorkStealingQueue::takeBack(Range& range, uint32_t& outUnit) {
+	uint64_t bounds = range.bounds.load(std::memory_order_relaxed);
+	for (;;) {
+		uint32_t front = (uint32_t)bounds;
+		uint32_t back = (uint32_t)(bounds >> 32);
+		if (front >= back) {
+			return false;
+		}
+		if (range.bounds.compare_exchange_weak(bounds, packBounds(front, back - 1), std::memory_order_relaxed)) {
+			outUnit = back - 1;
+			return true;
+		}
+	}
+}
+
+bool WorkStealingQueue::next(int thread, uint32_t& outUnit) {
+	if (thread >= 0 && thread < threadCount && takeFront(ranges[thread], outUnit)) {
+		return true;
+	}
+
+	// Steal from the others starting with the next thread so thieves spread out
+	for (int i = 1; i <= threadCount; i++) {
+		int victim = (thread + i) % threadCount;
+		if (victim < 0) {
+			victim += threadCount;
+		}
+		if (takeBack(ranges[victim], outUnit)) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,51 @@
+#ifndef SCANNER_WORK_QUEUE_H
+#define SCANNER_WORK_QUEUE_H
+
+#include "scanner_base.h"
+#include <atomic>
+
+// Size of a first scan work unit. Large regions are split into units of this
+// size so a single huge heap region is shared between threads
+const size_t WORK_UNIT_SIZE = 16 * SCAN_BUFFER_SIZE;
+
+// Piece of a region scanned by one thread. size includes the overlap into the
+// next unit so values that straddle the boundary are found exactly once
+// leadingOverlap is the part of the unit the previous unit also covers
+struct WorkUnit {
+	uintptr_t base;
+	size_t size;
+	size_t leadingOverlap;
+};
+
+// Split regions into work units in address order
+// overlap is the data size - 1 like the chunk overlap in scanRegion
+void splitWorkUnits(const std::vector<MemoryRegion>& regions, size_t overlap,
+                    std::vector<WorkUnit, ScannerAllocator<WorkUnit>>& outUnits);
+
+// Work stealing scheduler over unit indices
+// Each thread owns a contiguous range of units and takes from its front so it
+// walks memory in order. A thread that runs out steals single units from the
+// back of the other ranges. Front and back share one atomic word per range
+// so owners and thieves never take the same unit
+class WorkStealingQueue {
+public:
+	WorkStealingQueue(size_t unitCount, int threadCount);
+
+	// Next unit for the thread. False once every range is empty
+	bool next(int thread, uint32_t& outUnit);
+
+private:
+	// Padded to a cache line per range so owners don't contend
+	struct Range {
+		std::atomic<uint64_t> bounds;  // front in the low 32 bits, back in the high
+		uint8_t padding[64 - sizeof(std::atomic<uint64_t>)];
+	};
+
+	bool takeFront(Range& range, uint32_t& outUnit);
+	bool takeBack(Range& range, uint32_t& outUnit);
+
+	std::vector<Range, ScannerAllocator<Range>> ranges;
+	int threadCount;
+};
+
+#endif
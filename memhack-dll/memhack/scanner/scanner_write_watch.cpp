@@ -0,0 +1,75 @@
+#include "stdafx.h"
+#include "scanner_write_watch.h"
+
+#include <algorithm>
+
+void WriteWatchTracker::clear() {
+	std::vector<Range, ScannerAllocator<Range>>().swap(ranges);
+	std::vector<uintptr_t, ScannerAllocator<uintptr_t>>().swap(dirtyPages);
+	refreshFailed = false;
+}
+
+bool WriteWatchTracker::track(uintptr_t base, size_t size) {
+	if (size == 0) {
+		return false;
+	}
+
+	// Watch whole pages. ResetWriteWatch fails for memory allocated without
+	// MEM_WRITE_WATCH, so this doubles as the check
+	uintptr_t first = base & ~(uintptr_t)(pageSize - 1);
+	uintptr_t end = (base + size + pageSize - 1) & ~(uintptr_t)(pageSize - 1);
+	if (ResetWriteWatch((LPVOID)first, end - first) != 0) {
+		return false;
+	}
+
+	Range range;
+	range.base = first;
+	range.size = end - first;
+	ranges.insert(std::upper_bound(ranges.begin(), ranges.end(), range,
+	                               [](const Range& a, const Range& b) { return a.base < b.base; }), range);
+	return true;
+}
+
+void WriteWatchTracker::refresh() {
+	dirtyPages.clear();
+	refreshFailed = false;
+
+	std::vector<PVOID, ScannerAllocator<PVOID>> addresses;
+	for (const Range& range : ranges) {
+		addresses.resize(range.size / pageSize + 1);
+		ULONG_PTR count = addresses.size();
+		DWORD granularity = 0;
+		if (GetWriteWatch(WRITE_WATCH_FLAG_RESET, (PVOID)range.base, range.size, addresses.data(), &count, &granularity) != 0) {
+			// Freed or reallocated since it was tracked. Nothing can be
+			// called clean until the scanner starts over
+			refreshFailed = true;
+			return;
+		}
+		for (ULONG_PTR i = 0; i < count; i++) {
+			dirtyPages.push_back((uintptr_t)addresses[i]);
+		}
+	}
+
+	// Ranges are in address order so the pages already are too
+}
+
+bool WriteWatchTracker::isClean(uintptr_t base, size_t size) const {
+	if (refreshFailed || ranges.empty()) {
+		return false;
+	}
+
+	// Range that would contain base
+	auto it = std::upper_bound(ranges.begin(), ranges.end(), base,
+	                           [](uintptr_t address, const Range& range) { return address < range.base; });
+	if (it == ranges.begin()) {
+		return false;
+	}
+	--it;
+	if (base + size > it->base + it->size) {
+		return false;
+	}
+
+	uintptr_t firstPage = base & ~(uintptr_t)(pageSize - 1);
+	auto page = std::lower_bound(dirtyPages.begin(), dirtyPages.end(), firstPage);
+	return page == dirtyPages.end() || *page >= base + size;
+}
@@ -0,0 +1,51 @@
+#ifndef SCANNER_WRITE_WATCH_H
+#define SCANNER_WRITE_WATCH_H
+
+#include <vector>
+#include <cstdint>
+#include <Windows.h>
+#include "scanner_heap.h"
+
+// Pages written between scan generations, read from the write watch of
+// memory allocated with MEM_WRITE_WATCH. Memory that isn't watched is not
+// tracked and callers fall back to comparing contents
+//
+// Tracking resets the write watch, which the allocator that asked for it
+// may rely on (i.e. GC card tables), so it has to be enabled explicitly
+class WriteWatchTracker {
+public:
+	WriteWatchTracker() : pageSize(4096), refreshFailed(false) {}
+
+	void clear();
+	bool empty() const { return ranges.empty(); }
+
+	// Reset the write watch of [base, base + size) and track it from now on
+	// Returns false if the memory is not write watched
+	bool track(uintptr_t base, size_t size);
+
+	// Start a new generation. Collects the pages written in every tracked
+	// range since the last generation and resets their watch. Call before
+	// reading the memory so writes during the scan land in the next one
+	void refresh();
+
+	// True if [base, base + size) is tracked and no page of it was written
+	// before the last refresh. Safe to call from scan threads
+	bool isClean(uintptr_t base, size_t size) const;
+
+	size_t getTrackedRangeCount() const { return ranges.size(); }
+	size_t getDirtyPageCount() const { return dirtyPages.size(); }
+
+private:
+	struct Range {
+		uintptr_t base;
+		size_t size;
+	};
+
+	// Both sorted by address
+	std::vector<Range, ScannerAllocator<Range>> ranges;
+	std::vector<uintptr_t, ScannerAllocator<uintptr_t>> dirtyPages;
+	size_t pageSize;
+	bool refreshFailed;
+};
+
+#endif